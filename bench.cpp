@@ -0,0 +1,824 @@
+#define CPPECC_IMPLEMENTATION
+#define CPPECC_ENABLE_THREADS
+#include "cppecc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+using namespace cppecc;
+
+namespace
+{
+    struct Code
+    {
+        cppecc_s32 n_;
+        cppecc_s32 k_;
+    };
+
+    // Codes of standards and the range of redundancy, all are shortened from n=255
+    const Code Codes[] = {
+        {255, 223},
+        {255, 239},
+        {255, 247},
+        {204, 188},
+        {128, 120},
+        {255, 191},
+        {255, 127},
+    };
+
+    //! Codewords of an item of the batch encoders, a multiple of lanes of all kernels
+    const cppecc_s32 BatchCodewords = 32;
+
+    struct Measure
+    {
+        cppecc_s32 n_;
+        cppecc_s32 k_;
+        cppecc_s32 errors_;
+        std::string stage_;
+        double nsPerCodeword_;
+        double megaBytesPerSecond_;
+        double p50_;
+        double p99_;
+    };
+
+    struct Options
+    {
+        cppecc_s32 samples_;
+        cppecc_s32 batch_;
+        double tolerance_;
+        cppecc_u32 features_;
+        const char* json_;
+        const char* baseline_;
+        double overhead_; //!< nanoseconds of a pair of clock reads, calibrated in main
+    };
+
+    const char* simd_name()
+    {
+        cppecc_u32 features = rs_selected_kernels();
+        if(0 != (features & CPPECC_CPU_GFNI)) {
+            return (0 != (features & CPPECC_CPU_AVX512BW)) ? "gfni" : "gfni-avx2";
+        }
+        if(0 != (features & CPPECC_CPU_AVX2)) {
+            return "avx2";
+        }
+        if(0 != (features & CPPECC_CPU_SSSE3)) {
+            return "ssse3";
+        }
+        return "portable";
+    }
+
+    double nanoseconds(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    /**
+     @brief The least time of a pair of clock reads, which is subtracted from the time of a call.
+     */
+    double clock_overhead()
+    {
+        double overhead = 1.0e9;
+        for(cppecc_s32 i = 0; i < 4096; ++i) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            overhead = std::min(overhead, nanoseconds(start, end));
+        }
+        return overhead;
+    }
+
+    /**
+     @brief Time a stage on numItems inputs.
+     @param bytes ... message bytes of an item, for MB/s
+     @param codewords ... codewords of an item, times are divided by it
+     @param load ... load(slot, item) copies an input to a work slot of [0, options.batch_), before the clock starts
+     @param run ... run(slot) processes a slot, and returns a value which keeps the call from the optimizer
+
+     The mean is timed over batches of 'options.batch_' items, because a codeword takes less than a microsecond.
+     p50 and p99 are timed on single items with the clock overhead subtracted, averages of batches would hide the tail.
+     */
+    template<class Load, class Run>
+    Measure run_stage(const char* stage, cppecc_s32 n, cppecc_s32 k, cppecc_s32 errors, double bytes, cppecc_s32 codewords, cppecc_s32 numItems, Load load, Run run, const Options& options)
+    {
+        const cppecc_s32 batch = options.batch_;
+        const cppecc_s32 numSamples = options.samples_ * batch;
+        cppecc_s32 result = 0;
+
+        // The first batch warms up caches and is thrown away
+        double total = 0.0;
+        for(cppecc_s32 s = -1; s < options.samples_; ++s) {
+            cppecc_s32 first = ((s + 1) * batch) % numItems;
+            for(cppecc_s32 i = 0; i < batch; ++i) {
+                load(i, (first + i) % numItems);
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for(cppecc_s32 i = 0; i < batch; ++i) {
+                result += run(i);
+            }
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            if(0 <= s) {
+                total += nanoseconds(start, end);
+            }
+        }
+
+        std::vector<double> samples(numSamples);
+        for(cppecc_s32 s = 0; s < numSamples; ++s) {
+            load(0, s % numItems);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            result += run(0);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            samples[s] = std::max(0.0, nanoseconds(start, end) - options.overhead_) / codewords;
+        }
+        volatile cppecc_s32 sink = result;
+        (void)sink;
+
+        Measure measure;
+        measure.n_ = n;
+        measure.k_ = k;
+        measure.errors_ = errors;
+        measure.stage_ = stage;
+        double perItem = total / numSamples;
+        measure.nsPerCodeword_ = perItem / codewords;
+        measure.megaBytesPerSecond_ = 0.0 < perItem ? bytes * 1.0e3 / perItem : 0.0;
+        std::sort(samples.begin(), samples.end());
+        measure.p50_ = samples[samples.size() / 2];
+        measure.p99_ = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        return measure;
+    }
+
+    void report(std::vector<Measure>& measures, const Measure& m)
+    {
+        measures.push_back(m);
+        printf("(%5d, %5d) errors: %3d %-20s %10.1f ns %9.1f MB/s p50: %10.1f ns p99: %10.1f ns\n",
+               m.n_, m.k_, m.errors_, m.stage_.c_str(), m.nsPerCodeword_, m.megaBytesPerSecond_, m.p50_, m.p99_);
+    }
+
+    /**
+     @brief Options of heavy stages, of which an item takes more than microseconds.
+     */
+    Options scale_options(const Options& options, cppecc_s32 divisor)
+    {
+        Options result = options;
+        result.samples_ = std::max(1, options.samples_ / divisor);
+        result.batch_ = 1;
+        return result;
+    }
+
+    /**
+     @brief Make codewords with exactly 'errors' corrupted symbols at distinct positions.
+     @param [out] positions ... the corrupted positions of each codeword first, 'n' bytes for each
+     */
+    void make_codewords(RSContext* context, const Code& code, cppecc_s32 errors, cppecc_s32 numCodewords, std::mt19937& engine, std::vector<cppecc_u8>& codewords, std::vector<cppecc_u8>& positions)
+    {
+        const cppecc_s32 numSymbols = code.n_ - code.k_;
+        codewords.resize(static_cast<size_t>(numCodewords) * code.n_);
+        positions.resize(codewords.size());
+        for(cppecc_s32 i = 0; i < numCodewords; ++i) {
+            cppecc_u8* codeword = &codewords[static_cast<size_t>(i) * code.n_];
+            cppecc_u8* position = &positions[static_cast<size_t>(i) * code.n_];
+            for(cppecc_s32 j = 0; j < code.k_; ++j) {
+                codeword[j] = static_cast<cppecc_u8>(engine() & 0xFFU);
+            }
+            rs_encode(context, code.k_, codeword, numSymbols);
+            for(cppecc_s32 j = 0; j < code.n_; ++j) {
+                position[j] = static_cast<cppecc_u8>(j);
+            }
+            std::shuffle(position, position + code.n_, engine);
+            for(cppecc_s32 j = 0; j < errors; ++j) {
+                codeword[position[j]] ^= static_cast<cppecc_u8>(engine() | 1U);
+            }
+        }
+    }
+
+    /**
+     @brief RSCodec<N, K> on the same codewords as the runtime contexts.
+     */
+    template<cppecc_s32 N, cppecc_s32 K>
+    void run_codec(cppecc_s32 errors, const std::vector<cppecc_u8>& codewords, cppecc_s32 numCodewords, const Options& options, std::vector<Measure>& measures)
+    {
+        std::unique_ptr<RSCodec<N, K> > codec(new RSCodec<N, K>);
+        std::vector<cppecc_u8> work(static_cast<size_t>(options.batch_) * N);
+        auto load = [&](cppecc_s32 slot, cppecc_s32 item) {
+            memcpy(&work[static_cast<size_t>(slot) * N], &codewords[static_cast<size_t>(item) * N], N);
+        };
+        if(0 == errors) {
+            report(measures, run_stage("codec_encode", N, K, errors, K, 1, numCodewords, load, [&](cppecc_s32 slot) {
+                codec->encode(&work[static_cast<size_t>(slot) * N]);
+                return 0;
+            }, options));
+        }
+        report(measures, run_stage("codec_decode", N, K, errors, K, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            return codec->decode(&work[static_cast<size_t>(slot) * N]);
+        }, options));
+    }
+
+    void run_codecs(const Code& code, cppecc_s32 errors, const std::vector<cppecc_u8>& codewords, cppecc_s32 numCodewords, const Options& options, std::vector<Measure>& measures)
+    {
+        // Codecs are made at compile time, so each of Codes has an instance
+        if(255 == code.n_ && 223 == code.k_) {
+            run_codec<255, 223>(errors, codewords, numCodewords, options, measures);
+        } else if(255 == code.n_ && 239 == code.k_) {
+            run_codec<255, 239>(errors, codewords, numCodewords, options, measures);
+        } else if(255 == code.n_ && 247 == code.k_) {
+            run_codec<255, 247>(errors, codewords, numCodewords, options, measures);
+        } else if(204 == code.n_ && 188 == code.k_) {
+            run_codec<204, 188>(errors, codewords, numCodewords, options, measures);
+        } else if(128 == code.n_ && 120 == code.k_) {
+            run_codec<128, 120>(errors, codewords, numCodewords, options, measures);
+        } else if(255 == code.n_ && 191 == code.k_) {
+            run_codec<255, 191>(errors, codewords, numCodewords, options, measures);
+        } else if(255 == code.n_ && 127 == code.k_) {
+            run_codec<255, 127>(errors, codewords, numCodewords, options, measures);
+        }
+    }
+
+    /**
+     @brief Stages which don't depend on errors, the encoders and the registry of shared codes.
+     */
+    void run_encoders(RSContext* context, const Code& code, const std::vector<cppecc_u8>& codewords, cppecc_s32 numCodewords, const Options& options, std::vector<Measure>& measures)
+    {
+        static const cppecc_s32 Slices[] = {1, 4, 8};
+        const cppecc_s32 n = code.n_;
+        const cppecc_s32 k = code.k_;
+        const cppecc_s32 numSymbols = n - k;
+        std::vector<cppecc_u8> work(static_cast<size_t>(options.batch_) * n);
+        auto load = [&](cppecc_s32 slot, cppecc_s32 item) {
+            memcpy(&work[static_cast<size_t>(slot) * n], &codewords[static_cast<size_t>(item) * n], n);
+        };
+        auto slot_of = [&](cppecc_s32 slot) { return &work[static_cast<size_t>(slot) * n]; };
+
+        report(measures, run_stage("encode", n, k, 0, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            rs_encode(context, k, slot_of(slot), numSymbols);
+            return 0;
+        }, options));
+        report(measures, run_stage("encode_scalar", n, k, 0, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            rs_encode_scalar(context, k, slot_of(slot), numSymbols);
+            return 0;
+        }, options));
+        for(cppecc_s32 s = 0; s < 3 && Slices[s] <= context->numSlices_; ++s) {
+            char stage[32];
+            snprintf(stage, sizeof(stage), "encode_slicing%d", Slices[s]);
+            report(measures, run_stage(stage, n, k, 0, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+                rs_encode_slicing(context, k, slot_of(slot), numSymbols, Slices[s]);
+                return 0;
+            }, options));
+        }
+
+        // The message in three segments, the parity follows them
+        report(measures, run_stage("encode_segments", n, k, 0, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            cppecc_u8* codeword = slot_of(slot);
+            RSSegment segments[3] = {{codeword, static_cast<cppecc_size_t>(k / 3)}, {codeword + k / 3, static_cast<cppecc_size_t>(k / 3)}, {codeword + 2 * (k / 3), static_cast<cppecc_size_t>(k - 2 * (k / 3))}};
+            rs_encode_parity(context, segments, 3, codeword + k, numSymbols);
+            return 0;
+        }, options));
+
+        // Up to 4 symbols in the middle of the message are rewritten
+        const cppecc_s32 length = std::min(4, k);
+        const cppecc_s32 offset = (k - length) / 2;
+        const cppecc_u8 updated[4] = {0x12U, 0x34U, 0x56U, 0x78U};
+        report(measures, run_stage("update_parity", n, k, 0, length, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            cppecc_u8* codeword = slot_of(slot);
+            rs_update_parity(context, k, offset, codeword + offset, updated, length, codeword + k, numSymbols);
+            return 0;
+        }, options));
+
+        // An item of the batch encoders is BatchCodewords codewords
+        const cppecc_s32 numItems = std::max(1, numCodewords / BatchCodewords);
+        std::vector<cppecc_u8> batch(static_cast<size_t>(options.batch_) * BatchCodewords * n);
+        std::vector<cppecc_u8*> messages(static_cast<size_t>(options.batch_) * BatchCodewords);
+        for(size_t i = 0; i < messages.size(); ++i) {
+            messages[i] = &batch[i * n];
+        }
+        report(measures, run_stage("encode_batch", n, k, 0, static_cast<double>(k) * BatchCodewords, BatchCodewords, numItems, [&](cppecc_s32 slot, cppecc_s32 item) {
+            for(cppecc_s32 i = 0; i < BatchCodewords; ++i) {
+                memcpy(messages[slot * BatchCodewords + i], &codewords[static_cast<size_t>((item * BatchCodewords + i) % numCodewords) * n], n);
+            }
+        }, [&](cppecc_s32 slot) {
+            rs_encode_batch(context, BatchCodewords, k, &messages[slot * BatchCodewords], numSymbols);
+            return 0;
+        }, options));
+        report(measures, run_stage("encode_interleaved", n, k, 0, static_cast<double>(k) * BatchCodewords, BatchCodewords, numItems, [&](cppecc_s32 slot, cppecc_s32 item) {
+            const cppecc_u8* sources[BatchCodewords];
+            for(cppecc_s32 i = 0; i < BatchCodewords; ++i) {
+                sources[i] = &codewords[static_cast<size_t>((item * BatchCodewords + i) % numCodewords) * n];
+            }
+            rs_interleave(BatchCodewords, k, sources, &batch[static_cast<size_t>(slot) * BatchCodewords * n]);
+        }, [&](cppecc_s32 slot) {
+            rs_encode_interleaved(context, BatchCodewords, k, &batch[static_cast<size_t>(slot) * BatchCodewords * n], numSymbols);
+            return 0;
+        }, options));
+
+        // The first acquisition builds tables, the others find them in the registry
+        Options registry = scale_options(options, 8);
+        auto none = [](cppecc_s32, cppecc_s32) {};
+        report(measures, run_stage("code_build", n, k, 0, 0.0, 1, 1, none, [&](cppecc_s32) {
+            const RSCode* shared = rs_code_acquire(numSymbols, gf_default_field());
+            rs_code_release(shared);
+            return rs_code_purge();
+        }, registry));
+        const RSCode* held = rs_code_acquire(numSymbols, gf_default_field());
+        report(measures, run_stage("code_acquire", n, k, 0, 0.0, 1, 1, none, [&](cppecc_s32) {
+            const RSCode* shared = rs_code_acquire(numSymbols, gf_default_field());
+            rs_code_release(shared);
+            return 0;
+        }, options));
+        rs_code_release(held);
+        rs_code_purge();
+    }
+
+    /**
+     @brief Chien search and Forney's formula after Berlekamp-Massey, the reference functions and the fused one of the context.
+     */
+    void run_chien(RSContext* context, const Code& code, cppecc_s32 errors, const std::vector<cppecc_u8>& codewords, cppecc_s32 numCodewords, const Options& options, std::vector<Measure>& measures)
+    {
+        const cppecc_s32 n = code.n_;
+        const cppecc_s32 k = code.k_;
+        const cppecc_s32 numSymbols = n - k;
+        const RSField* field = context->field_;
+
+        // Locators and evaluators are made before the clock starts
+        std::vector<cppecc_u8> sigmas(static_cast<size_t>(numCodewords) * CPPECC_GF_NW);
+        std::vector<cppecc_u8> omegas(static_cast<size_t>(numCodewords) * CPPECC_GF_NW * 2);
+        std::vector<cppecc_s32> numSigmas(numCodewords);
+        std::vector<cppecc_s32> numOmegas(numCodewords);
+        cppecc_u8 syndromes[CPPECC_GF_NW];
+        for(cppecc_s32 i = 0; i < numCodewords; ++i) {
+            cppecc_u8* sigma = &sigmas[static_cast<size_t>(i) * CPPECC_GF_NW];
+            rs_syndromes(context, k, &codewords[static_cast<size_t>(i) * n], numSymbols, syndromes);
+            numSigmas[i] = rs_modified_berlekamp_massey(context, sigma, numSymbols, syndromes);
+            numOmegas[i] = gf_field_poly_mul_len(field, &omegas[static_cast<size_t>(i) * CPPECC_GF_NW * 2], numSymbols, syndromes, numSigmas[i], sigma, numSigmas[i] - 1);
+        }
+
+        std::vector<cppecc_u8> work(static_cast<size_t>(options.batch_) * n);
+        std::vector<cppecc_s32> items(options.batch_);
+        cppecc_u8 roots[CPPECC_GF_NW];
+        auto load = [&](cppecc_s32 slot, cppecc_s32 item) {
+            memcpy(&work[static_cast<size_t>(slot) * n], &codewords[static_cast<size_t>(item) * n], n);
+            items[slot] = item;
+        };
+        report(measures, run_stage("chien_reference", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            cppecc_s32 item = items[slot];
+            const cppecc_u8* sigma = &sigmas[static_cast<size_t>(item) * CPPECC_GF_NW];
+            cppecc_s32 numRoots = rs_field_chien_search(field, roots, static_cast<cppecc_u8>(n), static_cast<cppecc_u8>(numSigmas[item]), sigma);
+            if(0 <= numRoots) {
+                rs_field_error_correct_forney(field, &work[static_cast<size_t>(slot) * n], n, numRoots, roots, numSigmas[item], sigma, numOmegas[item], &omegas[static_cast<size_t>(item) * CPPECC_GF_NW * 2]);
+            }
+            return numRoots;
+        }, options));
+        report(measures, run_stage("chien_fused", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            cppecc_s32 item = items[slot];
+            return rs_chien_forney(context, &work[static_cast<size_t>(slot) * n], n, numSigmas[item], &sigmas[static_cast<size_t>(item) * CPPECC_GF_NW], numOmegas[item], &omegas[static_cast<size_t>(item) * CPPECC_GF_NW * 2]);
+        }, options));
+    }
+
+    /**
+     @brief Stages of decoders on codewords with 'errors' corrupted symbols.
+     */
+    void run_decoders(RSContext* context, const Code& code, cppecc_s32 errors, const std::vector<cppecc_u8>& codewords, const std::vector<cppecc_u8>& positions, cppecc_s32 numCodewords, const Options& options, std::vector<Measure>& measures)
+    {
+        const cppecc_s32 n = code.n_;
+        const cppecc_s32 k = code.k_;
+        const cppecc_s32 numSymbols = n - k;
+        std::vector<cppecc_u8> work(static_cast<size_t>(options.batch_) * n);
+        std::vector<cppecc_s32> items(options.batch_);
+        cppecc_u8 syndromes[CPPECC_GF_NW];
+        auto load = [&](cppecc_s32 slot, cppecc_s32 item) {
+            memcpy(&work[static_cast<size_t>(slot) * n], &codewords[static_cast<size_t>(item) * n], n);
+            items[slot] = item;
+        };
+        auto slot_of = [&](cppecc_s32 slot) { return &work[static_cast<size_t>(slot) * n]; };
+
+        report(measures, run_stage("check", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            return rs_check(context, k, slot_of(slot), numSymbols);
+        }, options));
+        report(measures, run_stage("syndromes", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            return rs_syndromes(context, k, slot_of(slot), numSymbols, syndromes);
+        }, options));
+        report(measures, run_stage("decode", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            return rs_decode(context, k, slot_of(slot), numSymbols);
+        }, options));
+        report(measures, run_stage("decode_constant", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            return rs_decode_constant(context, k, slot_of(slot), numSymbols);
+        }, options));
+        report(measures, run_stage("decode_segments", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+            cppecc_u8* codeword = slot_of(slot);
+            RSSegment segments[3] = {{codeword, static_cast<cppecc_size_t>(k / 3)}, {codeword + k / 3, static_cast<cppecc_size_t>(k / 3)}, {codeword + 2 * (k / 3), static_cast<cppecc_size_t>(k - 2 * (k / 3))}};
+            return rs_decode_parity(context, segments, 3, codeword + k, numSymbols);
+        }, options));
+        if(0 < errors && errors <= numSymbols) {
+            // All corrupted positions are known
+            report(measures, run_stage("decode_erasures", n, k, errors, k, 1, numCodewords, load, [&](cppecc_s32 slot) {
+                return rs_decode_erasures(context, k, slot_of(slot), numSymbols, &positions[static_cast<size_t>(items[slot]) * n], errors);
+            }, options));
+        }
+        if(0 < errors && errors <= numSymbols / 2) {
+            run_chien(context, code, errors, codewords, numCodewords, options, measures);
+        }
+        run_codecs(code, errors, codewords, numCodewords, options, measures);
+    }
+
+    /**
+     @brief Codewords of CCSDS in the dual basis and of DVB, which are shortened from the mother codes.
+     */
+    void run_profiles(const Options& options, std::vector<Measure>& measures)
+    {
+        static const cppecc_s32 NumCodewords = 256;
+        const RSProfile* profiles[2] = {rs_profile_ccsds(1), rs_profile_dvb()};
+        const char* names[2][2] = {{"ccsds_encode", "ccsds_decode"}, {"dvb_encode", "dvb_decode"}};
+        std::mt19937 engine(255);
+        for(cppecc_s32 p = 0; p < 2; ++p) {
+            const RSProfile* profile = profiles[p];
+            const cppecc_s32 n = profile->codewordSize_;
+            const cppecc_s32 k = profile->messageSize_;
+            const cppecc_s32 errors = profile->numSymbols_ / 4;
+            RSContext context;
+            rs_profile_initialize(&context, profile);
+            std::vector<cppecc_u8> codewords(static_cast<size_t>(NumCodewords) * n);
+            std::vector<cppecc_u8> received(codewords.size());
+            for(cppecc_s32 i = 0; i < NumCodewords; ++i) {
+                cppecc_u8* codeword = &codewords[static_cast<size_t>(i) * n];
+                for(cppecc_s32 j = 0; j < k; ++j) {
+                    codeword[j] = static_cast<cppecc_u8>(engine() & 0xFFU);
+                }
+                rs_profile_encode(&context, profile, codeword);
+                memcpy(&received[static_cast<size_t>(i) * n], codeword, n);
+                for(cppecc_s32 j = 0; j < errors; ++j) {
+                    received[static_cast<size_t>(i) * n + (i + j * 13) % n] ^= static_cast<cppecc_u8>(engine() | 1U);
+                }
+            }
+            std::vector<cppecc_u8> work(static_cast<size_t>(options.batch_) * n);
+            auto slot_of = [&](cppecc_s32 slot) { return &work[static_cast<size_t>(slot) * n]; };
+            report(measures, run_stage(names[p][0], n, k, 0, k, 1, NumCodewords, [&](cppecc_s32 slot, cppecc_s32 item) {
+                memcpy(slot_of(slot), &codewords[static_cast<size_t>(item) * n], n);
+            }, [&](cppecc_s32 slot) {
+                rs_profile_encode(&context, profile, slot_of(slot));
+                return 0;
+            }, options));
+            report(measures, run_stage(names[p][1], n, k, errors, k, 1, NumCodewords, [&](cppecc_s32 slot, cppecc_s32 item) {
+                memcpy(slot_of(slot), &received[static_cast<size_t>(item) * n], n);
+            }, [&](cppecc_s32 slot) {
+                return rs_profile_decode(&context, profile, slot_of(slot));
+            }, options));
+            gf_terminate(&context);
+        }
+    }
+
+    /**
+     @brief Codewords of GF(2^16), two bytes for each symbol. Compare MB/s with the 8 bit codes, which need more codewords for the same payload.
+     */
+    void run_gf16(const Options& options, std::vector<Measure>& measures)
+    {
+        static const Code Codes16[] = {
+            {2080, 2048},
+            {8256, 8192},
+            {65535, 65535 - CPPECC_MAX_ECC16_SIZE},
+        };
+        static const cppecc_s32 NumCodewords = 16;
+        std::unique_ptr<RS16Field> field(new RS16Field);
+        if(0 != gf16_field_build(field.get(), CPPECC_GF16_PRIMITIVE)) {
+            std::cout << "gf16 field error" << std::endl;
+            return;
+        }
+        std::mt19937 engine(65535);
+        for(size_t c = 0; c < sizeof(Codes16) / sizeof(Codes16[0]); ++c) {
+            const cppecc_s32 n = Codes16[c].n_;
+            const cppecc_s32 k = Codes16[c].k_;
+            const cppecc_s32 numSymbols = n - k;
+            const Options scaled = scale_options(options, (n < 16384) ? 8 : 32);
+            RS16Context context;
+            gf16_initialize(&context, numSymbols, field.get());
+            std::vector<cppecc_u16> codewords(static_cast<size_t>(NumCodewords) * n);
+            std::vector<cppecc_u16> received(codewords.size());
+            std::vector<cppecc_u16> work(n);
+            for(cppecc_s32 i = 0; i < NumCodewords; ++i) {
+                cppecc_u16* codeword = &codewords[static_cast<size_t>(i) * n];
+                for(cppecc_s32 j = 0; j < k; ++j) {
+                    codeword[j] = static_cast<cppecc_u16>(engine() & 0xFFFFU);
+                }
+                rs16_encode(&context, k, codeword, numSymbols);
+            }
+            report(measures, run_stage("gf16_encode", n, k, 0, 2.0 * k, 1, NumCodewords, [&](cppecc_s32, cppecc_s32 item) {
+                memcpy(&work[0], &codewords[static_cast<size_t>(item) * n], sizeof(cppecc_u16) * n);
+            }, [&](cppecc_s32) {
+                rs16_encode(&context, k, &work[0], numSymbols);
+                return 0;
+            }, scaled));
+
+            const cppecc_s32 t = numSymbols / 2;
+            const cppecc_s32 errors[] = {0, t / 2, t};
+            for(cppecc_s32 e = 0; e < 3; ++e) {
+                received = codewords;
+                for(cppecc_s32 i = 0; i < NumCodewords; ++i) {
+                    for(cppecc_s32 j = 0; j < errors[e]; ++j) {
+                        // Distinct positions, because the stride is prime to n
+                        received[static_cast<size_t>(i) * n + (i + j * 97) % n] ^= static_cast<cppecc_u16>(engine() | 1U);
+                    }
+                }
+                report(measures, run_stage("gf16_decode", n, k, errors[e], 2.0 * k, 1, NumCodewords, [&](cppecc_s32, cppecc_s32 item) {
+                    memcpy(&work[0], &received[static_cast<size_t>(item) * n], sizeof(cppecc_u16) * n);
+                }, [&](cppecc_s32) {
+                    return rs16_decode(&context, k, &work[0], numSymbols);
+                }, scaled));
+            }
+            gf16_terminate(&context);
+        }
+    }
+
+    /**
+     @brief A buffer of 223 + 32 codewords, by the serial functions and by RSEngine. One of every 64 blocks has t/2 errors.
+     */
+    void run_buffers(const Options& options, std::vector<Measure>& measures)
+    {
+        static const cppecc_s32 BlockSize = 223;
+        static const cppecc_s32 NumSymbols = 32;
+        static const cppecc_s32 Errors = NumSymbols / 4;
+        const Options scaled = scale_options(options, 16);
+        RSContext context;
+        gf_initialize(&context, NumSymbols);
+        std::unique_ptr<RSEngine> engine(new RSEngine(&context, 0, 256));
+        std::mt19937 random(BlockSize);
+
+        // The serial functions on 1 MiB, the engine on 16 MiB
+        const cppecc_size_t sizes[2] = {1024 * 1024, 16 * 1024 * 1024};
+        for(cppecc_s32 s = 0; s < 2; ++s) {
+            const cppecc_size_t size = sizes[s];
+            const cppecc_size_t numBlocks = rs_buffer_blocks(size, BlockSize);
+            const cppecc_s32 stride = BlockSize + NumSymbols;
+            std::vector<cppecc_u8> data(size);
+            for(cppecc_size_t i = 0; i < size; ++i) {
+                data[i] = static_cast<cppecc_u8>(random() & 0xFFU);
+            }
+            std::vector<cppecc_u8> encoded(rs_buffer_encoded_size(size, BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS));
+            rs_encode_buffer(&context, size, &data[0], &encoded[0], BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS);
+            std::vector<cppecc_u8> received(encoded);
+            for(cppecc_size_t i = 0; i < numBlocks; i += 64) {
+                for(cppecc_s32 j = 0; j < Errors; ++j) {
+                    received[i * stride + j * 7] ^= static_cast<cppecc_u8>(random() | 1U);
+                }
+            }
+            std::vector<cppecc_u8> work(received.size());
+            std::vector<cppecc_s32> status(numBlocks);
+            const cppecc_s32 codewords = static_cast<cppecc_s32>(numBlocks);
+            const double bytes = static_cast<double>(size);
+            auto none = [](cppecc_s32, cppecc_s32) {};
+            auto load = [&](cppecc_s32, cppecc_s32) { memcpy(&work[0], &received[0], received.size()); };
+            const char* names[2][3] = {{"encode_buffer", "check_buffer", "decode_buffer"}, {"engine_encode", "engine_check", "engine_decode"}};
+            report(measures, run_stage(names[s][0], stride, BlockSize, 0, bytes, codewords, 1, none, [&](cppecc_s32) {
+                if(0 == s) {
+                    rs_encode_buffer(&context, size, &data[0], &work[0], BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS);
+                } else {
+                    engine->encode(size, &data[0], &work[0], BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS);
+                }
+                return 0;
+            }, scaled));
+            report(measures, run_stage(names[s][1], stride, BlockSize, Errors, bytes, codewords, 1, none, [&](cppecc_s32) {
+                return (0 == s) ? rs_check_buffer(&context, size, &received[0], CPPECC_NULL, BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS, &status[0])
+                                : engine->check(size, &received[0], CPPECC_NULL, BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS, &status[0]);
+            }, scaled));
+            report(measures, run_stage(names[s][2], stride, BlockSize, Errors, bytes, codewords, 1, load, [&](cppecc_s32) {
+                return (0 == s) ? rs_decode_buffer(&context, size, &work[0], CPPECC_NULL, BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS, &status[0])
+                                : engine->decode(size, &work[0], CPPECC_NULL, BlockSize, NumSymbols, CPPECC_LAYOUT_CODEWORDS, &status[0]);
+            }, scaled));
+        }
+        engine.reset();
+        gf_terminate(&context);
+    }
+
+    /**
+     @brief gf_mul_add_region on a short row, a page and a large buffer, which is the inner loop of stripes.
+     */
+    void run_regions(const Options& options, std::vector<Measure>& measures)
+    {
+        static const cppecc_s32 Sizes[] = {200, 4096, 1024 * 1024};
+        const RSField* field = gf_default_field();
+        std::mt19937 engine(0x11DU);
+        for(cppecc_s32 s = 0; s < 3; ++s) {
+            const cppecc_s32 size = Sizes[s];
+            const Options scaled = (size < 65536) ? options : scale_options(options, 16);
+            std::vector<cppecc_u8> source(size);
+            std::vector<cppecc_u8> destination(size);
+            for(cppecc_s32 i = 0; i < size; ++i) {
+                source[i] = static_cast<cppecc_u8>(engine() & 0xFFU);
+            }
+            // The destination accumulates products, the result doesn't matter
+            report(measures, run_stage("mul_add_region", size, size, 0, size, 1, 1, [](cppecc_s32, cppecc_s32) {}, [&](cppecc_s32 slot) {
+                gf_mul_add_region(field, static_cast<cppecc_u8>(0x53U + slot), size, &source[0], &destination[0]);
+                return 0;
+            }, scaled));
+        }
+    }
+
+    /**
+     @brief Stripes of storage, encoding and rebuilding of as many lost chunks as parity chunks. MB/s are of data chunks.
+     */
+    void run_stripes(const Options& options, std::vector<Measure>& measures)
+    {
+        struct Stripe
+        {
+            cppecc_s32 numData_;
+            cppecc_s32 numParity_;
+            cppecc_size_t chunkSize_;
+        };
+        static const Stripe Stripes[] = {
+            {10, 4, 64 * 1024},
+            {6, 3, 1024 * 1024},
+            {12, 4, 4096},
+        };
+        for(size_t c = 0; c < sizeof(Stripes) / sizeof(Stripes[0]); ++c) {
+            const cppecc_s32 numData = Stripes[c].numData_;
+            const cppecc_s32 numParity = Stripes[c].numParity_;
+            const cppecc_s32 numChunks = numData + numParity;
+            const cppecc_size_t chunkSize = Stripes[c].chunkSize_;
+            const Options scaled = scale_options(options, (chunkSize < 65536) ? 1 : 16);
+            std::vector<cppecc_u8> buffer(chunkSize * numChunks);
+            std::vector<cppecc_u8*> pointers(numChunks);
+            for(cppecc_s32 i = 0; i < numChunks; ++i) {
+                pointers[i] = &buffer[chunkSize * i];
+            }
+            std::mt19937 engine(numData * CPPECC_GF_NW + numParity);
+            for(size_t i = 0; i < buffer.size(); ++i) {
+                buffer[i] = static_cast<cppecc_u8>(engine() & 0xFFU);
+            }
+            // Every other chunk is lost, the decode matrix is built before the clock starts
+            std::vector<cppecc_u8> lost(numParity);
+            for(cppecc_s32 i = 0; i < numParity; ++i) {
+                lost[i] = static_cast<cppecc_u8>(i * 2);
+            }
+            RSStripe* stripe = rs_stripe_alloc(numData, numParity, gf_default_field());
+            rs_stripe_rebuild(stripe, chunkSize, &pointers[0], &lost[0], numParity);
+
+            const double bytes = static_cast<double>(chunkSize) * numData;
+            auto none = [](cppecc_s32, cppecc_s32) {};
+            report(measures, run_stage("stripe_encode", numChunks, numData, 0, bytes, 1, 1, none, [&](cppecc_s32) {
+                rs_stripe_encode(stripe, chunkSize, &pointers[0], &pointers[numData]);
+                return 0;
+            }, scaled));
+            report(measures, run_stage("stripe_rebuild", numChunks, numData, numParity, bytes, 1, 1, none, [&](cppecc_s32) {
+                return rs_stripe_rebuild(stripe, chunkSize, &pointers[0], &lost[0], numParity);
+            }, scaled));
+            rs_stripe_free(stripe);
+        }
+    }
+
+    void write_json(std::ostream& os, const std::vector<Measure>& measures, const Options& options)
+    {
+        // One result in a line, read_baseline depends on it
+        os << "{\n";
+        os << "  \"simd\": \"" << simd_name() << "\",\n";
+        os << "  \"batch\": " << options.batch_ << ",\n";
+        os << "  \"samples\": " << options.samples_ << ",\n";
+        os << "  \"clock_overhead_ns\": " << options.overhead_ << ",\n";
+        os << "  \"results\": [\n";
+        for(size_t i = 0; i < measures.size(); ++i) {
+            const Measure& m = measures[i];
+            char line[256];
+            snprintf(line, sizeof(line),
+                     "    {\"n\": %d, \"k\": %d, \"errors\": %d, \"stage\": \"%s\", \"ns_per_codeword\": %.1f, \"mb_per_s\": %.1f, \"p50_ns\": %.1f, \"p99_ns\": %.1f}%s\n",
+                     m.n_, m.k_, m.errors_, m.stage_.c_str(), m.nsPerCodeword_, m.megaBytesPerSecond_, m.p50_, m.p99_, (i + 1) < measures.size() ? "," : "");
+            os << line;
+        }
+        os << "  ]\n";
+        os << "}\n";
+    }
+
+    bool read_baseline(const char* path, std::vector<Measure>& measures)
+    {
+        std::ifstream file(path);
+        if(!file) {
+            return false;
+        }
+        std::string line;
+        while(std::getline(file, line)) {
+            Measure m;
+            char stage[64];
+            if(8 == sscanf(line.c_str(), " {\"n\": %d, \"k\": %d, \"errors\": %d, \"stage\": \"%63[^\"]\", \"ns_per_codeword\": %lf, \"mb_per_s\": %lf, \"p50_ns\": %lf, \"p99_ns\": %lf",
+                           &m.n_, &m.k_, &m.errors_, stage, &m.nsPerCodeword_, &m.megaBytesPerSecond_, &m.p50_, &m.p99_)) {
+                m.stage_ = stage;
+                measures.push_back(m);
+            }
+        }
+        return true;
+    }
+
+    /**
+     @brief Compare p50s with the baseline, because the mean is sensitive to preemption.
+     @return The number of regressions slower than the tolerance
+     */
+    cppecc_s32 compare_baseline(const std::vector<Measure>& measures, const std::vector<Measure>& baseline, double tolerance)
+    {
+        cppecc_s32 regressions = 0;
+        for(size_t i = 0; i < measures.size(); ++i) {
+            const Measure& m = measures[i];
+            for(size_t j = 0; j < baseline.size(); ++j) {
+                const Measure& b = baseline[j];
+                if(m.n_ != b.n_ || m.k_ != b.k_ || m.errors_ != b.errors_ || m.stage_ != b.stage_ || b.p50_ <= 0.0) {
+                    continue;
+                }
+                double ratio = m.p50_ / b.p50_;
+                if((1.0 + tolerance) < ratio) {
+                    std::cout << "regression: (" << m.n_ << ", " << m.k_ << ") errors: " << m.errors_ << " " << m.stage_
+                              << " p50 (nano): " << b.p50_ << " -> " << m.p50_ << std::endl;
+                    ++regressions;
+                }
+                break;
+            }
+        }
+        return regressions;
+    }
+
+    void usage()
+    {
+        std::cout << "cppecc_bench [--samples N] [--batch N] [--features MASK] [--json FILE] [--baseline FILE] [--tolerance RATIO]" << std::endl;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options = {512, 16, 0.10, ~0U, CPPECC_NULL, CPPECC_NULL, 0.0};
+    for(int i = 1; i < argc; ++i) {
+        if(0 == strcmp(argv[i], "--samples") && (i + 1) < argc) {
+            options.samples_ = std::max(1, atoi(argv[++i]));
+        } else if(0 == strcmp(argv[i], "--batch") && (i + 1) < argc) {
+            options.batch_ = std::max(1, atoi(argv[++i]));
+        } else if(0 == strcmp(argv[i], "--json") && (i + 1) < argc) {
+            options.json_ = argv[++i];
+        } else if(0 == strcmp(argv[i], "--baseline") && (i + 1) < argc) {
+            options.baseline_ = argv[++i];
+        } else if(0 == strcmp(argv[i], "--tolerance") && (i + 1) < argc) {
+            options.tolerance_ = atof(argv[++i]);
+        } else if(0 == strcmp(argv[i], "--features") && (i + 1) < argc) {
+            options.features_ = static_cast<cppecc_u32>(strtoul(argv[++i], CPPECC_NULL, 0));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    // The mask of CPPECC_CPU_* limits the kernels, the first context doesn't bind them again
+    rs_select_kernels(options.features_);
+    options.overhead_ = clock_overhead();
+    printf("kernels: %s clock overhead: %.1f ns\n", simd_name(), options.overhead_);
+
+    static const cppecc_s32 NumCodewords = 256;
+    std::mt19937 engine(12345);
+    std::vector<cppecc_u8> codewords;
+    std::vector<cppecc_u8> positions;
+    std::vector<Measure> measures;
+    for(size_t c = 0; c < sizeof(Codes) / sizeof(Codes[0]); ++c) {
+        const Code& code = Codes[c];
+        const cppecc_s32 numSymbols = code.n_ - code.k_;
+        const cppecc_s32 t = numSymbols / 2;
+        RSContext* context = rs_context_alloc(numSymbols, gf_default_field());
+        if(CPPECC_NULL == context) {
+            std::cout << "context error: (" << code.n_ << ", " << code.k_ << ")" << std::endl;
+            return 1;
+        }
+        const cppecc_s32 errors[] = {0, t / 2, t, t + 1};
+        for(cppecc_s32 e = 0; e < 4; ++e) {
+            if(0 < e && errors[e] == errors[e - 1]) {
+                continue;
+            }
+            make_codewords(context, code, errors[e], NumCodewords, engine, codewords, positions);
+            // The encoders don't depend on errors
+            if(0 == errors[e]) {
+                run_encoders(context, code, codewords, NumCodewords, options, measures);
+            }
+            run_decoders(context, code, errors[e], codewords, positions, NumCodewords, options, measures);
+        }
+        rs_context_free(context);
+    }
+    run_profiles(options, measures);
+    run_gf16(options, measures);
+    run_buffers(options, measures);
+    run_regions(options, measures);
+    run_stripes(options, measures);
+
+    if(CPPECC_NULL != options.json_) {
+        std::ofstream file(options.json_);
+        if(!file) {
+            std::cout << "can't open: " << options.json_ << std::endl;
+            return 1;
+        }
+        write_json(file, measures, options);
+    }
+    if(CPPECC_NULL != options.baseline_) {
+        std::vector<Measure> baseline;
+        if(!read_baseline(options.baseline_, baseline)) {
+            std::cout << "can't open: " << options.baseline_ << std::endl;
+            return 1;
+        }
+        cppecc_s32 regressions = compare_baseline(measures, baseline, options.tolerance_);
+        std::cout << "regressions: " << regressions << " (tolerance " << options.tolerance_ << ")" << std::endl;
+        return 0 < regressions ? 2 : 0;
+    }
+    return 0;
+}
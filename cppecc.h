@@ -64,13 +64,27 @@ Put '#define CPPECC_IMPLEMENTATION' before including this file to create the imp
 */
 #include <assert.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #ifndef __cplusplus
 #    include <stdbool.h>
 #endif
 
+#if defined(CPPECC_ENABLE_THREADS) && defined(__cplusplus)
+#    include <atomic>
+#    include <chrono>
+#    include <condition_variable>
+#    include <deque>
+#    include <functional>
+#    include <memory>
+#    include <mutex>
+#    include <thread>
+#    include <vector>
+#endif
+
 #ifdef __cplusplus
 #    define CPPECC_NAMESPACE_BEGIN(name) \
         namespace name \
@@ -82,6 +96,7 @@ Put '#define CPPECC_IMPLEMENTATION' before including this file to create the imp
 #    define CPPECC_NAMESPACE_EMPTY_END }
 #    define CPPECC_STATIC
 #    define CPPECC_REINTERPRET_CAST(type) reinterpret_cast<type>
+#    define CPPECC_CONST_CAST(type) const_cast<type>
 #    define CPPECC_STATIC_CAST(type) static_cast<type>
 #else
 #    define CPPECC_NAMESPACE_BEGIN(name)
@@ -90,9 +105,85 @@ Put '#define CPPECC_IMPLEMENTATION' before including this file to create the imp
 #    define CPPECC_NAMESPACE_EMPTY_END
 #    define CPPECC_STATIC static
 #    define CPPECC_REINTERPRET_CAST(type) (type)
+#    define CPPECC_CONST_CAST(type) (type)
 #    define CPPECC_STATIC_CAST(type) (type)
 #endif
 
+#ifndef CPPECC_DISABLE_SIMD
+#    if defined(__AVX2__)
+#        define CPPECC_ENABLE_AVX2 (1)
+#    endif
+#    if defined(__SSSE3__) || defined(CPPECC_ENABLE_AVX2)
+#        define CPPECC_ENABLE_SSSE3 (1)
+#    endif
+#endif
+
+// Runtime dispatch compiles SSSE3 and AVX2 kernels regardless of the target, and binds the best ones for the CPU. See rs_select_kernels.
+#if !defined(CPPECC_DISABLE_SIMD) && !defined(CPPECC_DISABLE_DISPATCH) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#    define CPPECC_ENABLE_DISPATCH (1)
+#endif
+#if defined(CPPECC_ENABLE_DISPATCH) || defined(CPPECC_ENABLE_SSSE3)
+#    define CPPECC_KERNEL_SSSE3 (1)
+#endif
+#if defined(CPPECC_ENABLE_DISPATCH) || defined(CPPECC_ENABLE_AVX2)
+#    define CPPECC_KERNEL_AVX2 (1)
+#endif
+// GFNI kernels work on AVX-512 registers, or on AVX2 registers with the VEX encoded instructions, and need a compiler which knows them.
+// CPPECC_KERNEL_GFNI tells that either of them is compiled, and contexts have the tables of them.
+#if defined(CPPECC_ENABLE_DISPATCH) && (defined(__x86_64__) || defined(_M_X64)) && (defined(__clang__) || 8 <= __GNUC__ || 1920 <= _MSC_VER)
+#    define CPPECC_KERNEL_GFNI_AVX512 (1)
+#    define CPPECC_KERNEL_GFNI_AVX2 (1)
+#elif !defined(CPPECC_DISABLE_SIMD) && defined(__x86_64__) && defined(__GFNI__) && defined(__AVX2__)
+#    if defined(__AVX512BW__)
+#        define CPPECC_KERNEL_GFNI_AVX512 (1)
+#    endif
+#    define CPPECC_KERNEL_GFNI_AVX2 (1)
+#endif
+#if defined(CPPECC_KERNEL_GFNI_AVX512) || defined(CPPECC_KERNEL_GFNI_AVX2)
+#    define CPPECC_KERNEL_GFNI (1)
+#endif
+#if defined(CPPECC_ENABLE_DISPATCH) && (!defined(_MSC_VER) || defined(__clang__))
+#    define CPPECC_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    define CPPECC_TARGET_AVX2 __attribute__((target("avx2")))
+#    define CPPECC_TARGET_GFNI __attribute__((target("avx512bw,gfni")))
+#    define CPPECC_TARGET_GFNI_AVX2 __attribute__((target("avx2,gfni")))
+#else
+#    define CPPECC_TARGET_SSSE3
+#    define CPPECC_TARGET_AVX2
+#    define CPPECC_TARGET_GFNI
+#    define CPPECC_TARGET_GFNI_AVX2
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+#    include <immintrin.h>
+#elif defined(CPPECC_ENABLE_SSSE3)
+#    include <tmmintrin.h>
+#endif
+#if defined(CPPECC_ENABLE_DISPATCH)
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#    endif
+#endif
+
+#if defined(CPPECC_ENABLE_STATS) && !defined(CPPECC_STATS_CYCLES)
+#    if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#        include <intrin.h>
+#        define CPPECC_STATS_CYCLES() __rdtsc()
+#    elif defined(__x86_64__) || defined(__i386__)
+#        include <x86intrin.h>
+#        define CPPECC_STATS_CYCLES() __rdtsc()
+#    else
+#        include <time.h>
+#        define CPPECC_STATS_CYCLES() ((cppecc_u64)clock())
+#    endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
 CPPECC_NAMESPACE_BEGIN(cppecc)
 
 #ifndef CPPECC_NULL
@@ -129,6 +220,27 @@ typedef size_t cppecc_size_t;
 #    define CPPECC_ASSERT(exp) assert(exp)
 #endif
 
+#ifndef CPPECC_MALLOC
+#    define CPPECC_MALLOC(size) malloc(size)
+#    define CPPECC_FREE(ptr) free(ptr)
+#endif
+
+#ifndef CPPECC_MAX_SLICES
+#    define CPPECC_MAX_SLICES (8) //!< message bytes consumed in a step by the table driven encoder, 1, 4 or 8
+#endif
+
+#ifndef CPPECC_STRIPE_CACHE_SIZE
+#    define CPPECC_STRIPE_CACHE_SIZE (8) //!< decode matrices which a stripe keeps for recent loss patterns
+#endif
+
+#ifndef CPPECC_FORCEINLINE
+#    if defined(_MSC_VER)
+#        define CPPECC_FORCEINLINE __forceinline
+#    else
+#        define CPPECC_FORCEINLINE inline __attribute__((always_inline))
+#    endif
+#endif
+
 #ifdef __cplusplus
 static const cppecc_u32 CPPECC_GF_W = 8;
 static const cppecc_u32 CPPECC_GF_NW = (1 << CPPECC_GF_W);
@@ -139,9 +251,27 @@ static const cppecc_u32 CPPECC_GF_NW1 = CPPECC_GF_NW - 1;
 static const cppecc_s32 CPPECC_MAX_BODY_SIZE = CPPECC_GF_NW1;
 static const cppecc_s32 CPPECC_MAX_ECC_SIZE = 52;
 static const cppecc_s32 CPPECC_MAX_ECC_RATE = 10;
+static const cppecc_s32 CPPECC_ECC_STRIDE = 64; //CPPECC_MAX_ECC_SIZE rounded up to a multiple of vector registers
+static const cppecc_s32 CPPECC_MAX_SCAN_SIZE = 32; //syndromes of vectorized scans, rs_check encodes again for more redundant symbols
+
+static const cppecc_u32 CPPECC_GF16_W = 16;
+static const cppecc_u32 CPPECC_GF16_NW = (1 << CPPECC_GF16_W);
+static const cppecc_u32 CPPECC_GF16_NW1 = CPPECC_GF16_NW - 1;
+static const cppecc_u32 CPPECC_GF16_PRIMITIVE = 0x1100BU;
+static const cppecc_s32 CPPECC_MAX_BODY16_SIZE = CPPECC_GF16_NW1;
+static const cppecc_s32 CPPECC_MAX_ECC16_SIZE = 64; //a multiple of 8, the number of 16 bit symbols in a vector register
 
 static const cppecc_s32 CPPECC_ERROR = -1;
 
+static const cppecc_s32 CPPECC_LAYOUT_CODEWORDS = 0; //!< each block is followed by its redundant symbols
+static const cppecc_s32 CPPECC_LAYOUT_SEPARATE = 1; //!< redundant symbols of all blocks are stored apart from the data
+
+static const cppecc_u32 CPPECC_CPU_SSE2 = 0x01U;
+static const cppecc_u32 CPPECC_CPU_SSSE3 = 0x02U;
+static const cppecc_u32 CPPECC_CPU_AVX2 = 0x04U;
+static const cppecc_u32 CPPECC_CPU_AVX512BW = 0x08U;
+static const cppecc_u32 CPPECC_CPU_GFNI = 0x10U;
+
 #    define CPPECC_STRUCT
 
 #else
@@ -153,405 +283,6370 @@ static const cppecc_s32 CPPECC_ERROR = -1;
 #    define CPPECC_MAX_BODY_SIZE (CPPECC_GF_NW1)
 #    define CPPECC_MAX_ECC_SIZE (52)
 #    define CPPECC_MAX_ECC_RATE (10)
+#    define CPPECC_ECC_STRIDE (64)
+#    define CPPECC_MAX_SCAN_SIZE (32)
+
+#    define CPPECC_GF16_W (16)
+#    define CPPECC_GF16_NW (1 << CPPECC_GF16_W)
+#    define CPPECC_GF16_NW1 (CPPECC_GF16_NW - 1)
+#    define CPPECC_GF16_PRIMITIVE (0x1100BU)
+#    define CPPECC_MAX_BODY16_SIZE (CPPECC_GF16_NW1)
+#    define CPPECC_MAX_ECC16_SIZE (64)
 
 #    define CPPECC_ERROR (-1)
 
+#    define CPPECC_LAYOUT_CODEWORDS (0)
+#    define CPPECC_LAYOUT_SEPARATE (1)
+
+#    define CPPECC_CPU_SSE2 (0x01U)
+#    define CPPECC_CPU_SSSE3 (0x02U)
+#    define CPPECC_CPU_AVX2 (0x04U)
+#    define CPPECC_CPU_AVX512BW (0x08U)
+#    define CPPECC_CPU_GFNI (0x10U)
+
 #    define CPPECC_STRUCT struct
 #endif
 
-struct RSContext
-{
-    cppecc_u8 generator_[CPPECC_MAX_ECC_SIZE + 1];
-    cppecc_u8 syndromes_[CPPECC_MAX_ECC_SIZE + 1];
-    cppecc_u8 sigma_[CPPECC_MAX_ECC_SIZE];
-    cppecc_u8 errorPositions_[CPPECC_MAX_ECC_SIZE];
-    cppecc_u8 omega_[CPPECC_MAX_ECC_SIZE + CPPECC_MAX_ECC_SIZE];
+/**
+ @brief Parameters of a field and the roots of codes on it.
 
-    cppecc_u8 temp0_[CPPECC_GF_NW];
+ exp_ and log_ are taken to the base beta = alpha^prim_, where alpha is a root of polynomial_.
+ Multiplications with them are the same as the ones to the base alpha, and codes have roots beta^(fcr_ + i).
+ */
+struct RSField
+{
+    cppecc_u8 log_[CPPECC_GF_NW];
+    cppecc_u8 exp_[CPPECC_GF_NW];
+    cppecc_u32 polynomial_; //!< primitive polynomial of the field, 0x11D
+    cppecc_s32 fcr_; //!< the first consecutive root of generation polynomials
+    cppecc_s32 prim_; //!< spacing of roots of generation polynomials, that should be coprime with 255
 };
 
+#if defined(CPPECC_ENABLE_STATS)
+#    ifdef __cplusplus
+static const cppecc_s32 CPPECC_STAGE_SYNDROMES = 0; //!< rs_syndromes
+static const cppecc_s32 CPPECC_STAGE_LOCATOR = 1; //!< Berlekamp-Massey
+static const cppecc_s32 CPPECC_STAGE_CHIEN = 2; //!< roots of the error locator
+static const cppecc_s32 CPPECC_STAGE_FORNEY = 3; //!< values of errors and corrections
+static const cppecc_s32 CPPECC_STAGE_MAX = 4;
+#    else
+#        define CPPECC_STAGE_SYNDROMES (0)
+#        define CPPECC_STAGE_LOCATOR (1)
+#        define CPPECC_STAGE_CHIEN (2)
+#        define CPPECC_STAGE_FORNEY (3)
+#        define CPPECC_STAGE_MAX (4)
+#    endif
+
 /**
- @brief Initialize the generation polynomial from numSymbols.
- @param [in,out] context
- @param [in] numSymbols
+ @brief Called for each corrected symbol, position is the index in the message and magnitude is the value xored to it.
  */
-void gf_initialize(CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols);
-
-cppecc_u8 gf_add(cppecc_u8 a, cppecc_u8 b);
-
-cppecc_u8 gf_mul(cppecc_u8 a, cppecc_u8 b);
+typedef void (*cppecc_error_callback)(void* user, cppecc_s32 position, cppecc_u8 magnitude);
 
-cppecc_u8 gf_div(cppecc_u8 a, cppecc_u8 b);
+/**
+ @brief Counters of decoders, which are enabled with CPPECC_ENABLE_STATS.
 
-cppecc_u8 gf_pow(cppecc_u8 x, cppecc_s32 p);
+ Cycles are CPPECC_STATS_CYCLES(), that is rdtsc on x86 and clock() on others.
+ */
+struct RSStats
+{
+    cppecc_u64 cycles_[CPPECC_STAGE_MAX]; //!< total cycles of each stage
+    cppecc_u64 calls_[CPPECC_STAGE_MAX]; //!< how many times each stage ran, stages after syndromes run only for dirty codewords
+    cppecc_u64 words_; //!< decoded codewords
+    cppecc_u64 uncorrectable_; //!< codewords which decoders returned CPPECC_ERROR
+    cppecc_u64 corrected_[CPPECC_GF_NW / 2 + 1]; //!< histogram of corrected symbols, corrected_[0] is clean codewords
+};
+#endif
 
-cppecc_u8 gf_inverse(cppecc_u8 x);
+/**
+ @brief Buffers of decoders. RSContext is read only while encoding and decoding with rs_decode_scratch, so threads can share it with their own scratches.
 
-void gf_poly_scale(cppecc_s32 size, cppecc_u8 result[], const cppecc_u8 p[], cppecc_u8 x);
+ These are long enough for any number of redundant symbols, decoders touch only the first 'numSymbols' of each.
+ */
+struct RSScratch
+{
+    cppecc_u8 syndromes_[CPPECC_GF_NW];
+    cppecc_u8 sigma_[CPPECC_GF_NW];
+    cppecc_u8 errorPositions_[CPPECC_GF_NW];
+    cppecc_u8 omega_[CPPECC_GF_NW + CPPECC_GF_NW];
 
-cppecc_s32 gf_poly_add(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[]);
+    cppecc_u8 temp0_[CPPECC_GF_NW];
+#if defined(CPPECC_ENABLE_STATS)
+    CPPECC_STRUCT RSStats stats_;
+    cppecc_error_callback callback_; //!< null, or called for each corrected symbol
+    void* user_;
+#endif
+};
 
-cppecc_s32 gf_poly_mul(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[]);
-cppecc_s32 gf_poly_mul_len(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[], cppecc_s32 l);
+/**
+ @brief Generation polynomial and tables of encoders for a number of redundant symbols.
 
-cppecc_u8 gf_poly_eval(cppecc_s32 size, const cppecc_u8 poly[], cppecc_u8 x);
+ The context is a header of pointers to tables, which are in a block as large as numSymbols_ and the bound kernels need.
+ gf_initialize allocates the block and gf_terminate frees it, rs_context_create and rs_context_alloc put the header and the block in one arena.
+ The table of positions for rs_update_parity and rs_encode_chunk is allocated at the first call of them, gf_terminate and rs_context_free free it.
+ Contexts are not copyable in C++, copies would refer to the tables of the original.
+ */
+struct RSContext
+{
+    const CPPECC_STRUCT RSField* field_;
+    cppecc_s32 numSymbols_; //!< redundant symbols which the tables are made for
+    cppecc_s32 numSlices_; //!< number of slices_ tables, one for short codes and when the vector kernels encode
+    cppecc_s32 numNibbles_; //!< number of nibbles_ tables, fewer for long codes to bound tables
+    cppecc_s32 stride_; //!< numSymbols_ rounded up to a multiple of vector registers
+    cppecc_u8* generator_; //!< numSymbols_ + 1 coefficients from the highest degree
+    cppecc_u8* slices_; //!< slices_[(e*256 + b)*numSymbols_ + k] is the coefficient k of b*x^(numSymbols_+e) mod generator
+    cppecc_u8* nibbles_; //!< rows of x^(numSymbols_+e) mod generator for low and high nibbles, [numNibbles_][low,high][nibble][stride_]
+    cppecc_u8* shuffles_; //!< shuffle tables for each coefficient of the generator, [stride_][low,high][nibble]
+    cppecc_u8* powers_; //!< shuffle tables for alpha^(i*2^f), [min(numSymbols_, CPPECC_MAX_SCAN_SIZE)][f][low,high][nibble]
+    cppecc_u8* chien_; //!< shuffle tables for beta^(-j*2^f), [numSymbols_/2][f][low,high][nibble]
+    cppecc_u8* deltas_; //!< deltas_[e*numSymbols_ + k] is the coefficient k of x^(numSymbols_+e) mod generator, [CPPECC_GF_NW1 - numSymbols_][numSymbols_], null until the delta API builds it
+#if defined(CPPECC_KERNEL_GFNI)
+    // The tables of GFNI are null if the kernels bound at construction don't use GFNI
+    cppecc_u64* isomorphism_; //!< bit matrices of GF2P8AFFINEQB from this field to the field of AES and back, [2]
+    cppecc_u64* roots_; //!< bit matrices for r^8, r, r^2 and r^4 of roots r = beta^(fcr+i), [numSymbols_/8 rounded up][4][8]
+    cppecc_u8* rows_; //!< x^(numSymbols_+e) mod generator in the field of AES, [16][numSymbols_ rounded up to 64]
+#endif
+    CPPECC_STRUCT RSScratch* scratch_; //!< buffers of the functions which take a non-const context
+    void* allocation_; //!< block of the tables which gf_initialize allocated, null in arenas
+#ifdef __cplusplus
+#    if 201103L <= __cplusplus || 1700 <= _MSC_VER
+    RSContext() = default;
+    RSContext(const RSContext&) = delete;
+    RSContext& operator=(const RSContext&) = delete;
+#    else
+    RSContext() {}
 
-cppecc_s32 gf_poly_div(cppecc_u8 result[], cppecc_s32 sizeDividend, const cppecc_u8 dividend[], cppecc_s32 sizeDivisor, const cppecc_u8 divisor[]);
+private:
+    RSContext(const RSContext&);
+    RSContext& operator=(const RSContext&);
+#    endif
+#endif
+};
 
-void rs_generator_poly(cppecc_s32 size, cppecc_u8 result[], cppecc_u8 tmp[]);
+/**
+ @brief A standard code, that is the field, the size of codewords and the representation of symbols on links.
 
-cppecc_s32 rs_modified_berlekamp_massey(CPPECC_STRUCT RSContext* context, cppecc_u8 result[], cppecc_s32 numSyndromes, const cppecc_u8 syndromes[]);
-cppecc_s32 rs_chien_search_two(cppecc_u8 result[2], cppecc_u8 start, cppecc_u8 end, cppecc_u8 a, cppecc_u8 b);
-cppecc_s32 rs_chien_search(cppecc_u8 result[], cppecc_u8 size, cppecc_u8 numSigma, const cppecc_u8 sigma[]);
-void rs_error_correct_forney(cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u8 pos[], cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[]);
+ Shortened codes put 'CPPECC_MAX_BODY_SIZE - codewordSize_' zeros before the message virtually, they don't change redundant symbols.
+ */
+struct RSProfile
+{
+    const CPPECC_STRUCT RSField* field_;
+    cppecc_s32 codewordSize_; //!< n, symbols of a codeword including redundant symbols
+    cppecc_s32 messageSize_; //!< k, message symbols of a codeword
+    cppecc_s32 numSymbols_; //!< n - k, redundant symbols
+    const cppecc_u8* toDual_; //!< shuffle table from the conventional basis to the dual basis, [low,high][nibble], null if links use the conventional basis
+    const cppecc_u8* fromDual_; //!< shuffle table from the dual basis to the conventional basis
+};
 
 /**
- @brief Add redundant data to the original message for error correction.
- @param [in, out] context ... Used for the generation polynomial and buffers.
- @param [in] size ... message size
- @param [in, out] message[] ... The size should be 'size + numSymbols'. Output will be made from the original message and added redundant symbols (that size is numSymbols).
- @param numSymbols ... size of redundant symbols, that is equivalent to capability of error corrections * 2.
+ @brief A part of a message in caller memory. This has the same layout as struct iovec of POSIX, so arrays of iovec can be cast to this.
  */
-void rs_encode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
+struct RSSegment
+{
+    void* base_;
+    cppecc_size_t length_;
+};
 
 /**
- @brief Try to recover the original message from redundant symbols. But, when the number of errors exceeds the capability of Reed-Solomon codes, the message never be recoverted correctly.
- @param [in, out] context ... Used for buffers
- @param [in] size ... message size
- @param [in, out] message[] ... The size should be 'size + numSymbols'. Output's corrupted symbols will be corrected.
- @param numSymbols ... size of redundant symbols, that is equivalent to capability of error corrections.
- @return The number of corrected symbols. When the number of erros exceeds the capability (so, it's numSymbols/2), the original message might not be recovered.
+ @brief State of an encoder which takes a message in pieces. The remainder of the LFSR is kept between pieces.
  */
-cppecc_s32 rs_decode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
-
-CPPECC_NAMESPACE_END(cppecc)
-#endif // INC_CPPECC_H_
-
-#ifdef CPPECC_IMPLEMENTATION
-CPPECC_NAMESPACE_BEGIN(cppecc)
-
-CPPECC_NAMESPACE_EMPTY_BEGIN
-
-// clang-format off
-static const cppecc_u8 gflog[CPPECC_GF_NW]={
-    0x0U,0x0U,0x1U,0x19U,0x2U,0x32U,0x1AU,0xC6U,0x3U,0xDFU,0x33U,0xEEU,0x1BU,0x68U,0xC7U,0x4BU,
-    0x4U,0x64U,0xE0U,0xEU,0x34U,0x8DU,0xEFU,0x81U,0x1CU,0xC1U,0x69U,0xF8U,0xC8U,0x8U,0x4CU,0x71U,
-    0x5U,0x8AU,0x65U,0x2FU,0xE1U,0x24U,0xFU,0x21U,0x35U,0x93U,0x8EU,0xDAU,0xF0U,0x12U,0x82U,0x45U,
-    0x1DU,0xB5U,0xC2U,0x7DU,0x6AU,0x27U,0xF9U,0xB9U,0xC9U,0x9AU,0x9U,0x78U,0x4DU,0xE4U,0x72U,0xA6U,
-    0x6U,0xBFU,0x8BU,0x62U,0x66U,0xDDU,0x30U,0xFDU,0xE2U,0x98U,0x25U,0xB3U,0x10U,0x91U,0x22U,0x88U,
-    0x36U,0xD0U,0x94U,0xCEU,0x8FU,0x96U,0xDBU,0xBDU,0xF1U,0xD2U,0x13U,0x5CU,0x83U,0x38U,0x46U,0x40U,
-    0x1EU,0x42U,0xB6U,0xA3U,0xC3U,0x48U,0x7EU,0x6EU,0x6BU,0x3AU,0x28U,0x54U,0xFAU,0x85U,0xBAU,0x3DU,
-    0xCAU,0x5EU,0x9BU,0x9FU,0xAU,0x15U,0x79U,0x2BU,0x4EU,0xD4U,0xE5U,0xACU,0x73U,0xF3U,0xA7U,0x57U,
-    0x7U,0x70U,0xC0U,0xF7U,0x8CU,0x80U,0x63U,0xDU,0x67U,0x4AU,0xDEU,0xEDU,0x31U,0xC5U,0xFEU,0x18U,
-    0xE3U,0xA5U,0x99U,0x77U,0x26U,0xB8U,0xB4U,0x7CU,0x11U,0x44U,0x92U,0xD9U,0x23U,0x20U,0x89U,0x2EU,
-    0x37U,0x3FU,0xD1U,0x5BU,0x95U,0xBCU,0xCFU,0xCDU,0x90U,0x87U,0x97U,0xB2U,0xDCU,0xFCU,0xBEU,0x61U,
-    0xF2U,0x56U,0xD3U,0xABU,0x14U,0x2AU,0x5DU,0x9EU,0x84U,0x3CU,0x39U,0x53U,0x47U,0x6DU,0x41U,0xA2U,
-    0x1FU,0x2DU,0x43U,0xD8U,0xB7U,0x7BU,0xA4U,0x76U,0xC4U,0x17U,0x49U,0xECU,0x7FU,0xCU,0x6FU,0xF6U,
-    0x6CU,0xA1U,0x3BU,0x52U,0x29U,0x9DU,0x55U,0xAAU,0xFBU,0x60U,0x86U,0xB1U,0xBBU,0xCCU,0x3EU,0x5AU,
-    0xCBU,0x59U,0x5FU,0xB0U,0x9CU,0xA9U,0xA0U,0x51U,0xBU,0xF5U,0x16U,0xEBU,0x7AU,0x75U,0x2CU,0xD7U,
-    0x4FU,0xAEU,0xD5U,0xE9U,0xE6U,0xE7U,0xADU,0xE8U,0x74U,0xD6U,0xF4U,0xEAU,0xA8U,0x50U,0x58U,0xAFU,
+struct RSEncoder
+{
+    const CPPECC_STRUCT RSContext* context_;
+    cppecc_s32 numSymbols_;
+    cppecc_s32 size_; //!< message bytes consumed so far
+    cppecc_u8 remainder_[CPPECC_GF_NW];
 };
-// clang-format on
 
-// clang-format off
-static const cppecc_u8 gfexp[CPPECC_GF_NW]={
-    0x1U,0x2U,0x4U,0x8U,0x10U,0x20U,0x40U,0x80U,0x1DU,0x3AU,0x74U,0xE8U,0xCDU,0x87U,0x13U,0x26U,
-    0x4CU,0x98U,0x2DU,0x5AU,0xB4U,0x75U,0xEAU,0xC9U,0x8FU,0x3U,0x6U,0xCU,0x18U,0x30U,0x60U,0xC0U,
-    0x9DU,0x27U,0x4EU,0x9CU,0x25U,0x4AU,0x94U,0x35U,0x6AU,0xD4U,0xB5U,0x77U,0xEEU,0xC1U,0x9FU,0x23U,
-    0x46U,0x8CU,0x5U,0xAU,0x14U,0x28U,0x50U,0xA0U,0x5DU,0xBAU,0x69U,0xD2U,0xB9U,0x6FU,0xDEU,0xA1U,
-    0x5FU,0xBEU,0x61U,0xC2U,0x99U,0x2FU,0x5EU,0xBCU,0x65U,0xCAU,0x89U,0xFU,0x1EU,0x3CU,0x78U,0xF0U,
-    0xFDU,0xE7U,0xD3U,0xBBU,0x6BU,0xD6U,0xB1U,0x7FU,0xFEU,0xE1U,0xDFU,0xA3U,0x5BU,0xB6U,0x71U,0xE2U,
-    0xD9U,0xAFU,0x43U,0x86U,0x11U,0x22U,0x44U,0x88U,0xDU,0x1AU,0x34U,0x68U,0xD0U,0xBDU,0x67U,0xCEU,
-    0x81U,0x1FU,0x3EU,0x7CU,0xF8U,0xEDU,0xC7U,0x93U,0x3BU,0x76U,0xECU,0xC5U,0x97U,0x33U,0x66U,0xCCU,
-    0x85U,0x17U,0x2EU,0x5CU,0xB8U,0x6DU,0xDAU,0xA9U,0x4FU,0x9EU,0x21U,0x42U,0x84U,0x15U,0x2AU,0x54U,
-    0xA8U,0x4DU,0x9AU,0x29U,0x52U,0xA4U,0x55U,0xAAU,0x49U,0x92U,0x39U,0x72U,0xE4U,0xD5U,0xB7U,0x73U,
-    0xE6U,0xD1U,0xBFU,0x63U,0xC6U,0x91U,0x3FU,0x7EU,0xFCU,0xE5U,0xD7U,0xB3U,0x7BU,0xF6U,0xF1U,0xFFU,
-    0xE3U,0xDBU,0xABU,0x4BU,0x96U,0x31U,0x62U,0xC4U,0x95U,0x37U,0x6EU,0xDCU,0xA5U,0x57U,0xAEU,0x41U,
-    0x82U,0x19U,0x32U,0x64U,0xC8U,0x8DU,0x7U,0xEU,0x1CU,0x38U,0x70U,0xE0U,0xDDU,0xA7U,0x53U,0xA6U,
-    0x51U,0xA2U,0x59U,0xB2U,0x79U,0xF2U,0xF9U,0xEFU,0xC3U,0x9BU,0x2BU,0x56U,0xACU,0x45U,0x8AU,0x9U,
-    0x12U,0x24U,0x48U,0x90U,0x3DU,0x7AU,0xF4U,0xF5U,0xF7U,0xF3U,0xFBU,0xEBU,0xCBU,0x8BU,0xBU,0x16U,
-    0x2CU,0x58U,0xB0U,0x7DU,0xFAU,0xE9U,0xCFU,0x83U,0x1BU,0x36U,0x6CU,0xD8U,0xADU,0x47U,0x8EU,0xCCU,
+/**
+ @brief State of a decoder which takes a codeword in pieces. The message part goes through the encoder's LFSR as it comes, and the redundant symbols are kept.
+
+ The remainder holds all syndromes, they are its values at the roots. So a clean codeword is confirmed by comparing the remainder with the redundant symbols.
+ */
+struct RSDecoder
+{
+    const CPPECC_STRUCT RSContext* context_;
+    cppecc_s32 size_; //!< message size of the codeword
+    cppecc_s32 numSymbols_;
+    cppecc_s32 received_; //!< bytes of the codeword consumed so far
+    cppecc_u8 remainder_[CPPECC_GF_NW]; //!< remainder of the message so far
+    cppecc_u8 parity_[CPPECC_GF_NW]; //!< received redundant symbols
+    CPPECC_STRUCT RSScratch scratch_; //!< buffers of the locator and the Chien search, and stats since rs_decoder_init
 };
-// clang-format on
 
-CPPECC_NAMESPACE_EMPTY_END
+/**
+ @brief A context shared by threads, rs_code_acquire makes one for each field and number of redundant symbols, and returns the same one after that.
 
-//
-void gf_initialize(CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols)
+ The context is read only, threads encode and decode with it through their own RSWorkspace.
+ */
+struct RSCode
 {
-    rs_generator_poly(numSymbols, context->generator_, context->temp0_);
-}
+    const CPPECC_STRUCT RSContext* context_; //!< read only for all threads
+    void* arena_; //!< the block of context_ which rs_context_alloc made, rs_code_purge frees it
+    const CPPECC_STRUCT RSField* field_;
+    cppecc_s32 numSymbols_;
+    cppecc_s32 references_; //!< acquisitions which are not released, changed under the lock of the registry
+    CPPECC_STRUCT RSCode* next_;
+};
 
-cppecc_u8 gf_add(cppecc_u8 a, cppecc_u8 b)
+/**
+ @brief Buffers of a thread for a code. This is a scratch and a pointer, so make one for each thread and each code.
+ */
+struct RSWorkspace
 {
-    return a ^ b;
-}
+    const CPPECC_STRUCT RSCode* code_;
+    CPPECC_STRUCT RSScratch scratch_;
+};
 
-//
-cppecc_u8 gf_mul(cppecc_u8 a, cppecc_u8 b)
+/**
+ @brief A decode matrix of a loss pattern, the rows make lost chunks from survivors.
+ */
+struct RSStripeDecoder
 {
-    if(0 == a || 0 == b) {
-        return 0;
-    }
-    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_s32)(gflog[a]) + gflog[b];
-    if(CPPECC_GF_NW1 <= sum) {
-        sum -= CPPECC_GF_NW1;
-    }
-    return gfexp[sum];
-}
+    cppecc_u64 lost_[CPPECC_GF_NW / 64]; //!< set of lost chunks, the key of the cache
+    cppecc_u64 stamp_; //!< when this was used last, 0 for empty entries
+    cppecc_s32 numLost_;
+    cppecc_u8 survivors_[CPPECC_GF_NW]; //!< the first numData chunks which are not lost
+    cppecc_u8* rows_; //!< [numLost_][numData] for lost chunks in ascending order
+};
 
-cppecc_u8 gf_mulexp(cppecc_u8 a, cppecc_u8 b)
-{
-    if(0 == a) {
-        return 0;
-    }
-    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_s32)(gflog[a]) + b;
-    if(CPPECC_GF_NW1 <= sum) {
-        sum -= CPPECC_GF_NW1;
-    }
-    return gfexp[sum];
-}
+/**
+ @brief Erasure code of a stripe, numData data chunks and numParity parity chunks of the same size. Any numParity lost chunks are rebuilt from the others.
 
-//
-cppecc_u8 gf_div(cppecc_u8 a, cppecc_u8 b)
+ Parity chunks are the products of a Cauchy matrix and data chunks, so any numData chunks determine the others.
+ rs_stripe_create and rs_stripe_alloc make this with the matrices of the exact size.
+ */
+struct RSStripe
 {
-    if(0 == a) {
-        return 0;
-    }
-    if(0 == b) {
-        return CPPECC_STATIC_CAST(cppecc_u8)(-1);
-    }
-    cppecc_s32 diff = CPPECC_STATIC_CAST(cppecc_s32)(gflog[a]) - gflog[b];
-    if(diff < 0) {
-        diff += CPPECC_GF_NW1;
-    }
-    return gfexp[diff];
-}
+    const CPPECC_STRUCT RSField* field_;
+    cppecc_s32 numData_;
+    cppecc_s32 numParity_;
+    cppecc_u64 clock_; //!< stamps of decoders_
+    cppecc_u8* matrix_; //!< matrix_[i*numData_ + j] = 1/(x_i + y_j), x_i = numData_ + i and y_j = j, [numParity_][numData_]
+    cppecc_u8* work_; //!< the survivors' rows and their inverse for Gauss-Jordan elimination, [numData_][numData_ * 2]
+    CPPECC_STRUCT RSStripeDecoder decoders_[CPPECC_STRIPE_CACHE_SIZE];
+};
 
-cppecc_u8 gf_divexp(cppecc_u8 a, cppecc_u8 b)
-{
-    if(0 == a) {
-        return 0;
-    }
-    cppecc_s32 diff = CPPECC_STATIC_CAST(cppecc_s32)(gflog[a]) - b;
-    if(diff < 0) {
-        diff += CPPECC_GF_NW1;
-    }
-    return gfexp[diff];
-}
+/**
+ @brief Tables of GF(2^16), alpha is a root of polynomial_. This is 256 KiB, so don't put it on stacks.
 
-cppecc_u8 gf_pow(cppecc_u8 x, cppecc_s32 p)
+ Only Berlekamp-Massey and Forney's formula look up these. The encoder, syndromes and the Chien search use split tables in RS16Context, which are sized by the number of redundant symbols.
+ */
+struct RS16Field
 {
-    return gfexp[(gflog[x] * p) % CPPECC_GF_NW1];
-}
+    cppecc_u16 log_[CPPECC_GF16_NW];
+    cppecc_u16 exp_[CPPECC_GF16_NW];
+    cppecc_u32 polynomial_; //!< primitive polynomial of the field, 0x1100B
+};
 
-cppecc_u8 gf_inverse(cppecc_u8 x)
-{
-    return gfexp[CPPECC_GF_NW1 - gflog[x]];
-}
+/**
+ @brief Context of codes on GF(2^16), that have the roots alpha^0, alpha^1, ...
 
-void gf_poly_scale(cppecc_s32 size, cppecc_u8 result[], const cppecc_u8 p[], cppecc_u8 x)
+ The first consecutive root is always alpha^0. Codes of other first roots are not supported, their generators and syndromes differ.
+ The split tables are in a block which gf16_initialize allocates for numSymbols_, about 3 KiB for each redundant symbol.
+ The encoder streams rows_, that is 16 KiB for 8 symbols and fits in L1 caches, and 128 KiB for CPPECC_MAX_ECC16_SIZE in L2 caches.
+ */
+struct RS16Context
 {
-    for(cppecc_s32 i = 0; i < size; ++i) {
-        result[i] = gf_mul(p[i], x);
-    }
-}
+    const CPPECC_STRUCT RS16Field* field_;
+    cppecc_s32 numSymbols_; //!< redundant symbols which the tables are made for
+    cppecc_s32 stride_; //!< numSymbols_ rounded up to 8, the symbols of a vector register
+    cppecc_u16* rows_; //!< rows_[((e*2 + h)*256 + b)*stride_ + k] is the coefficient k of (b<<(8*h))*x^(numSymbols_+e) mod generator, padded with zeros, [2][2][256][stride_]
+    cppecc_u16* roots_; //!< roots_[(i*2 + h)*256 + b] = alpha^i*(b<<(8*h)), [numSymbols_][2][256]
+    cppecc_u8* chien_; //!< chien_[((m-1)*8 + h*4 + n)*16 + v] is byte h of alpha^(16*m)*(v<<(4*n)), [numSymbols_/2][2][4][16]
+    void* allocation_; //!< block of rows_, roots_ and chien_, which gf16_terminate frees
+    cppecc_u16 generator_[CPPECC_MAX_ECC16_SIZE + 1];
+    cppecc_u16 syndromes_[CPPECC_MAX_ECC16_SIZE];
+    cppecc_u16 sigma_[CPPECC_MAX_ECC16_SIZE + 1];
+    cppecc_u16 errorPositions_[CPPECC_MAX_ECC16_SIZE];
+    cppecc_u16 omega_[CPPECC_MAX_ECC16_SIZE + CPPECC_MAX_ECC16_SIZE];
 
-cppecc_s32 gf_poly_add(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[])
-{
-    cppecc_s32 size = (psize < qsize) ? qsize : psize;
-    cppecc_s32 d = (psize < qsize) ? qsize - psize : 0;
-    for(cppecc_s32 i = 0; i < d; ++i) {
-        result[i] = 0;
-    }
+    cppecc_u16 temp0_[CPPECC_MAX_ECC16_SIZE + 2];
+#ifdef __cplusplus
+#    if 201103L <= __cplusplus || 1700 <= _MSC_VER
+    RS16Context() = default;
+    RS16Context(const RS16Context&) = delete;
+    RS16Context& operator=(const RS16Context&) = delete;
+#    else
+    RS16Context() {}
 
-    for(cppecc_s32 i = 0; i < psize; ++i) {
-        result[i + size - psize] = p[i];
-    }
+private:
+    RS16Context(const RS16Context&);
+    RS16Context& operator=(const RS16Context&);
+#    endif
+#endif
+};
 
-    for(cppecc_s32 i = 0; i < qsize; ++i) {
-        result[i + size - qsize] ^= q[i];
-    }
-    return size;
-}
+/**
+ @brief Instruction set extensions of this CPU, a set of CPPECC_CPU_*. AVX2 and AVX-512BW are reported only if the OS saves their registers.
+ */
+cppecc_u32 rs_cpu_features(void);
 
-cppecc_s32 gf_poly_mul(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[])
-{
-    cppecc_s32 total = psize + qsize - 1;
-    for(cppecc_s32 i = 0; i < total; ++i) {
-        result[i] = 0;
-    }
-    for(cppecc_s32 i = 0; i < qsize; ++i) {
-        for(cppecc_s32 j = 0; j < psize; ++j) {
-            result[i + j] ^= gf_mul(p[j], q[i]);
-        }
-    }
-    return total;
-}
+/**
+ @brief Bind the kernels of encoders, rs_check's syndrome scan and the Chien search to the best ones within 'features & rs_cpu_features()'.
+ @param features ... a set of CPPECC_CPU_*, 0 binds the portable code, and ~0U binds the best kernels for this CPU.
+ @return the features of the bound kernels
 
-cppecc_s32 gf_poly_mul_len(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[], cppecc_s32 l)
-{
-    cppecc_s32 total = l;
-    for(cppecc_s32 i = 0; i < total; ++i) {
-        result[i] = 0;
-    }
-    psize = (psize < l) ? psize : l;
-    for(cppecc_s32 i = 0; i < psize; ++i) {
-        if(0 == p[i]) {
-            continue;
-        }
-        cppecc_u8 logp = gflog[p[i]];
-        cppecc_s32 qs = l - i;
-        qs = qsize < qs ? qsize : qs;
-        for(cppecc_s32 j = 0; j < qs; ++j) {
-            if(0 == q[j]) {
-                continue;
-            }
-            result[i + j] ^= gf_mulexp(q[j], logp);
-        }
-    }
-    return total;
-}
+ The first gf_initialize or rs_context_create binds the best kernels, call this to test other kernels.
+ This changes kernels for all contexts. It swaps a pointer to constant tables, so threads which encode or decode meanwhile run either of the kernels, which give the same results.
+ */
+cppecc_u32 rs_select_kernels(cppecc_u32 features);
 
-cppecc_u8 gf_poly_eval(cppecc_s32 size, const cppecc_u8 poly[], cppecc_u8 x)
+/**
+ @brief Features of the bound kernels.
+ */
+cppecc_u32 rs_selected_kernels(void);
+
+/**
+ @brief Initialize the generation polynomial from numSymbols, and allocate tables for it with CPPECC_MALLOC.
+ @param [in,out] context ... Release it with gf_terminate before initializing it again.
+ @param [in] numSymbols ... This should be less than CPPECC_MAX_BODY_SIZE. Functions on the context take the same numSymbols, the tables are valid only for it.
+ @return 0, or CPPECC_ERROR if allocation failed
+ */
+cppecc_s32 gf_initialize(CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols);
+
+/**
+ @brief Same as gf_initialize, but for codes on another field or with other roots.
+ @param [in] field ... The context refers to this, it should live longer than the context.
+ */
+cppecc_s32 gf_initialize_field(CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field);
+
+/**
+ @brief Free the tables of gf_initialize, and the table of positions which the delta API built. Contexts of rs_context_create need this only after the delta API.
+ */
+void gf_terminate(CPPECC_STRUCT RSContext* context);
+
+/**
+ @brief Size of a context which rs_context_create makes for numSymbols with the bound kernels.
+ @param [in] numSymbols ... This should be less than CPPECC_MAX_BODY_SIZE.
+ */
+cppecc_size_t rs_context_size(cppecc_s32 numSymbols);
+
+/**
+ @brief Make a context in a buffer of the caller, the tables are as large as numSymbols needs.
+ @param [out] arena ... The context is put at the front, that should be aligned to pointers and live longer than the context.
+ @param [in] arenaSize ... This should be rs_context_size(numSymbols) at least.
+ @param [in] numSymbols ... same as gf_initialize
+ @param [in] field ... gf_default_field() is the same as gf_initialize.
+ @return The context, or null if arenaSize is too small.
+ */
+CPPECC_STRUCT RSContext* rs_context_create(void* arena, cppecc_size_t arenaSize, cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field);
+
+/**
+ @brief Same as rs_context_create, but allocates rs_context_size(numSymbols) bytes with CPPECC_MALLOC.
+ @return The context, or null if allocation failed. Release it with rs_context_free.
+ */
+CPPECC_STRUCT RSContext* rs_context_alloc(cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field);
+
+void rs_context_free(CPPECC_STRUCT RSContext* context);
+
+/**
+ @brief Get the shared code of numSymbols redundant symbols on the field, it's made at the first call and kept in a registry.
+ @param [in] numSymbols ... n - k, shortened codes of the same n - k share a code. This should be less than CPPECC_MAX_BODY_SIZE.
+ @param [in] field ... Fields are compared by addresses, it should live longer than the code.
+ @return The code, or null if allocation failed. Threads can call this at the same time.
+ */
+const CPPECC_STRUCT RSCode* rs_code_acquire(cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field);
+
+/**
+ @brief Release an acquisition of rs_code_acquire. The code stays in the registry until rs_code_purge.
+ */
+void rs_code_release(const CPPECC_STRUCT RSCode* code);
+
+/**
+ @brief Free codes which are not acquired.
+ @return the number of freed codes
+ */
+cppecc_s32 rs_code_purge(void);
+
+/**
+ @brief Bind a workspace to a code, and clear the counters of the scratch.
+ */
+void rs_workspace_init(CPPECC_STRUCT RSWorkspace* workspace, const CPPECC_STRUCT RSCode* code);
+
+/**
+ @brief Same as rs_encode with the code's context and numSymbols.
+ */
+void rs_workspace_encode(const CPPECC_STRUCT RSWorkspace* workspace, cppecc_s32 size, cppecc_u8 message[]);
+
+/**
+ @brief Same as rs_decode_scratch with the code's context, numSymbols and the workspace's scratch.
+ */
+cppecc_s32 rs_workspace_decode(CPPECC_STRUCT RSWorkspace* workspace, cppecc_s32 size, cppecc_u8 message[]);
+
+/**
+ @brief Size of a stripe which rs_stripe_create makes.
+ @param [in] numData ... This should be positive.
+ @param [in] numParity ... 'numData + numParity' should be CPPECC_GF_NW or less.
+ */
+cppecc_size_t rs_stripe_size(cppecc_s32 numData, cppecc_s32 numParity);
+
+/**
+ @brief Make a stripe code in a buffer of the caller.
+ @param [out] arena ... The stripe is put at the front, that should be aligned to pointers and live longer than the stripe.
+ @param [in] arenaSize ... This should be rs_stripe_size(numData, numParity) at least.
+ @param [in] field ... The stripe refers to this, gf_default_field() is the field of gf_initialize.
+ @return The stripe, or null if arenaSize is too small.
+ */
+CPPECC_STRUCT RSStripe* rs_stripe_create(void* arena, cppecc_size_t arenaSize, cppecc_s32 numData, cppecc_s32 numParity, const CPPECC_STRUCT RSField* field);
+
+/**
+ @brief Same as rs_stripe_create, but allocates rs_stripe_size(numData, numParity) bytes with CPPECC_MALLOC.
+ @return The stripe, or null if allocation failed. Release it with rs_stripe_free.
+ */
+CPPECC_STRUCT RSStripe* rs_stripe_alloc(cppecc_s32 numData, cppecc_s32 numParity, const CPPECC_STRUCT RSField* field);
+
+void rs_stripe_free(CPPECC_STRUCT RSStripe* stripe);
+
+/**
+ @brief Encode parity chunks of a stripe with gf_mul_add_region. The stripe is read only, threads can share it.
+ @param [in] chunkSize ... bytes of each chunk
+ @param [in] data ... numData chunks
+ @param [out] parity ... numParity chunks
+ */
+void rs_stripe_encode(const CPPECC_STRUCT RSStripe* stripe, cppecc_size_t chunkSize, const cppecc_u8* const data[], cppecc_u8* const parity[]);
+
+/**
+ @brief Rebuild lost chunks of a stripe from the others.
+ @param [in,out] chunks ... numData data chunks followed by numParity parity chunks, lost ones are overwritten
+ @param [in] lost ... indices of lost chunks in chunks, in any order without duplicates
+ @param [in] numLost
+ @return 0, or CPPECC_ERROR if more than numParity chunks are lost.
+
+ Decode matrices are cached in the stripe for CPPECC_STRIPE_CACHE_SIZE loss patterns, so this changes the stripe. Don't call while other threads use it.
+ */
+cppecc_s32 rs_stripe_rebuild(CPPECC_STRUCT RSStripe* stripe, cppecc_size_t chunkSize, cppecc_u8* const chunks[], const cppecc_u8 lost[], cppecc_s32 numLost);
+
+/**
+ @brief The field of 0x11D with the roots alpha^0, alpha^1, ..., which gf_initialize uses.
+ */
+const CPPECC_STRUCT RSField* gf_default_field(void);
+
+/**
+ @brief Build tables of a field at runtime. In C++11, RSFieldParams makes the same tables at compile time.
+ @param [out] field
+ @param [in] polynomial ... primitive polynomial of degree 8
+ @param [in] fcr ... the first consecutive root
+ @param [in] prim ... spacing of roots
+ @return 0, or CPPECC_ERROR if polynomial is not primitive or prim is not coprime with 255.
+ */
+cppecc_s32 gf_field_build(CPPECC_STRUCT RSField* field, cppecc_u32 polynomial, cppecc_s32 fcr, cppecc_s32 prim);
+
+cppecc_u8 gf_field_mul(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b);
+
+cppecc_u8 gf_field_div(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b);
+
+cppecc_u8 gf_field_pow(const CPPECC_STRUCT RSField* field, cppecc_u8 x, cppecc_s32 p);
+
+cppecc_u8 gf_field_inverse(const CPPECC_STRUCT RSField* field, cppecc_u8 x);
+
+cppecc_u8 gf_add(cppecc_u8 a, cppecc_u8 b);
+
+cppecc_u8 gf_mul(cppecc_u8 a, cppecc_u8 b);
+
+cppecc_u8 gf_div(cppecc_u8 a, cppecc_u8 b);
+
+cppecc_u8 gf_pow(cppecc_u8 x, cppecc_s32 p);
+
+cppecc_u8 gf_inverse(cppecc_u8 x);
+
+/**
+ @brief destination[i] += coefficient * source[i] for all i < size, with the bound kernel.
+
+ This is the building block of erasure codes over many blocks. GFNI kernels multiply 64 bytes in an instruction for any field.
+ */
+void gf_mul_add_region(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[]);
+
+// Functions with a field work on any field, and the ones without it are the same on gf_default_field()
+void gf_field_poly_scale(const CPPECC_STRUCT RSField* field, cppecc_s32 size, cppecc_u8 result[], const cppecc_u8 p[], cppecc_u8 x);
+void gf_poly_scale(cppecc_s32 size, cppecc_u8 result[], const cppecc_u8 p[], cppecc_u8 x);
+
+cppecc_s32 gf_poly_add(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[]);
+
+cppecc_s32 gf_field_poly_mul(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[]);
+cppecc_s32 gf_poly_mul(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[]);
+cppecc_s32 gf_field_poly_mul_len(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[], cppecc_s32 l);
+cppecc_s32 gf_poly_mul_len(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[], cppecc_s32 l);
+
+cppecc_u8 gf_field_poly_eval(const CPPECC_STRUCT RSField* field, cppecc_s32 size, const cppecc_u8 poly[], cppecc_u8 x);
+cppecc_u8 gf_poly_eval(cppecc_s32 size, const cppecc_u8 poly[], cppecc_u8 x);
+
+/**
+ @brief Remainder of a polynomial division by a monic divisor, coefficients are ordered from the highest degree.
+ @param [out] result[] ... The size should be sizeDividend, the remainder is moved to the front.
+ @return size of the remainder, that is 'sizeDivisor - 1'.
+ */
+cppecc_s32 gf_field_poly_div(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 sizeDividend, const cppecc_u8 dividend[], cppecc_s32 sizeDivisor, const cppecc_u8 divisor[]);
+cppecc_s32 gf_poly_div(cppecc_u8 result[], cppecc_s32 sizeDividend, const cppecc_u8 dividend[], cppecc_s32 sizeDivisor, const cppecc_u8 divisor[]);
+
+void rs_field_generator_poly(const CPPECC_STRUCT RSField* field, cppecc_s32 size, cppecc_u8 result[], cppecc_u8 tmp[]);
+void rs_generator_poly(cppecc_s32 size, cppecc_u8 result[], cppecc_u8 tmp[]);
+
+/**
+ @brief Build split-nibble rows of remainder tables for vectorized encoders.
+ @param [in] numSymbols
+ @param [in] slices ... number of tables
+ @param [in] stride ... length of rows, numSymbols rounded up to a multiple of vector registers
+ @param [out] result ... The size should be 'slices * 32 * stride'. Row result[e][0][n] = n*x^(numSymbols+e) mod generator, result[e][1][n] = (n<<4)*x^(numSymbols+e) mod generator, rows are padded with zeros.
+ @param [in] sliceTables ... made by rs_slice_tables
+ */
+void rs_nibble_tables(cppecc_s32 numSymbols, cppecc_s32 slices, cppecc_s32 stride, cppecc_u8 result[], const cppecc_u8 sliceTables[]);
+
+/**
+ @brief Build shuffle tables which multiply vectors by each coefficient of the generation polynomial.
+ @param [in] numSymbols
+ @param [in] stride ... number of tables, the ones from numSymbols are zeros
+ @param [out] result ... The size should be 'stride * 32'. result[k][0][n] = generator[k+1]*n, result[k][1][n] = generator[k+1]*(n<<4)
+ @param [in] generator
+ */
+void rs_shuffle_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_s32 stride, cppecc_u8 result[], const cppecc_u8 generator[]);
+
+/**
+ @brief Build shuffle tables which multiply vectors by powers of the roots of the generation polynomial, for vectorized syndrome scans.
+ @param [in] numSymbols ... number of syndromes to scan
+ @param [out] result ... The size should be 'numSymbols * 6 * 32'. result[i][f][0][n] = alpha^(i*2^f)*n, result[i][f][1][n] = alpha^(i*2^f)*(n<<4)
+ */
+void rs_power_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_u8 result[]);
+
+/**
+ @brief Build shuffle tables which multiply vectors by inverse powers of beta, for vectorized Chien searches.
+ @param [in] numTerms ... the highest degree of locators, that is numSymbols/2
+ @param [out] result ... The size should be 'numTerms * 6 * 32'. result[j-1][f][0][n] = beta^(-j*2^f)*n, result[j-1][f][1][n] = beta^(-j*2^f)*(n<<4)
+ */
+void rs_chien_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numTerms, cppecc_u8 result[]);
+
+/**
+ @brief Build remainder tables for slicing-by-N encoders.
+ @param [in] numSymbols
+ @param [in] slices ... number of tables
+ @param [out] result ... The size should be 'slices * 256 * numSymbols'. result[(e*256 + b)*numSymbols + k] is the coefficient k of b*x^(numSymbols+e) mod generator.
+ @param [in] generator
+ */
+void rs_slice_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_s32 slices, cppecc_u8 result[], const cppecc_u8 generator[]);
+
+/**
+ @brief Build redundant symbols of each position of a message, for delta updates and chunks.
+ @param [in] numSymbols
+ @param [in] numRows ... number of positions, 'CPPECC_GF_NW1 - numSymbols' covers the longest message
+ @param [out] result ... The size should be 'numRows * numSymbols'. result[e*numSymbols + k] is the coefficient k of x^(numSymbols+e) mod generator, that is the redundant symbols of a message which is 1 at e symbols before its end.
+ @param [in] generator
+ */
+void rs_delta_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_s32 numRows, cppecc_u8 result[], const cppecc_u8 generator[]);
+
+/**
+ @brief Remove known erasures from syndromes, the rest can be used to find the locator of unknown errors.
+ @param [out] result[] ... The size should be numSyndromes, only the first 'numSyndromes - numErasures' are valid.
+ @param [in] messageSize ... size of the whole message including redundant symbols
+ @param [in] numSyndromes
+ @param [in] syndromes[]
+ @param [in] numErasures
+ @param [in] erasures[] ... positions of erasures in the message
+ */
+void rs_field_forney_syndromes(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numSyndromes, const cppecc_u8 syndromes[], cppecc_s32 numErasures, const cppecc_u8 erasures[]);
+void rs_forney_syndromes(cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numSyndromes, const cppecc_u8 syndromes[], cppecc_s32 numErasures, const cppecc_u8 erasures[]);
+
+/**
+ @brief Erasure locator, the product of (1 + X*x) for X = alpha^(messageSize - 1 - position).
+ @param [out] result[] ... The size should be 'numErasures + 1', coefficients are ordered from x^0.
+ @return size of the polynomial
+ */
+cppecc_s32 rs_field_erasure_locator(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numErasures, const cppecc_u8 erasures[]);
+cppecc_s32 rs_erasure_locator(cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numErasures, const cppecc_u8 erasures[]);
+
+cppecc_s32 rs_modified_berlekamp_massey(CPPECC_STRUCT RSContext* context, cppecc_u8 result[], cppecc_s32 numSyndromes, const cppecc_u8 syndromes[]);
+cppecc_s32 rs_field_chien_search_two(const CPPECC_STRUCT RSField* field, cppecc_u8 result[2], cppecc_u8 start, cppecc_u8 end, cppecc_u8 a, cppecc_u8 b);
+cppecc_s32 rs_chien_search_two(cppecc_u8 result[2], cppecc_u8 start, cppecc_u8 end, cppecc_u8 a, cppecc_u8 b);
+cppecc_s32 rs_field_chien_search(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_u8 size, cppecc_u8 numSigma, const cppecc_u8 sigma[]);
+cppecc_s32 rs_chien_search(cppecc_u8 result[], cppecc_u8 size, cppecc_u8 numSigma, const cppecc_u8 sigma[]);
+void rs_field_error_correct_forney(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u8 pos[], cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[]);
+void rs_error_correct_forney(cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u8 pos[], cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[]);
+
+/**
+ @brief Find roots of the error locator and correct them in one pass, the same as rs_chien_search and rs_error_correct_forney.
+ @param [in] context ... Used for the field and chien_ tables.
+ @param [in, out] result[] ... the message including redundant symbols, that is not modified if it fails.
+ @param [in] length ... size of the message
+ @param [in] numSigma ... 'numErrors + 1', numErrors should not exceed context->numSymbols_/2
+ @param [in] sigma[] ... the error locator from x^0
+ @param [in] numOmega
+ @param [in] omega[] ... the error evaluator from x^0
+ @return The number of corrected symbols, or CPPECC_ERROR if the locator doesn't have numErrors roots in the message.
+
+ Each term of sigma and omega has a register of the values at 16 or 32 positions, which steps forward with a constant multiplication.
+ The odd terms of sigma are the denominator of Forney's formula, so a root has the value of its correction at the same time.
+ */
+cppecc_s32 rs_chien_forney(const CPPECC_STRUCT RSContext* context, cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[]);
+
+/**
+ @brief Add redundant data to the original message for error correction.
+ @param [in, out] context ... Used for the generation polynomial and buffers.
+ @param [in] size ... message size
+ @param [in, out] message[] ... The size should be 'size + numSymbols'. Output will be made from the original message and added redundant symbols (that size is numSymbols).
+ @param numSymbols ... size of redundant symbols, that is equivalent to capability of error corrections * 2.
+ */
+void rs_encode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs_encode, but always uses the byte serial LFSR. This is the reference for vectorized encoders.
+ */
+void rs_encode_scalar(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs_encode, but uses only the remainder tables like slicing-by-8 CRC. This doesn't depend on any instruction set extensions.
+ @param [in] slices ... message bytes consumed in a step, 1, 4 or 8. This should not exceed numSlices_ of the context.
+ */
+void rs_encode_slicing(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_s32 slices);
+
+/**
+ @brief Transpose codewords to the byte interleaved layout, dst[j*count + i] = src[i][j].
+ @param [in] count ... number of codewords
+ @param [in] length ... number of symbols to transpose for each codeword
+ @param [in] src[] ... pointers to codewords
+ @param [out] dst[] ... The size should be 'length * count'.
+ */
+void rs_interleave(cppecc_s32 count, cppecc_s32 length, const cppecc_u8* const src[], cppecc_u8 dst[]);
+
+/**
+ @brief Transpose the byte interleaved layout back to codewords, dst[i][j] = src[j*count + i].
+ */
+void rs_deinterleave(cppecc_s32 count, cppecc_s32 length, const cppecc_u8 src[], cppecc_u8* const dst[]);
+
+/**
+ @brief Encode codewords in the byte interleaved layout. All codewords are encoded in lockstep, one codeword for each byte lane of vector registers.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] count ... number of codewords
+ @param [in] size ... message size of each codeword
+ @param [in, out] block[] ... The size should be '(size + numSymbols) * count'. Symbol j of codeword i is at 'j*count + i', the redundant symbols are written to rows from size.
+ @param numSymbols ... size of redundant symbols
+ */
+void rs_encode_interleaved(CPPECC_STRUCT RSContext* context, cppecc_s32 count, cppecc_s32 size, cppecc_u8 block[], cppecc_s32 numSymbols);
+
+/**
+ @brief Encode codewords of the same size. Same as rs_encode for each message, but groups of messages are transposed and encoded in lockstep.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] count ... number of codewords
+ @param [in] size ... message size of each codeword
+ @param [in, out] messages[] ... The size of each message should be 'size + numSymbols'.
+ @param numSymbols ... size of redundant symbols
+ */
+void rs_encode_batch(CPPECC_STRUCT RSContext* context, cppecc_s32 count, cppecc_s32 size, cppecc_u8* const messages[], cppecc_s32 numSymbols);
+
+/**
+ @brief Compute all syndromes in a single pass over the message.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] size ... message size
+ @param [in] message[] ... The size should be 'size + numSymbols'.
+ @param numSymbols ... size of redundant symbols
+ @param [out] syndromes[] ... syndromes[i] is the received polynomial evaluated at alpha^i, the size should be numSymbols.
+ @return 0 if all syndromes are zero, otherwise 1.
+
+ The message is divided by the generation polynomial with the same kernel as rs_encode, so an error-free message costs one encode.
+ Only a non-zero remainder, which is numSymbols long, is evaluated at the roots.
+ */
+cppecc_s32 rs_syndromes(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_u8 syndromes[]);
+
+/**
+ @brief Check whether a message is a codeword without correcting it.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] size ... message size
+ @param [in] message[] ... The size should be 'size + numSymbols'. This is never modified.
+ @param numSymbols ... size of redundant symbols
+ @return 0 if the message is clean, otherwise 1.
+
+ The faster of two strategies is chosen by numSymbols.
+ A syndrome scan evaluates the message at each root with SIMD, with one redundant symbol it's the sum of all symbols.
+ Otherwise, the data part is encoded again and the redundant symbols are compared, that is the remainder of gf_poly_div by the generation polynomial.
+ */
+cppecc_s32 rs_check(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Try to recover the original message from redundant symbols. But, when the number of errors exceeds the capability of Reed-Solomon codes, the message never be recoverted correctly.
+ @param [in, out] context ... Used for buffers
+ @param [in] size ... message size
+ @param [in, out] message[] ... The size should be 'size + numSymbols'. Output's corrupted symbols will be corrected.
+ @param numSymbols ... size of redundant symbols, that is equivalent to capability of error corrections.
+ @return The number of corrected symbols. When the number of erros exceeds the capability (so, it's numSymbols/2), the original message might not be recovered.
+ */
+cppecc_s32 rs_decode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs_decode, but buffers are taken from scratch instead of the context. Threads can decode with a shared context and their own scratches.
+ */
+cppecc_s32 rs_decode_scratch(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs_decode, but every step runs a fixed schedule, so that latency depends only on size and numSymbols.
+ @param [in] context ... Used for the field and tables, that is not modified.
+ @return The number of corrected symbols, or CPPECC_ERROR.
+
+ Syndromes are always evaluated, the inversionless Berlekamp-Massey runs numSymbols iterations with masks instead of branches,
+ sigma and omega are evaluated at all positions, and corrections of Forney's formula are masked by roots and applied to all symbols.
+ This is for deterministic latency. Table lookups are still indexed by data, so this is not hardening against cache timing.
+ */
+cppecc_s32 rs_decode_constant(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols);
+
+#if defined(CPPECC_ENABLE_STATS)
+/**
+ @brief Clear counters of a scratch, and the callback. gf_initialize and rs_context_create clear the context's scratch.
+ */
+void rs_stats_reset(CPPECC_STRUCT RSScratch* scratch);
+
+/**
+ @brief Set a callback of corrected symbols for decoders with this scratch, pass null to remove it.
+ */
+void rs_stats_set_callback(CPPECC_STRUCT RSScratch* scratch, cppecc_error_callback callback, void* user);
+
+/**
+ @brief Copy counters of a scratch. Don't take them while another thread decodes with the scratch.
+ */
+void rs_stats_snapshot(const CPPECC_STRUCT RSScratch* scratch, CPPECC_STRUCT RSStats* result);
+
+/**
+ @brief Add counters of stats to result, to sum up scratches of threads.
+ */
+void rs_stats_merge(CPPECC_STRUCT RSStats* result, const CPPECC_STRUCT RSStats* stats);
+
+/**
+ @brief Name of a stage, "syndromes", "locator", "chien" or "forney".
+ */
+const char* rs_stats_stage_name(cppecc_s32 stage);
+
+/**
+ @brief Write stats as a JSON object.
+ @return the length of JSON without the terminator, that is the same as snprintf. Output is truncated if it's larger than size.
+ */
+cppecc_s32 rs_stats_json(const CPPECC_STRUCT RSStats* stats, char buffer[], cppecc_size_t size);
+#endif
+
+/**
+ @brief Same as rs_decode, but positions of some corrupted symbols are known. When e erasures and v unknown errors satisfy 'e + 2v <= numSymbols', the message can be recovered.
+ @param [in, out] context ... Used for buffers
+ @param [in] size ... message size
+ @param [in, out] message[] ... The size should be 'size + numSymbols'. Output's corrupted symbols will be corrected.
+ @param numSymbols ... size of redundant symbols
+ @param [in] erasures[] ... distinct positions of known corrupted symbols in the message, 0 is the first symbol.
+ @param numErasures ... number of erasures, that should not exceed numSymbols.
+ @return The number of corrected symbols including erasures, or CPPECC_ERROR. Positions out of 'size + numSymbols', repeated positions, and corrections which do not make a codeword are CPPECC_ERROR, and the message is untouched.
+ */
+cppecc_s32 rs_decode_erasures(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols, const cppecc_u8 erasures[], cppecc_s32 numErasures);
+
+/**
+ @brief Encode a message gathered from segments, and write only redundant symbols. Segments are read in place, and the result is the same as rs_encode of their concatenation.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] segments[] ... parts of the message in order, segments of zero length are skipped. The total length plus numSymbols should be less than CPPECC_GF_NW.
+ @param numSegments ... number of segments
+ @param [out] parity[] ... The size should be numSymbols.
+ @param numSymbols ... size of redundant symbols
+ */
+void rs_encode_parity(const CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSSegment segments[], cppecc_s32 numSegments, cppecc_u8 parity[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs_decode, but the message is segments and redundant symbols are apart. Corrections are written to the segments and parity in place.
+ @param [in, out] context ... Used for buffers
+ @param [in] segments[] ... parts of the message in order, same as rs_encode_parity. Bytes of them are corrected.
+ @param numSegments ... number of segments
+ @param [in, out] parity[] ... redundant symbols, the size should be numSymbols.
+ @param numSymbols ... size of redundant symbols
+ @return The number of corrected symbols, or CPPECC_ERROR.
+
+ Syndromes are evaluated from the remainder of the segments, the LFSR continues from one segment to the next.
+ Only a dirty codeword is corrected, and corrections are scattered to the segments which hold their positions.
+ */
+cppecc_s32 rs_decode_parity(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSSegment segments[], cppecc_s32 numSegments, cppecc_u8 parity[], cppecc_s32 numSymbols);
+
+/**
+ @brief Start to encode a message which comes in pieces.
+ @param [out] encoder
+ @param [in] context ... Used for the generation polynomial, the encoder refers to this.
+ @param numSymbols ... size of redundant symbols
+ */
+void rs_encoder_init(CPPECC_STRUCT RSEncoder* encoder, const CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols);
+
+/**
+ @brief Consume the next piece of the message. Pieces can be any length, the message in total plus numSymbols should be less than CPPECC_GF_NW.
+ @param [in, out] encoder
+ @param [in] data[] ... The size should be size. This is not referred after the call.
+ @param size ... size of the piece
+ */
+void rs_encoder_update(CPPECC_STRUCT RSEncoder* encoder, const cppecc_u8 data[], cppecc_size_t size);
+
+/**
+ @brief Write redundant symbols of the pieces so far, that are the same as rs_encode of their concatenation.
+ @param [in] encoder ... This is not modified, call rs_encoder_init for the next message.
+ @param [out] parity[] ... The size should be numSymbols.
+ */
+void rs_encoder_final(const CPPECC_STRUCT RSEncoder* encoder, cppecc_u8 parity[]);
+
+/**
+ @brief Start to decode a codeword which comes in pieces.
+ @param [out] decoder
+ @param [in] context ... Used for the generation polynomial, the decoder refers to this. Decoders don't modify it, so threads can share it.
+ @param size ... message size, the codeword is 'size + numSymbols' bytes.
+ @param numSymbols ... size of redundant symbols
+ */
+void rs_decoder_init(CPPECC_STRUCT RSDecoder* decoder, const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_s32 numSymbols);
+
+/**
+ @brief Consume the next piece of the codeword. A piece can be any length, and can cross the end of the message.
+ @param [in, out] decoder
+ @param [in] data[] ... The size should be size. This is not referred after the call.
+ @param size ... size of the piece
+ */
+void rs_decoder_update(CPPECC_STRUCT RSDecoder* decoder, const cppecc_u8 data[], cppecc_size_t size);
+
+/**
+ @brief Find errors of the codeword after all of it was consumed.
+ @param [in, out] decoder ... Call rs_decoder_init for the next codeword.
+ @param [out] positions[] ... offsets of corrupted symbols in the codeword, 0 is the first symbol. The size should be numSymbols/2.
+ @param [out] values[] ... values[i] is added to the symbol at positions[i] to correct it. The size should be numSymbols/2.
+ @return The number of corrupted symbols, 0 if the codeword is clean, or CPPECC_ERROR.
+
+ Clean codewords return without touching the tables of the field. Dirty ones go to the Berlekamp-Massey, the Chien search and Forney's formula without another pass over the codeword.
+ */
+cppecc_s32 rs_decoder_final(CPPECC_STRUCT RSDecoder* decoder, cppecc_u8 positions[], cppecc_u8 values[]);
+
+/**
+ @brief Update redundant symbols for a change of a range of the message, without encoding the whole message again.
+ @param [in] context ... Used for the tables of positions.
+ @param [in] size ... message size
+ @param [in] offset ... the first changed symbol
+ @param [in] oldBytes[] ... symbols of the range before the change, the size should be length.
+ @param [in] newBytes[] ... symbols of the range after the change, the size should be length.
+ @param [in] length ... size of the range, 'offset + length' should not exceed size.
+ @param [in, out] parity[] ... redundant symbols of the old message, which are replaced with the ones of the new message.
+ @param numSymbols ... size of redundant symbols
+
+ Encoding is linear, the redundant symbols of the difference are added.
+ A short difference adds the row of the tables for each changed symbol, a long one is encoded and moved to its position in the message.
+ */
+void rs_update_parity(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_s32 offset, const cppecc_u8 oldBytes[], const cppecc_u8 newBytes[], cppecc_s32 length, cppecc_u8 parity[], cppecc_s32 numSymbols);
+
+/**
+ @brief Encode a chunk of a message alone. Redundant symbols of chunks which cover a message are combined to the ones of the message with rs_combine_parity.
+ @param [in] context ... Used for the generation polynomial and the tables of positions.
+ @param [in] size ... size of the whole message
+ @param [in] offset ... position of the chunk in the message
+ @param [in] chunk[] ... The size should be length.
+ @param [in] length ... size of the chunk, 'offset + length' should not exceed size.
+ @param [out] parity[] ... redundant symbols of the message which has only this chunk and zeros elsewhere. The size should be numSymbols.
+ @param numSymbols ... size of redundant symbols
+
+ Chunks don't depend on each other, so threads can encode them in any order.
+ */
+void rs_encode_chunk(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_s32 offset, const cppecc_u8 chunk[], cppecc_s32 length, cppecc_u8 parity[], cppecc_s32 numSymbols);
+
+/**
+ @brief Add redundant symbols of a chunk to the ones of other chunks, that is XOR.
+ @param numSymbols ... size of redundant symbols
+ @param [in, out] parity[] ... The size should be numSymbols.
+ @param [in] chunkParity[] ... made by rs_encode_chunk
+ */
+void rs_combine_parity(cppecc_s32 numSymbols, cppecc_u8 parity[], const cppecc_u8 chunkParity[]);
+
+/**
+ @brief Number of codewords to protect a buffer, the last one is shortened if size is not a multiple of blockSize.
+ */
+cppecc_size_t rs_buffer_blocks(cppecc_size_t size, cppecc_s32 blockSize);
+
+/**
+ @brief Size of the output of rs_encode_buffer.
+ @return 'size + blocks * numSymbols' for CPPECC_LAYOUT_CODEWORDS, 'blocks * numSymbols' for CPPECC_LAYOUT_SEPARATE.
+ */
+cppecc_size_t rs_buffer_encoded_size(cppecc_size_t size, cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout);
+
+/**
+ @brief Encode a buffer of any length. The buffer is divided into blocks of blockSize, and each block is encoded as a codeword.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] size ... buffer size
+ @param [in] data[] ... The size should be size.
+ @param [out] output[] ... The size should be rs_buffer_encoded_size. With CPPECC_LAYOUT_CODEWORDS, codewords are written one after another. With CPPECC_LAYOUT_SEPARATE, only redundant symbols of blocks are written.
+ @param blockSize ... data symbols of each codeword, 'blockSize + numSymbols' should not exceed CPPECC_MAX_BODY_SIZE.
+ @param numSymbols ... size of redundant symbols of each codeword, the same as the context was made for.
+ @param layout ... CPPECC_LAYOUT_CODEWORDS or CPPECC_LAYOUT_SEPARATE
+
+ The kernel reads blocks from data and writes redundant symbols to output directly.
+ */
+void rs_encode_buffer(const CPPECC_STRUCT RSContext* context, cppecc_size_t size, const cppecc_u8 data[], cppecc_u8 output[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout);
+
+/**
+ @brief Check blocks of a buffer encoded by rs_encode_buffer without correcting them. Arguments are the same as rs_decode_buffer.
+ @param [out] status[] ... status[i] is 1 if block i is corrupted, otherwise 0. This can be null.
+ @return The number of corrupted blocks.
+ */
+cppecc_s32 rs_check_buffer(const CPPECC_STRUCT RSContext* context, cppecc_size_t size, const cppecc_u8 data[], const cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[]);
+
+/**
+ @brief Correct a buffer encoded by rs_encode_buffer in place.
+ @param [in, out] context ... Used for buffers
+ @param [in] size ... size of the original buffer
+ @param [in, out] data[] ... With CPPECC_LAYOUT_CODEWORDS, this is the output of rs_encode_buffer. With CPPECC_LAYOUT_SEPARATE, this is the original buffer.
+ @param [in, out] parity[] ... redundant symbols for CPPECC_LAYOUT_SEPARATE, ignored for CPPECC_LAYOUT_CODEWORDS.
+ @param blockSize ... same as rs_encode_buffer
+ @param numSymbols ... same as rs_encode_buffer
+ @param layout ... same as rs_encode_buffer
+ @param [out] status[] ... The size should be rs_buffer_blocks, status[i] is the result of rs_decode for block i. This can be null.
+ @return The number of corrected symbols of all blocks, or CPPECC_ERROR if any block could not be corrected.
+
+ Clean blocks are checked in caller memory. With CPPECC_LAYOUT_SEPARATE, a corrupted block and its redundant symbols are gathered to a codeword before correction.
+ */
+cppecc_s32 rs_decode_buffer(CPPECC_STRUCT RSContext* context, cppecc_size_t size, cppecc_u8 data[], cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[]);
+
+/**
+ @brief CCSDS (255, 223), 0x187 with the roots beta^112, ..., beta^143, where beta = alpha^11.
+ @param [in] dualBasis ... Non-zero if symbols on links are in Berlekamp's dual basis as the recommendation, otherwise in the conventional basis.
+ */
+const CPPECC_STRUCT RSProfile* rs_profile_ccsds(cppecc_s32 dualBasis);
+
+/**
+ @brief DVB (204, 188), shortened from (255, 239) of 0x11D with the roots alpha^0, ..., alpha^15.
+ */
+const CPPECC_STRUCT RSProfile* rs_profile_dvb(void);
+
+/**
+ @brief Same as gf_initialize_field with the field and the number of redundant symbols of a profile.
+ */
+cppecc_s32 rs_profile_initialize(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSProfile* profile);
+
+/**
+ @brief Encode a codeword of a profile.
+ @param [in] context ... Initialized by rs_profile_initialize.
+ @param [in, out] codeword[] ... The size should be codewordSize_, messageSize_ symbols are followed by redundant symbols. Symbols are in the basis of links.
+ */
+void rs_profile_encode(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSProfile* profile, cppecc_u8 codeword[]);
+
+/**
+ @brief Correct a codeword of a profile in place.
+ @return The number of corrected symbols, or CPPECC_ERROR.
+ */
+cppecc_s32 rs_profile_decode(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSProfile* profile, cppecc_u8 codeword[]);
+
+/**
+ @brief Convert symbols between bases with a shuffle table of a profile, toDual_ or fromDual_. Conversions are linear, so that a symbol is the sum of the low and high nibbles' rows.
+ @param [in] table ... [low,high][nibble]
+ @param [in] size
+ @param [in] src[]
+ @param [out] dst[] ... This can be the same as src.
+ */
+void rs_convert_basis(const cppecc_u8 table[32], cppecc_s32 size, const cppecc_u8 src[], cppecc_u8 dst[]);
+
+/**
+ @brief Build tables of GF(2^16).
+ @param [out] field
+ @param [in] polynomial ... primitive polynomial of degree 16, CPPECC_GF16_PRIMITIVE is the default.
+ @return 0, or CPPECC_ERROR if polynomial is not primitive.
+ */
+cppecc_s32 gf16_field_build(CPPECC_STRUCT RS16Field* field, cppecc_u32 polynomial);
+
+cppecc_u16 gf16_field_mul(const CPPECC_STRUCT RS16Field* field, cppecc_u16 a, cppecc_u16 b);
+
+cppecc_u16 gf16_field_div(const CPPECC_STRUCT RS16Field* field, cppecc_u16 a, cppecc_u16 b);
+
+cppecc_u16 gf16_field_pow(const CPPECC_STRUCT RS16Field* field, cppecc_u16 x, cppecc_s32 p);
+
+cppecc_u16 gf16_field_inverse(const CPPECC_STRUCT RS16Field* field, cppecc_u16 x);
+
+/**
+ @brief Initialize the generation polynomial from numSymbols, and allocate split tables of GF(2^16) for it with CPPECC_MALLOC.
+ @param [in,out] context ... Release it with gf16_terminate before initializing it again.
+ @param [in] numSymbols ... This should not exceed CPPECC_MAX_ECC16_SIZE.
+ @param [in] field ... The context refers to this, it should live longer than the context.
+ @return 0, or CPPECC_ERROR if allocation failed
+ */
+cppecc_s32 gf16_initialize(CPPECC_STRUCT RS16Context* context, cppecc_s32 numSymbols, const CPPECC_STRUCT RS16Field* field);
+
+/**
+ @brief Free the tables of gf16_initialize.
+ */
+void gf16_terminate(CPPECC_STRUCT RS16Context* context);
+
+cppecc_s32 rs16_berlekamp_massey(CPPECC_STRUCT RS16Context* context, cppecc_u16 result[], cppecc_s32 numSyndromes, const cppecc_u16 syndromes[]);
+/**
+ @brief Find roots of sigma with log and exp tables, result[] are the roots X. This is the reference, rs16_decode scans with split tables.
+ */
+cppecc_s32 rs16_chien_search(const CPPECC_STRUCT RS16Field* field, cppecc_u16 result[], cppecc_s32 size, cppecc_s32 numSigma, const cppecc_u16 sigma[]);
+void rs16_error_correct_forney(const CPPECC_STRUCT RS16Field* field, cppecc_u16 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u16 pos[], cppecc_s32 numSigma, const cppecc_u16 sigma[], cppecc_s32 numOmega, const cppecc_u16 omega[]);
+
+/**
+ @brief Same as rs_encode, but symbols are 16 bits. A codeword can be up to CPPECC_MAX_BODY16_SIZE symbols.
+ @param [in] context ... Used for the generation polynomial.
+ @param [in] size ... message size in symbols
+ @param [in, out] message[] ... The size should be 'size + numSymbols'.
+ @param numSymbols ... size of redundant symbols, the same as gf16_initialize
+
+ Products with the feedback are looked up from two rows of 256 entries, one for each byte of the feedback.
+ */
+void rs16_encode(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, cppecc_u16 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs16_encode, but always uses the symbol serial LFSR with log and exp tables. This is the reference.
+ */
+void rs16_encode_scalar(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, cppecc_u16 message[], cppecc_s32 numSymbols);
+
+/**
+ @brief Same as rs_syndromes, but symbols are 16 bits.
+ @return 0 if all syndromes are zero, otherwise 1.
+ */
+cppecc_s32 rs16_syndromes(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, const cppecc_u16 message[], cppecc_s32 numSymbols, cppecc_u16 syndromes[]);
+
+/**
+ @brief Same as rs_decode, but symbols are 16 bits.
+ @return The number of corrected symbols, or CPPECC_ERROR.
+ */
+cppecc_s32 rs16_decode(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, cppecc_u16 message[], cppecc_s32 numSymbols);
+
+#if defined(__cplusplus) && (201103L <= __cplusplus || 1900 <= _MSC_VER)
+// Tables of RSField at compile time. Every recursion is shorter than 256 steps, that is in the limits of constant expressions.
+constexpr cppecc_u32 gf_ct_mulx(cppecc_u32 polynomial, cppecc_u32 x)
+{
+    return ((x << 1) ^ ((0x80U & x) ? polynomial : 0U)) & 0xFFU;
+}
+
+constexpr cppecc_u32 gf_ct_alpha(cppecc_u32 polynomial, cppecc_u32 e)
+{
+    return 0 == e ? 1U : gf_ct_mulx(polynomial, gf_ct_alpha(polynomial, e - 1));
+}
+
+constexpr cppecc_u32 gf_ct_log_alpha(cppecc_u32 polynomial, cppecc_u32 x, cppecc_u32 e, cppecc_u32 y)
+{
+    return (y == x || CPPECC_GF_NW1 <= e) ? e % CPPECC_GF_NW1 : gf_ct_log_alpha(polynomial, x, e + 1, gf_ct_mulx(polynomial, y));
+}
+
+constexpr cppecc_u32 gf_ct_order(cppecc_u32 polynomial, cppecc_u32 e, cppecc_u32 y)
+{
+    return (1U == y || CPPECC_GF_NW1 <= e) ? e : gf_ct_order(polynomial, e + 1, gf_ct_mulx(polynomial, y));
+}
+
+constexpr cppecc_u32 gf_ct_inverse_mod(cppecc_u32 a, cppecc_u32 i)
+{
+    return CPPECC_GF_NW1 <= i ? 0U : ((a * i) % CPPECC_GF_NW1 == 1U ? i : gf_ct_inverse_mod(a, i + 1));
+}
+
+template<cppecc_u32... I>
+struct GFIndices
+{
+};
+
+template<cppecc_u32 N, cppecc_u32... I>
+struct GFMakeIndices : GFMakeIndices<N - 1, N - 1, I...>
+{
+};
+
+template<cppecc_u32... I>
+struct GFMakeIndices<0, I...>
+{
+    typedef GFIndices<I...> type;
+};
+
+template<cppecc_u32 Polynomial, cppecc_s32 FCR, cppecc_s32 Prim, cppecc_u32... I>
+constexpr RSField gf_ct_field(GFIndices<I...>)
+{
+    return RSField{
+        {static_cast<cppecc_u8>((gf_ct_log_alpha(Polynomial, I, 0, 1) * gf_ct_inverse_mod(Prim % CPPECC_GF_NW1, 1)) % CPPECC_GF_NW1)...},
+        {static_cast<cppecc_u8>(gf_ct_alpha(Polynomial, (Prim * I) % CPPECC_GF_NW1))...},
+        Polynomial,
+        FCR % static_cast<cppecc_s32>(CPPECC_GF_NW1),
+        Prim % static_cast<cppecc_s32>(CPPECC_GF_NW1)};
+}
+
+/**
+ @brief Field and roots as template parameters, the tables are made at compile time.
+
+ For example, codes of CCSDS are 'gf_initialize_field(&context, 32, &RSFieldParams<0x187U, 112, 11>::field)'.
+ */
+template<cppecc_u32 Polynomial = 0x11DU, cppecc_s32 FCR = 0, cppecc_s32 Prim = 1>
+struct RSFieldParams
+{
+    static_assert(CPPECC_GF_NW <= Polynomial && Polynomial < (CPPECC_GF_NW << 1), "The degree of polynomial should be 8");
+    static_assert(CPPECC_GF_NW1 == gf_ct_order(Polynomial, 1, 2), "Polynomial should be primitive");
+    static_assert(0 < Prim && 0 != gf_ct_inverse_mod(Prim % CPPECC_GF_NW1, 1), "Prim should be coprime with 255");
+    static_assert(0 <= FCR, "FCR should not be negative");
+
+    static constexpr RSField field = gf_ct_field<Polynomial, FCR, Prim>(typename GFMakeIndices<CPPECC_GF_NW>::type());
+};
+
+template<cppecc_u32 Polynomial, cppecc_s32 FCR, cppecc_s32 Prim>
+constexpr RSField RSFieldParams<Polynomial, FCR, Prim>::field;
+#endif
+
+#if defined(__cplusplus) && (201103L <= __cplusplus || 1900 <= _MSC_VER)
+/**
+ @brief Coefficients of a polynomial from the highest degree.
+ */
+template<cppecc_s32 Size>
+struct RSPolynomial
+{
+    cppecc_u8 coefficients_[Size];
+};
+
+constexpr cppecc_u8 gf_ct_mul(const RSField& field, cppecc_u8 a, cppecc_u8 b)
+{
+    return (0 == a || 0 == b) ? 0 : field.exp_[(field.log_[a] + field.log_[b]) % CPPECC_GF_NW1];
+}
+
+// p(x)*(x + root), the coefficients beyond the degree of p are zeros
+template<cppecc_u32... I>
+constexpr RSPolynomial<sizeof...(I)> gf_ct_generator_step(const RSField& field, const RSPolynomial<sizeof...(I)>& p, cppecc_u8 root, GFIndices<I...>)
+{
+    return RSPolynomial<sizeof...(I)>{{static_cast<cppecc_u8>(p.coefficients_[I] ^ (0 == I ? 0 : gf_ct_mul(field, root, p.coefficients_[0 == I ? 0 : I - 1])))...}};
+}
+
+template<cppecc_u32... I>
+constexpr RSPolynomial<sizeof...(I)> gf_ct_generator(const RSField& field, cppecc_s32 degree, GFIndices<I...> indices)
+{
+    return 0 == degree
+               ? RSPolynomial<sizeof...(I)>{{static_cast<cppecc_u8>(0 == I ? 1 : 0)...}}
+               : gf_ct_generator_step(field, gf_ct_generator(field, degree - 1, indices), field.exp_[(field.fcr_ + degree - 1) % CPPECC_GF_NW1], indices);
+}
+
+/**
+ @brief Codec of a fixed geometry, N symbols of a codeword and K symbols of a message. Params is a RSFieldParams.
+
+ The generation polynomial is made at compile time, and tables of the encoder are made from it by the constructor, so gf_initialize is not needed.
+ Every loop is bounded by N and K, the kernels are instantiated for the number of registers and unrolled by compilers.
+ The encoder kernel follows the kernels which rs_select_kernels bound when the codec is constructed.
+ A codec is read only after construction, threads can share it. The encoder's rows are 8 KiB for 32 redundant symbols with SIMD.
+
+ @code
+ static const RSCodec<255, 223> codec;
+ codec.encode(codeword);
+ cppecc_s32 corrected = codec.decode(codeword);
+ @endcode
+ */
+template<cppecc_s32 N, cppecc_s32 K, class Params = RSFieldParams<> >
+class RSCodec
+{
+    static_assert(0 < K && K < N && N <= CPPECC_MAX_BODY_SIZE, "K should be less than N, and N should not exceed 255");
+
+public:
+    static const cppecc_s32 Size = K; //!< message symbols
+    static const cppecc_s32 NumSymbols = N - K; //!< redundant symbols
+    static constexpr RSPolynomial<N - K + 1> generator = gf_ct_generator(Params::field, N - K, typename GFMakeIndices<N - K + 1>::type());
+
+    RSCodec();
+
+    /**
+     @brief Write the redundant symbols of codeword[0, K) to codeword[K, N).
+     */
+    void encode(cppecc_u8 codeword[N]) const;
+
+    /**
+     @brief Write the redundant symbols of message to parity.
+     */
+    void encode(const cppecc_u8 message[K], cppecc_u8 parity[N - K]) const;
+
+    /**
+     @return 0 if codeword is clean, otherwise 1.
+     */
+    cppecc_s32 check(const cppecc_u8 codeword[N]) const;
+
+    /**
+     @brief Same as rs_syndromes.
+     @return 0 if all syndromes are zero, otherwise 1.
+     */
+    cppecc_s32 syndromes(const cppecc_u8 codeword[N], cppecc_u8 syndromes[N - K]) const;
+
+    /**
+     @brief Same as rs_decode, buffers are on the stack.
+     @return The number of corrected symbols, or CPPECC_ERROR.
+     */
+    cppecc_s32 decode(cppecc_u8 codeword[N]) const;
+
+private:
+    static const cppecc_s32 Slices = (N - K) <= 64 ? CPPECC_MAX_SLICES : (((N - K) <= 128 && 4 <= CPPECC_MAX_SLICES) ? 4 : 1);
+    static const cppecc_s32 Stride = (N - K) <= 16 ? 16 : (((N - K) + 31) & ~31);
+    static const cppecc_s32 MaxErrors = (N - K) / 2;
+#    if defined(CPPECC_KERNEL_SSSE3)
+    static const bool Nibbles = 16 < (N - K); //!< with constant sizes, the byte slices auto-vectorize and win for short parity
+#    else
+    static const bool Nibbles = false;
+#    endif
+    static const cppecc_s32 End8 = 8 <= Slices ? (K & ~7) : 0; //!< end of the 8-symbol steps
+    static const cppecc_s32 End4 = 4 <= Slices ? (End8 + ((K - End8) & ~3)) : End8; //!< end of the 4-symbol steps
+
+#    if defined(CPPECC_KERNEL_SSSE3)
+    template<cppecc_s32 Registers>
+    CPPECC_TARGET_SSSE3 void lfsr_ssse3(const cppecc_u8 message[], cppecc_u8 remainder[]) const;
+#    endif
+#    if defined(CPPECC_KERNEL_AVX2)
+    template<cppecc_s32 Registers>
+    CPPECC_TARGET_AVX2 void lfsr_avx2(const cppecc_u8 message[], cppecc_u8 remainder[]) const;
+#    endif
+    void lfsr_nibbles(const cppecc_u8 message[], cppecc_u8 remainder[]) const;
+    void lfsr_slicing(const cppecc_u8 message[], cppecc_u8 remainder[]) const;
+    void remainder(const cppecc_u8 message[], cppecc_u8 result[]) const;
+    cppecc_s32 berlekamp_massey(const cppecc_u8 syndromes[], cppecc_u8 sigma[]) const;
+    cppecc_s32 chien_search(cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_u8 positions[]) const;
+    cppecc_s32 forney(const cppecc_u8 syndromes[], const cppecc_u8 sigma[], cppecc_s32 numErrors, const cppecc_u8 positions[], cppecc_u8 codeword[]) const;
+
+    void (RSCodec::*lfsr_)(const cppecc_u8 message[], cppecc_u8 remainder[]) const; //!< the encoder kernel bound by the constructor
+    cppecc_u8 rows_[Nibbles ? (Slices * 32 * Stride) : (Slices * CPPECC_GF_NW * (N - K))]; //!< the same as rs_nibble_tables if Nibbles, otherwise the same as rs_slice_tables
+    cppecc_u8 exp2_[2 * CPPECC_GF_NW]; //!< exp_ repeated twice, the sum of two logs doesn't need modulo
+    cppecc_u8 roots_[N - K][N - K]; //!< roots_[i][k] is the log of beta^((fcr+i)*(NumSymbols-1-k)), the power of remainder symbol k for syndrome i
+};
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+constexpr RSPolynomial<N - K + 1> RSCodec<N, K, Params>::generator;
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+RSCodec<N, K, Params>::RSCodec()
+{
+    const RSField* field = &Params::field;
+    const cppecc_u8* g = generator.coefficients_;
+    lfsr_ = &RSCodec::lfsr_slicing;
+    if(Nibbles) {
+        // The same rows as rs_nibble_tables, n*x^NumSymbols mod g(x) = n*(g(x) - x^NumSymbols) and each next slice is multiplied by x
+        for(cppecc_s32 n = 0; n < 32; ++n) {
+            cppecc_u8 b = static_cast<cppecc_u8>(n < 16 ? n : ((n - 16) << 4));
+            cppecc_u8* row = rows_ + n * Stride;
+            for(cppecc_s32 k = 0; k < Stride; ++k) {
+                row[k] = k < NumSymbols ? gf_field_mul(field, g[k + 1], b) : 0;
+            }
+        }
+        for(cppecc_s32 e = 1; e < Slices; ++e) {
+            for(cppecc_s32 n = 0; n < 32; ++n) {
+                const cppecc_u8* prev = rows_ + ((e - 1) * 32 + n) * Stride;
+                cppecc_u8* row = rows_ + (e * 32 + n) * Stride;
+                for(cppecc_s32 k = 0; k < Stride; ++k) {
+                    row[k] = k < NumSymbols ? static_cast<cppecc_u8>(((k + 1) < NumSymbols ? prev[k + 1] : 0) ^ gf_field_mul(field, prev[0], g[k + 1])) : 0;
+                }
+            }
+        }
+        lfsr_ = &RSCodec::lfsr_nibbles;
+#    if defined(CPPECC_KERNEL_SSSE3)
+        // The same kernels as rs_select_kernels binds
+        cppecc_u32 features = rs_selected_kernels();
+        if(0 != (features & CPPECC_CPU_SSSE3)) {
+            lfsr_ = &RSCodec::template lfsr_ssse3<(NumSymbols + 15) / 16>;
+        }
+#        if defined(CPPECC_KERNEL_AVX2)
+        if(0 != (features & CPPECC_CPU_AVX2)) {
+            lfsr_ = &RSCodec::template lfsr_avx2<(NumSymbols + 31) / 32>;
+        }
+#        endif
+#    endif
+    } else {
+        rs_slice_tables(field, NumSymbols, Slices, rows_, g);
+    }
+    for(cppecc_s32 i = 0; i < static_cast<cppecc_s32>(2 * CPPECC_GF_NW); ++i) {
+        exp2_[i] = field->exp_[i % CPPECC_GF_NW1];
+    }
+    for(cppecc_s32 i = 0; i < NumSymbols; ++i) {
+        for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+            roots_[i][k] = static_cast<cppecc_u8>(((field->fcr_ + i) % CPPECC_GF_NW1) * (NumSymbols - 1 - k) % CPPECC_GF_NW1);
+        }
+    }
+}
+
+#    if defined(CPPECC_KERNEL_SSSE3)
+// Same as rs_lfsr_ssse3, but the size, stride and slices are constants
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+template<cppecc_s32 Registers>
+CPPECC_TARGET_SSSE3 void RSCodec<N, K, Params>::lfsr_ssse3(const cppecc_u8 message[], cppecc_u8 remainder[]) const
+{
+    __m128i s[Registers];
+    for(cppecc_s32 r = 0; r < Registers; ++r) {
+        s[r] = _mm_setzero_si128();
+    }
+    cppecc_s32 i = 0;
+    for(; i < End8; i += 8) {
+        cppecc_u32 f0 = static_cast<cppecc_u32>(_mm_cvtsi128_si32(s[0]));
+        cppecc_u32 f1 = static_cast<cppecc_u32>(_mm_cvtsi128_si32(_mm_srli_si128(s[0], 4)));
+        for(cppecc_s32 r = 0; r < (Registers - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 8);
+        }
+        s[Registers - 1] = _mm_srli_si128(s[Registers - 1], 8);
+        for(cppecc_s32 d = 0; d < 8; ++d) {
+            cppecc_u32 feedback = message[i + d] ^ static_cast<cppecc_u8>((d < 4) ? (f0 >> (8 * d)) : (f1 >> (8 * (d - 4))));
+            const cppecc_u8* lo = rows_ + ((7 - d) * 32 + (feedback & 0x0FU)) * Stride;
+            const cppecc_u8* hi = rows_ + ((7 - d) * 32 + 16 + (feedback >> 4)) * Stride;
+            for(cppecc_s32 r = 0; r < Registers; ++r) {
+                s[r] = _mm_xor_si128(s[r], _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo + 16 * r)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi + 16 * r))));
+            }
+        }
+    }
+    for(; i < End4; i += 4) {
+        cppecc_u32 f0 = static_cast<cppecc_u32>(_mm_cvtsi128_si32(s[0]));
+        for(cppecc_s32 r = 0; r < (Registers - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 4);
+        }
+        s[Registers - 1] = _mm_srli_si128(s[Registers - 1], 4);
+        for(cppecc_s32 d = 0; d < 4; ++d) {
+            cppecc_u32 feedback = message[i + d] ^ static_cast<cppecc_u8>(f0 >> (8 * d));
+            const cppecc_u8* lo = rows_ + ((3 - d) * 32 + (feedback & 0x0FU)) * Stride;
+            const cppecc_u8* hi = rows_ + ((3 - d) * 32 + 16 + (feedback >> 4)) * Stride;
+            for(cppecc_s32 r = 0; r < Registers; ++r) {
+                s[r] = _mm_xor_si128(s[r], _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo + 16 * r)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi + 16 * r))));
+            }
+        }
+    }
+    for(; i < K; ++i) {
+        cppecc_u32 feedback = message[i] ^ static_cast<cppecc_u8>(_mm_cvtsi128_si32(s[0]));
+        for(cppecc_s32 r = 0; r < (Registers - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 1);
+        }
+        s[Registers - 1] = _mm_srli_si128(s[Registers - 1], 1);
+        const cppecc_u8* lo = rows_ + (feedback & 0x0FU) * Stride;
+        const cppecc_u8* hi = rows_ + (16 + (feedback >> 4)) * Stride;
+        for(cppecc_s32 r = 0; r < Registers; ++r) {
+            s[r] = _mm_xor_si128(s[r], _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo + 16 * r)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi + 16 * r))));
+        }
+    }
+    for(cppecc_s32 r = 0; r < Registers; ++r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(remainder + 16 * r), s[r]);
+    }
+}
+#    endif
+
+#    if defined(CPPECC_KERNEL_AVX2)
+// Same as rs_lfsr_avx2, but the size, stride and slices are constants
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+template<cppecc_s32 Registers>
+CPPECC_TARGET_AVX2 void RSCodec<N, K, Params>::lfsr_avx2(const cppecc_u8 message[], cppecc_u8 remainder[]) const
+{
+    __m256i s[Registers];
+    for(cppecc_s32 r = 0; r < Registers; ++r) {
+        s[r] = _mm256_setzero_si256();
+    }
+    cppecc_s32 i = 0;
+    for(; i < End8; i += 8) {
+        __m128i s0 = _mm256_castsi256_si128(s[0]);
+        cppecc_u32 f0 = static_cast<cppecc_u32>(_mm_cvtsi128_si32(s0));
+        cppecc_u32 f1 = static_cast<cppecc_u32>(_mm_cvtsi128_si32(_mm_srli_si128(s0, 4)));
+        for(cppecc_s32 r = 0; r < (Registers - 1); ++r) {
+            s[r] = _mm256_alignr_epi8(_mm256_permute2x128_si256(s[r], s[r + 1], 0x21), s[r], 8);
+        }
+        s[Registers - 1] = _mm256_alignr_epi8(_mm256_permute2x128_si256(s[Registers - 1], s[Registers - 1], 0x81), s[Registers - 1], 8);
+        for(cppecc_s32 d = 0; d < 8; ++d) {
+            cppecc_u32 feedback = message[i + d] ^ static_cast<cppecc_u8>((d < 4) ? (f0 >> (8 * d)) : (f1 >> (8 * (d - 4))));
+            const cppecc_u8* lo = rows_ + ((7 - d) * 32 + (feedback & 0x0FU)) * Stride;
+            const cppecc_u8* hi = rows_ + ((7 - d) * 32 + 16 + (feedback >> 4)) * Stride;
+            for(cppecc_s32 r = 0; r < Registers; ++r) {
+                s[r] = _mm256_xor_si256(s[r], _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + 32 * r)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + 32 * r))));
+            }
+        }
+    }
+    for(; i < End4; i += 4) {
+        cppecc_u32 f0 = static_cast<cppecc_u32>(_mm256_cvtsi256_si32(s[0]));
+        for(cppecc_s32 r = 0; r < (Registers - 1); ++r) {
+            s[r] = _mm256_alignr_epi8(_mm256_permute2x128_si256(s[r], s[r + 1], 0x21), s[r], 4);
+        }
+        s[Registers - 1] = _mm256_alignr_epi8(_mm256_permute2x128_si256(s[Registers - 1], s[Registers - 1], 0x81), s[Registers - 1], 4);
+        for(cppecc_s32 d = 0; d < 4; ++d) {
+            cppecc_u32 feedback = message[i + d] ^ static_cast<cppecc_u8>(f0 >> (8 * d));
+            const cppecc_u8* lo = rows_ + ((3 - d) * 32 + (feedback & 0x0FU)) * Stride;
+            const cppecc_u8* hi = rows_ + ((3 - d) * 32 + 16 + (feedback >> 4)) * Stride;
+            for(cppecc_s32 r = 0; r < Registers; ++r) {
+                s[r] = _mm256_xor_si256(s[r], _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + 32 * r)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + 32 * r))));
+            }
+        }
+    }
+    for(; i < K; ++i) {
+        cppecc_u32 feedback = message[i] ^ static_cast<cppecc_u8>(_mm256_cvtsi256_si32(s[0]));
+        for(cppecc_s32 r = 0; r < (Registers - 1); ++r) {
+            s[r] = _mm256_alignr_epi8(_mm256_permute2x128_si256(s[r], s[r + 1], 0x21), s[r], 1);
+        }
+        s[Registers - 1] = _mm256_alignr_epi8(_mm256_permute2x128_si256(s[Registers - 1], s[Registers - 1], 0x81), s[Registers - 1], 1);
+        const cppecc_u8* lo = rows_ + (feedback & 0x0FU) * Stride;
+        const cppecc_u8* hi = rows_ + (16 + (feedback >> 4)) * Stride;
+        for(cppecc_s32 r = 0; r < Registers; ++r) {
+            s[r] = _mm256_xor_si256(s[r], _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + 32 * r)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + 32 * r))));
+        }
+    }
+    for(cppecc_s32 r = 0; r < Registers; ++r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(remainder + 32 * r), s[r]);
+    }
+}
+#    endif
+
+// Nibble rows of the first slice a symbol at a time, for CPUs without SSSE3 when Nibbles is true
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+void RSCodec<N, K, Params>::lfsr_nibbles(const cppecc_u8 message[], cppecc_u8 remainder[]) const
+{
+    cppecc_u8 r[N - K + 1] = {0};
+    for(cppecc_s32 i = 0; i < K; ++i) {
+        cppecc_u32 feedback = message[i] ^ r[0];
+        const cppecc_u8* lo = rows_ + (feedback & 0x0FU) * Stride;
+        const cppecc_u8* hi = rows_ + (16 + (feedback >> 4)) * Stride;
+        for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+            r[k] = r[k + 1] ^ lo[k] ^ hi[k];
+        }
+    }
+    for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+        remainder[k] = r[k];
+    }
+}
+
+// Same as rs_lfsr_slicing, used when Nibbles is false
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+void RSCodec<N, K, Params>::lfsr_slicing(const cppecc_u8 message[], cppecc_u8 remainder[]) const
+{
+    cppecc_u8 r[N - K + 8] = {0};
+    cppecc_s32 i = 0;
+    for(; i < End8; i += 8) {
+        const cppecc_u8* t[8];
+        for(cppecc_s32 d = 0; d < 8; ++d) {
+            t[d] = rows_ + ((7 - d) * CPPECC_GF_NW + (message[i + d] ^ r[d])) * NumSymbols;
+        }
+        for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+            r[k] = r[k + 8] ^ t[0][k] ^ t[1][k] ^ t[2][k] ^ t[3][k] ^ t[4][k] ^ t[5][k] ^ t[6][k] ^ t[7][k];
+        }
+    }
+    for(; i < End4; i += 4) {
+        const cppecc_u8* t[4];
+        for(cppecc_s32 d = 0; d < 4; ++d) {
+            t[d] = rows_ + ((3 - d) * CPPECC_GF_NW + (message[i + d] ^ r[d])) * NumSymbols;
+        }
+        for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+            r[k] = r[k + 4] ^ t[0][k] ^ t[1][k] ^ t[2][k] ^ t[3][k];
+        }
+    }
+    for(; i < K; ++i) {
+        const cppecc_u8* t = rows_ + (message[i] ^ r[0]) * NumSymbols;
+        for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+            r[k] = r[k + 1] ^ t[k];
+        }
+    }
+    for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+        remainder[k] = r[k];
+    }
+}
+
+/**
+ @brief Remainder of message(x)*x^NumSymbols, result should have Stride symbols.
+ */
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+CPPECC_FORCEINLINE void RSCodec<N, K, Params>::remainder(const cppecc_u8 message[], cppecc_u8 result[]) const
+{
+    (this->*lfsr_)(message, result);
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+void RSCodec<N, K, Params>::encode(cppecc_u8 codeword[N]) const
+{
+    encode(codeword, codeword + K);
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+void RSCodec<N, K, Params>::encode(const cppecc_u8 message[K], cppecc_u8 parity[N - K]) const
+{
+    cppecc_u8 r[Stride];
+    remainder(message, r);
+    for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+        parity[k] = r[k];
+    }
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+cppecc_s32 RSCodec<N, K, Params>::check(const cppecc_u8 codeword[N]) const
+{
+    cppecc_u8 r[Stride];
+    remainder(codeword, r);
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+        hasError |= r[k] ^ codeword[K + k];
+    }
+    return 0 != hasError ? 1 : 0;
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+cppecc_s32 RSCodec<N, K, Params>::syndromes(const cppecc_u8 codeword[N], cppecc_u8 syndromes[N - K]) const
+{
+    // The received polynomial and the remainder of its division by the generator have the same values at the roots
+    cppecc_u8 r[Stride];
+    remainder(codeword, r);
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+        r[k] ^= codeword[K + k];
+        hasError |= r[k];
+    }
+    if(0 == hasError) {
+        for(cppecc_s32 i = 0; i < NumSymbols; ++i) {
+            syndromes[i] = 0;
+        }
+        return 0;
+    }
+    // Logs of non-zero symbols, zeros are dropped by the mask
+    const RSField& field = Params::field;
+    cppecc_u8 logs[N - K];
+    cppecc_u8 masks[N - K];
+    for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+        logs[k] = field.log_[r[k]];
+        masks[k] = 0 == r[k] ? 0 : 0xFFU;
+    }
+    for(cppecc_s32 i = 0; i < NumSymbols; ++i) {
+        cppecc_u8 s = 0;
+        for(cppecc_s32 k = 0; k < NumSymbols; ++k) {
+            s ^= exp2_[logs[k] + roots_[i][k]] & masks[k];
+        }
+        syndromes[i] = s;
+    }
+    return 1;
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+cppecc_s32 RSCodec<N, K, Params>::berlekamp_massey(const cppecc_u8 syndromes[], cppecc_u8 sigma[]) const
+{
+    const RSField& field = Params::field;
+    cppecc_u8 b[N - K + 1] = {1};
+    cppecc_u8 t[N - K + 1];
+    for(cppecc_s32 j = 0; j <= NumSymbols; ++j) {
+        sigma[j] = 0 == j ? 1 : 0;
+    }
+    cppecc_s32 l = 0;
+    cppecc_s32 m = 1;
+    cppecc_u8 logB = 0;
+    for(cppecc_s32 n = 0; n < NumSymbols; ++n, ++m) {
+        cppecc_u8 d = syndromes[n];
+        for(cppecc_s32 j = 1; j <= l; ++j) {
+            d ^= gf_field_mul(&field, sigma[j], syndromes[n - j]);
+        }
+        if(0 == d) {
+            continue;
+        }
+        // sigma(x) -= d/b * x^m * b(x)
+        cppecc_u8 scale = static_cast<cppecc_u8>((field.log_[d] + CPPECC_GF_NW1 - logB) % CPPECC_GF_NW1);
+        for(cppecc_s32 j = 0; j <= NumSymbols; ++j) {
+            t[j] = sigma[j];
+        }
+        for(cppecc_s32 j = m; j <= NumSymbols; ++j) {
+            if(0 != b[j - m]) {
+                sigma[j] ^= exp2_[field.log_[b[j - m]] + scale];
+            }
+        }
+        if(2 * l <= n) {
+            l = n + 1 - l;
+            for(cppecc_s32 j = 0; j <= NumSymbols; ++j) {
+                b[j] = t[j];
+            }
+            logB = field.log_[d];
+            m = 0;
+        }
+    }
+    if(MaxErrors < l || 0 == sigma[l]) {
+        return CPPECC_ERROR;
+    }
+    return l + 1;
+}
+
+// Terms of sigma at beta^-i are kept as logs, a step to the next position subtracts j from the log of term j
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+cppecc_s32 RSCodec<N, K, Params>::chien_search(cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_u8 positions[]) const
+{
+    const RSField& field = Params::field;
+    cppecc_s32 logs[MaxErrors + 1];
+    cppecc_u8 masks[MaxErrors + 1];
+    for(cppecc_s32 j = 1; j <= MaxErrors; ++j) {
+        bool term = j < numSigma && 0 != sigma[j];
+        logs[j] = term ? field.log_[sigma[j]] : 0;
+        masks[j] = term ? 0xFFU : 0;
+    }
+    cppecc_s32 numErrors = numSigma - 1;
+    cppecc_s32 found = 0;
+    for(cppecc_s32 i = 0; i < N; ++i) {
+        cppecc_u8 value = 1;
+        for(cppecc_s32 j = 1; j <= MaxErrors; ++j) {
+            value ^= exp2_[logs[j]] & masks[j];
+            logs[j] -= j;
+            logs[j] += logs[j] < 0 ? static_cast<cppecc_s32>(CPPECC_GF_NW1) : 0;
+        }
+        if(0 == value) {
+            positions[found++] = field.exp_[i];
+            if(numErrors == found) {
+                return found;
+            }
+        }
+    }
+    return CPPECC_ERROR;
+}
+
+// Y = X^(1-fcr) * omega(X^-1) / sigma'(X^-1), the same as rs_field_error_correct_forney. The degrees of omega and sigma are bounded by MaxErrors.
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+cppecc_s32 RSCodec<N, K, Params>::forney(const cppecc_u8 syndromes[], const cppecc_u8 sigma[], cppecc_s32 numErrors, const cppecc_u8 positions[], cppecc_u8 codeword[]) const
+{
+    const RSField& field = Params::field;
+    // omega = syndromes * sigma mod x^numErrors
+    cppecc_s32 omegaLogs[MaxErrors];
+    cppecc_u8 omegaMasks[MaxErrors];
+    for(cppecc_s32 k = 0; k < MaxErrors; ++k) {
+        cppecc_u8 o = 0;
+        for(cppecc_s32 j = 0; j <= k; ++j) {
+            o ^= gf_field_mul(&field, sigma[j], syndromes[k - j]);
+        }
+        omegaLogs[k] = field.log_[o];
+        omegaMasks[k] = (0 == o || numErrors <= k) ? 0 : 0xFFU;
+    }
+    cppecc_s32 sigmaLogs[MaxErrors + 1];
+    cppecc_u8 sigmaMasks[MaxErrors + 1];
+    for(cppecc_s32 j = 0; j <= MaxErrors; ++j) {
+        sigmaLogs[j] = field.log_[sigma[j]];
+        sigmaMasks[j] = (1 == (j & 1) && 0 != sigma[j]) ? 0xFFU : 0;
+    }
+
+    const cppecc_s32 order = static_cast<cppecc_s32>(CPPECC_GF_NW1);
+    const cppecc_s32 power = static_cast<cppecc_s32>((CPPECC_GF_NW - field.fcr_) % CPPECC_GF_NW1);
+    cppecc_u8 values[MaxErrors];
+    for(cppecc_s32 i = 0; i < numErrors; ++i) {
+        cppecc_s32 x = field.log_[positions[i]];
+        cppecc_s32 l = (order - x) % order;
+        cppecc_u8 o = 0;
+        cppecc_u8 d = 0;
+        cppecc_s32 w = 0; // l*k
+        cppecc_s32 v = 0; // l*(k-1), and 0 for the constant term
+        for(cppecc_s32 k = 0; k <= MaxErrors; ++k) {
+            // Term k of omega is at X^-k, and odd term k of sigma is at X^-(k-1) in the derivative
+            o ^= k < MaxErrors ? (exp2_[omegaLogs[k] + w] & omegaMasks[k]) : 0;
+            d ^= exp2_[sigmaLogs[k] + v] & sigmaMasks[k];
+            v = w;
+            w += l;
+            w -= order <= w ? order : 0;
+        }
+        if(0 == d) {
+            return CPPECC_ERROR;
+        }
+        values[i] = 0 == o ? 0 : exp2_[(field.log_[o] + order - field.log_[d]) % order + (x * power) % order];
+    }
+    for(cppecc_s32 i = 0; i < numErrors; ++i) {
+        codeword[N - 1 - field.log_[positions[i]]] ^= values[i];
+    }
+    return numErrors;
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+cppecc_s32 RSCodec<N, K, Params>::decode(cppecc_u8 codeword[N]) const
+{
+    cppecc_u8 s[N - K];
+    if(0 == syndromes(codeword, s)) {
+        return 0;
+    }
+    cppecc_u8 sigma[N - K + 1];
+    cppecc_s32 numSigma = berlekamp_massey(s, sigma);
+    if(numSigma <= 1) {
+        return CPPECC_ERROR;
+    }
+    cppecc_u8 positions[MaxErrors];
+    if(chien_search(numSigma, sigma, positions) < 0) {
+        return CPPECC_ERROR;
+    }
+    return forney(s, sigma, numSigma - 1, positions, codeword);
+}
+
+typedef RSCodec<255, 223, RSFieldParams<0x187U, 112, 11> > RSCodecCCSDS; //!< rs_profile_ccsds in the conventional basis, convert symbols with rs_convert_basis for the dual basis
+typedef RSCodec<204, 188> RSCodecDVB; //!< rs_profile_dvb
+#endif
+
+#if defined(__cplusplus) && (201103L <= __cplusplus || 1900 <= _MSC_VER) && defined(CPPECC_ENABLE_THREADS)
+/**
+ @brief Throughput of RSEngine::benchmark in MB/s of the original buffer.
+ */
+struct RSEngineBenchmark
+{
+    cppecc_s32 numThreads_;
+    cppecc_f64 encode_;
+    cppecc_f64 check_;
+    cppecc_f64 decode_;
+};
+
+/**
+ @brief Thread pool which encodes, checks and decodes buffers of rs_encode_buffer's layouts on all cores. Define CPPECC_ENABLE_THREADS to use this.
+
+ Blocks are grouped into chunks, and each worker is dealt a contiguous run of chunks.
+ A worker takes chunks from the front of its own queue, and steals from the back of other queues when its own is empty.
+ The context is shared read only, and each worker has its own RSScratch. The calling thread works as the first worker.
+ Calls from several threads are serialized, one buffer runs on the workers at a time.
+ */
+class RSEngine
+{
+public:
+    /**
+     @param [in] context ... shared by workers, it should live longer than the engine. Calls take the numSymbols of the context.
+     @param numThreads ... number of workers including the calling thread, 0 is the number of hardware threads.
+     @param chunkBlocks ... number of blocks in a chunk, that is the unit of stealing.
+     */
+    explicit RSEngine(const RSContext* context, cppecc_s32 numThreads = 0, cppecc_s32 chunkBlocks = 256);
+    ~RSEngine();
+
+    cppecc_s32 num_threads() const;
+
+    /**
+     @brief Same as rs_encode_buffer.
+     */
+    void encode(cppecc_size_t size, const cppecc_u8 data[], cppecc_u8 output[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout);
+
+    /**
+     @brief Same as rs_check_buffer.
+     */
+    cppecc_s32 check(cppecc_size_t size, const cppecc_u8 data[], const cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[]);
+
+    /**
+     @brief Same as rs_decode_buffer.
+     */
+    cppecc_s32 decode(cppecc_size_t size, cppecc_u8 data[], cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[]);
+
+    /**
+     @brief Measure throughput with a random buffer. One of every 64 blocks is corrupted before decoding.
+     @param iterations ... The result is the average.
+     */
+    RSEngineBenchmark benchmark(cppecc_size_t size, cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 iterations);
+
+#    if defined(CPPECC_ENABLE_STATS)
+    /**
+     @brief Sum of counters of all workers, take them between calls.
+     */
+    void stats(RSStats* result) const;
+    void reset_stats();
+
+    /**
+     @brief Set a callback for all workers, that is called from the workers' threads.
+     */
+    void set_callback(cppecc_error_callback callback, void* user);
+#    endif
+
+private:
+    RSEngine(const RSEngine&) = delete;
+    RSEngine& operator=(const RSEngine&) = delete;
+
+    typedef std::function<void(RSScratch*, cppecc_size_t, cppecc_size_t)> Task;
+
+    struct Chunk
+    {
+        cppecc_size_t begin_;
+        cppecc_size_t end_;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex_;
+        std::deque<Chunk> chunks_;
+        RSScratch scratch_;
+        std::thread thread_;
+    };
+
+    void run(cppecc_size_t numBlocks, const Task& task);
+    void stop();
+    void loop(cppecc_s32 index);
+    void work(cppecc_s32 index);
+    bool take(cppecc_s32 index, Chunk& chunk);
+
+    const RSContext* context_;
+    cppecc_s32 chunkBlocks_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex runMutex_; //!< held by run, the queues, task_ and the first worker's scratch belong to one caller
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const Task* task_;
+    cppecc_u64 generation_;
+    cppecc_s32 numBusy_;
+    bool quit_;
+};
+#endif
+
+CPPECC_NAMESPACE_END(cppecc)
+#endif // INC_CPPECC_H_
+
+#ifdef CPPECC_IMPLEMENTATION
+
+// The lock of the code registry yields to its holder, which may be building tables
+#if defined(_WIN32)
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#    define CPPECC_YIELD() SwitchToThread()
+#else
+#    include <sched.h>
+#    define CPPECC_YIELD() sched_yield()
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#    define CPPECC_PAUSE() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#    define CPPECC_PAUSE() __builtin_ia32_pause()
+#else
+#    define CPPECC_PAUSE()
+#endif
+
+CPPECC_NAMESPACE_BEGIN(cppecc)
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+// clang-format off
+static const CPPECC_STRUCT RSField gfdefault={
+    {
+        0x0U,0x0U,0x1U,0x19U,0x2U,0x32U,0x1AU,0xC6U,0x3U,0xDFU,0x33U,0xEEU,0x1BU,0x68U,0xC7U,0x4BU,
+        0x4U,0x64U,0xE0U,0xEU,0x34U,0x8DU,0xEFU,0x81U,0x1CU,0xC1U,0x69U,0xF8U,0xC8U,0x8U,0x4CU,0x71U,
+        0x5U,0x8AU,0x65U,0x2FU,0xE1U,0x24U,0xFU,0x21U,0x35U,0x93U,0x8EU,0xDAU,0xF0U,0x12U,0x82U,0x45U,
+        0x1DU,0xB5U,0xC2U,0x7DU,0x6AU,0x27U,0xF9U,0xB9U,0xC9U,0x9AU,0x9U,0x78U,0x4DU,0xE4U,0x72U,0xA6U,
+        0x6U,0xBFU,0x8BU,0x62U,0x66U,0xDDU,0x30U,0xFDU,0xE2U,0x98U,0x25U,0xB3U,0x10U,0x91U,0x22U,0x88U,
+        0x36U,0xD0U,0x94U,0xCEU,0x8FU,0x96U,0xDBU,0xBDU,0xF1U,0xD2U,0x13U,0x5CU,0x83U,0x38U,0x46U,0x40U,
+        0x1EU,0x42U,0xB6U,0xA3U,0xC3U,0x48U,0x7EU,0x6EU,0x6BU,0x3AU,0x28U,0x54U,0xFAU,0x85U,0xBAU,0x3DU,
+        0xCAU,0x5EU,0x9BU,0x9FU,0xAU,0x15U,0x79U,0x2BU,0x4EU,0xD4U,0xE5U,0xACU,0x73U,0xF3U,0xA7U,0x57U,
+        0x7U,0x70U,0xC0U,0xF7U,0x8CU,0x80U,0x63U,0xDU,0x67U,0x4AU,0xDEU,0xEDU,0x31U,0xC5U,0xFEU,0x18U,
+        0xE3U,0xA5U,0x99U,0x77U,0x26U,0xB8U,0xB4U,0x7CU,0x11U,0x44U,0x92U,0xD9U,0x23U,0x20U,0x89U,0x2EU,
+        0x37U,0x3FU,0xD1U,0x5BU,0x95U,0xBCU,0xCFU,0xCDU,0x90U,0x87U,0x97U,0xB2U,0xDCU,0xFCU,0xBEU,0x61U,
+        0xF2U,0x56U,0xD3U,0xABU,0x14U,0x2AU,0x5DU,0x9EU,0x84U,0x3CU,0x39U,0x53U,0x47U,0x6DU,0x41U,0xA2U,
+        0x1FU,0x2DU,0x43U,0xD8U,0xB7U,0x7BU,0xA4U,0x76U,0xC4U,0x17U,0x49U,0xECU,0x7FU,0xCU,0x6FU,0xF6U,
+        0x6CU,0xA1U,0x3BU,0x52U,0x29U,0x9DU,0x55U,0xAAU,0xFBU,0x60U,0x86U,0xB1U,0xBBU,0xCCU,0x3EU,0x5AU,
+        0xCBU,0x59U,0x5FU,0xB0U,0x9CU,0xA9U,0xA0U,0x51U,0xBU,0xF5U,0x16U,0xEBU,0x7AU,0x75U,0x2CU,0xD7U,
+        0x4FU,0xAEU,0xD5U,0xE9U,0xE6U,0xE7U,0xADU,0xE8U,0x74U,0xD6U,0xF4U,0xEAU,0xA8U,0x50U,0x58U,0xAFU,
+    },
+    {
+        0x1U,0x2U,0x4U,0x8U,0x10U,0x20U,0x40U,0x80U,0x1DU,0x3AU,0x74U,0xE8U,0xCDU,0x87U,0x13U,0x26U,
+        0x4CU,0x98U,0x2DU,0x5AU,0xB4U,0x75U,0xEAU,0xC9U,0x8FU,0x3U,0x6U,0xCU,0x18U,0x30U,0x60U,0xC0U,
+        0x9DU,0x27U,0x4EU,0x9CU,0x25U,0x4AU,0x94U,0x35U,0x6AU,0xD4U,0xB5U,0x77U,0xEEU,0xC1U,0x9FU,0x23U,
+        0x46U,0x8CU,0x5U,0xAU,0x14U,0x28U,0x50U,0xA0U,0x5DU,0xBAU,0x69U,0xD2U,0xB9U,0x6FU,0xDEU,0xA1U,
+        0x5FU,0xBEU,0x61U,0xC2U,0x99U,0x2FU,0x5EU,0xBCU,0x65U,0xCAU,0x89U,0xFU,0x1EU,0x3CU,0x78U,0xF0U,
+        0xFDU,0xE7U,0xD3U,0xBBU,0x6BU,0xD6U,0xB1U,0x7FU,0xFEU,0xE1U,0xDFU,0xA3U,0x5BU,0xB6U,0x71U,0xE2U,
+        0xD9U,0xAFU,0x43U,0x86U,0x11U,0x22U,0x44U,0x88U,0xDU,0x1AU,0x34U,0x68U,0xD0U,0xBDU,0x67U,0xCEU,
+        0x81U,0x1FU,0x3EU,0x7CU,0xF8U,0xEDU,0xC7U,0x93U,0x3BU,0x76U,0xECU,0xC5U,0x97U,0x33U,0x66U,0xCCU,
+        0x85U,0x17U,0x2EU,0x5CU,0xB8U,0x6DU,0xDAU,0xA9U,0x4FU,0x9EU,0x21U,0x42U,0x84U,0x15U,0x2AU,0x54U,
+        0xA8U,0x4DU,0x9AU,0x29U,0x52U,0xA4U,0x55U,0xAAU,0x49U,0x92U,0x39U,0x72U,0xE4U,0xD5U,0xB7U,0x73U,
+        0xE6U,0xD1U,0xBFU,0x63U,0xC6U,0x91U,0x3FU,0x7EU,0xFCU,0xE5U,0xD7U,0xB3U,0x7BU,0xF6U,0xF1U,0xFFU,
+        0xE3U,0xDBU,0xABU,0x4BU,0x96U,0x31U,0x62U,0xC4U,0x95U,0x37U,0x6EU,0xDCU,0xA5U,0x57U,0xAEU,0x41U,
+        0x82U,0x19U,0x32U,0x64U,0xC8U,0x8DU,0x7U,0xEU,0x1CU,0x38U,0x70U,0xE0U,0xDDU,0xA7U,0x53U,0xA6U,
+        0x51U,0xA2U,0x59U,0xB2U,0x79U,0xF2U,0xF9U,0xEFU,0xC3U,0x9BU,0x2BU,0x56U,0xACU,0x45U,0x8AU,0x9U,
+        0x12U,0x24U,0x48U,0x90U,0x3DU,0x7AU,0xF4U,0xF5U,0xF7U,0xF3U,0xFBU,0xEBU,0xCBU,0x8BU,0xBU,0x16U,
+        0x2CU,0x58U,0xB0U,0x7DU,0xFAU,0xE9U,0xCFU,0x83U,0x1BU,0x36U,0x6CU,0xD8U,0xADU,0x47U,0x8EU,0x1U,
+    },
+    0x11DU,
+    0,
+    1,
+};
+
+// CCSDS 131.0-B, 0x187 with the roots beta^(112+i), beta = alpha^11
+static const CPPECC_STRUCT RSField gfccsds={
+    {
+        0x0U,0x0U,0x74U,0x9U,0xE8U,0x12U,0x7DU,0x38U,0x5DU,0x41U,0x86U,0x85U,0xF1U,0x51U,0xACU,0x1BU,
+        0xD1U,0x24U,0xB5U,0x7BU,0xFAU,0x70U,0xF9U,0x5AU,0x66U,0x88U,0xC5U,0x4AU,0x21U,0x8EU,0x8FU,0x8AU,
+        0x46U,0x93U,0x98U,0x89U,0x2AU,0x3EU,0xEFU,0x97U,0x6FU,0xB6U,0xE4U,0x91U,0x6EU,0x53U,0xCEU,0xE1U,
+        0xDAU,0xBDU,0xFCU,0x2DU,0x3AU,0x84U,0xBEU,0x1CU,0x95U,0x63U,0x3U,0x30U,0x4U,0xE9U,0xFEU,0x79U,
+        0xBAU,0x82U,0x8U,0xD3U,0xDU,0xBU,0xFDU,0xF2U,0x9EU,0x40U,0xB2U,0x6CU,0x64U,0x39U,0xCU,0xC0U,
+        0xE3U,0xA2U,0x2BU,0xC6U,0x59U,0x36U,0x6U,0x60U,0xE2U,0x25U,0xC7U,0x45U,0x43U,0xC2U,0x56U,0x8DU,
+        0x4FU,0x20U,0x32U,0x9CU,0x71U,0x92U,0xA1U,0x61U,0xAEU,0xA0U,0xF8U,0xA8U,0x33U,0x44U,0x90U,0x47U,
+        0xAU,0xEAU,0xD7U,0x83U,0x77U,0xDDU,0xA4U,0x5CU,0x78U,0xB3U,0x5EU,0xBFU,0x73U,0x9AU,0xEDU,0xD6U,
+        0x2FU,0xDFU,0xF6U,0x6BU,0x7CU,0x54U,0x48U,0xA3U,0x81U,0x18U,0x7FU,0xBCU,0x72U,0xC8U,0x67U,0xF0U,
+        0x13U,0x31U,0xB4U,0xF3U,0x27U,0x8CU,0xE0U,0xF5U,0xD8U,0x65U,0xADU,0xDBU,0x80U,0x3DU,0x35U,0xE6U,
+        0x58U,0x68U,0x17U,0x29U,0x9FU,0xA5U,0x3BU,0x87U,0xCDU,0x6AU,0xAAU,0x55U,0x7AU,0x1U,0xD4U,0x9BU,
+        0x57U,0x50U,0x99U,0x22U,0x3CU,0xD9U,0xB9U,0x4DU,0xB7U,0x5BU,0x37U,0xA9U,0xCAU,0xB1U,0x2U,0xF4U,
+        0xC3U,0x9DU,0x94U,0x8BU,0xA6U,0xDCU,0x11U,0xCCU,0xE5U,0xFBU,0x7U,0xAFU,0x16U,0x1AU,0xD5U,0x14U,
+        0x23U,0xC9U,0x15U,0x1FU,0x6DU,0xDEU,0x1DU,0x42U,0xA7U,0x10U,0xB8U,0x49U,0x5U,0x75U,0xBBU,0xEEU,
+        0x7EU,0x96U,0x5FU,0xEU,0x4CU,0xC4U,0xF7U,0xCBU,0xEBU,0xC1U,0x52U,0x2EU,0x19U,0x4EU,0xD0U,0xB0U,
+        0xECU,0x1EU,0x28U,0xABU,0xD2U,0xCFU,0x34U,0x2CU,0xE7U,0x69U,0xFU,0x76U,0x62U,0x26U,0x4BU,0x3FU,
+    },
+    {
+        0x1U,0xADU,0xBEU,0x3AU,0x3CU,0xDCU,0x56U,0xCAU,0x42U,0x3U,0x70U,0x45U,0x4EU,0x44U,0xE3U,0xFAU,
+        0xD9U,0xC6U,0x5U,0x90U,0xCFU,0xD2U,0xCCU,0xA2U,0x89U,0xECU,0xCDU,0xFU,0x37U,0xD6U,0xF1U,0xD3U,
+        0x61U,0x1CU,0xB3U,0xD0U,0x11U,0x59U,0xFDU,0x94U,0xF2U,0xA3U,0x24U,0x52U,0xF7U,0x33U,0xEBU,0x80U,
+        0x3BU,0x91U,0x62U,0x6CU,0xF6U,0x9EU,0x55U,0xBAU,0x7U,0x4DU,0x34U,0xA6U,0xB4U,0x9DU,0x25U,0xFFU,
+        0x49U,0x9U,0xD7U,0x5CU,0x6DU,0x5BU,0x20U,0x6FU,0x86U,0xDBU,0x1BU,0xFEU,0xE4U,0xB7U,0xEDU,0x60U,
+        0xB1U,0xDU,0xEAU,0x2DU,0x85U,0xABU,0x5EU,0xB0U,0xA0U,0x54U,0x17U,0xB9U,0x77U,0x8U,0x7AU,0xE2U,
+        0x57U,0x67U,0xFCU,0x39U,0x4CU,0x99U,0x18U,0x8EU,0xA1U,0xF9U,0xA9U,0x83U,0x4BU,0xD4U,0x2CU,0x28U,
+        0x15U,0x64U,0x8CU,0x7CU,0x2U,0xDDU,0xFBU,0x74U,0x78U,0x3FU,0xACU,0x13U,0x84U,0x6U,0xE0U,0x8AU,
+        0x9CU,0x88U,0x41U,0x73U,0x35U,0xBU,0xAU,0xA7U,0x19U,0x23U,0x1FU,0xC3U,0x95U,0x5FU,0x1DU,0x1EU,
+        0x6EU,0x2BU,0x65U,0x21U,0xC2U,0x38U,0xE1U,0x27U,0x22U,0xB2U,0x7DU,0xAFU,0x63U,0xC1U,0x48U,0xA4U,
+        0x69U,0x66U,0x51U,0x87U,0x76U,0xA5U,0xC4U,0xD8U,0x6BU,0xBBU,0xAAU,0xF3U,0xEU,0x9AU,0x68U,0xCBU,
+        0xEFU,0xBDU,0x4AU,0x79U,0x92U,0x12U,0x29U,0xB8U,0xDAU,0xB6U,0x40U,0xDEU,0x8BU,0x31U,0x36U,0x7BU,
+        0x4FU,0xE9U,0x5DU,0xC0U,0xE5U,0x1AU,0x53U,0x5AU,0x8DU,0xD1U,0xBCU,0xE7U,0xC7U,0xA8U,0x2EU,0xF5U,
+        0xEEU,0x10U,0xF4U,0x43U,0xAEU,0xCEU,0x7FU,0x72U,0x98U,0xB5U,0x30U,0x9BU,0xC5U,0x75U,0xD5U,0x81U,
+        0x96U,0x2FU,0x58U,0x50U,0x2AU,0xC8U,0x9FU,0xF8U,0x4U,0x3DU,0x71U,0xE8U,0xF0U,0x7EU,0xDFU,0x26U,
+        0x8FU,0xCU,0x47U,0x93U,0xBFU,0x97U,0x82U,0xE6U,0x6AU,0x16U,0x14U,0xC9U,0x32U,0x46U,0x3EU,0x1U,
+    },
+    0x187U,
+    112,
+    11,
+};
+
+// Berlekamp's dual basis of CCSDS, rows of the transformation matrix T for low and high nibbles
+static const cppecc_u8 gfccsdstodual[32]={
+        0x0U,0x7BU,0xAFU,0xD4U,0x99U,0xE2U,0x36U,0x4DU,0xFAU,0x81U,0x55U,0x2EU,0x63U,0x18U,0xCCU,0xB7U,
+        0x0U,0x86U,0xECU,0x6AU,0xEFU,0x69U,0x3U,0x85U,0x8DU,0xBU,0x61U,0xE7U,0x62U,0xE4U,0x8EU,0x8U,
+};
+static const cppecc_u8 gfccsdsfromdual[32]={
+        0x0U,0xCCU,0xACU,0x60U,0x79U,0xB5U,0xD5U,0x19U,0xF0U,0x3CU,0x5CU,0x90U,0x89U,0x45U,0x25U,0xE9U,
+        0x0U,0xFDU,0x2EU,0xD3U,0x42U,0xBFU,0x6CU,0x91U,0xC5U,0x38U,0xEBU,0x16U,0x87U,0x7AU,0xA9U,0x54U,
+};
+// clang-format on
+
+CPPECC_NAMESPACE_EMPTY_END
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+CPPECC_STATIC cppecc_size_t rs_align_line(cppecc_size_t size)
+{
+    return (size + 63) & ~CPPECC_STATIC_CAST(cppecc_size_t)(63);
+}
+
+#if defined(CPPECC_KERNEL_GFNI)
+/**
+ @brief Bit matrix of GF2P8AFFINEQB for a linear map over GF(2), bit j of an input selects columns[j].
+
+ The instruction takes the row for the output bit i from the byte 7-i.
+ */
+CPPECC_STATIC cppecc_u64 gf_bit_matrix(const cppecc_u8 columns[8])
+{
+    cppecc_u64 matrix = 0;
+    for(cppecc_u32 j = 0; j < 8; ++j) {
+        for(cppecc_u32 i = 0; i < 8; ++i) {
+            matrix |= CPPECC_STATIC_CAST(cppecc_u64)((columns[j] >> i) & 1U) << (8 * (7 - i) + j);
+        }
+    }
+    return matrix;
+}
+
+/**
+ @brief Bit matrix for the multiplication by x on the field of polynomial, multiplications by constants are linear over GF(2) on any field.
+ */
+CPPECC_STATIC cppecc_u64 gf_affine_matrix(cppecc_u32 polynomial, cppecc_u8 x)
+{
+    cppecc_u8 columns[8];
+    cppecc_u32 column = x;
+    for(cppecc_u32 j = 0; j < 8; ++j) {
+        columns[j] = CPPECC_STATIC_CAST(cppecc_u8)(column);
+        column <<= 1;
+        if(CPPECC_GF_NW <= column) {
+            column ^= polynomial;
+        }
+    }
+    return gf_bit_matrix(columns);
+}
+
+/**
+ @brief Product on the field of AES, 0x11B, which GF2P8MULB hard-wires.
+ */
+CPPECC_STATIC cppecc_u8 gf_aes_mul(cppecc_u8 a, cppecc_u8 b)
+{
+    cppecc_u32 result = 0;
+    cppecc_u32 x = a;
+    for(cppecc_u32 i = 0; i < 8; ++i) {
+        if(0 != ((b >> i) & 1U)) {
+            result ^= x;
+        }
+        x <<= 1;
+        if(CPPECC_GF_NW <= x) {
+            x ^= 0x11BU;
+        }
+    }
+    return CPPECC_STATIC_CAST(cppecc_u8)(result);
+}
+
+/**
+ @brief Image of a by the linear map over GF(2), which maps bit j to columns[j].
+ */
+CPPECC_STATIC cppecc_u8 gf_bit_map(const cppecc_u8 columns[8], cppecc_u8 a)
+{
+    cppecc_u8 image = 0;
+    for(cppecc_u32 j = 0; j < 8; ++j) {
+        image ^= (0 != ((a >> j) & 1U)) ? columns[j] : 0;
+    }
+    return image;
+}
+
+/**
+ @brief Columns of an isomorphism from the field of polynomial to the field of AES, and of its inverse.
+
+ All fields of 256 elements are isomorphic. alpha is mapped to a root of polynomial in the field of AES, and the images of alpha^j are the columns.
+ Products of mapped symbols are GF2P8MULB, and they are mapped back to the same products on the original field.
+ */
+CPPECC_STATIC void gf_aes_isomorphism(cppecc_u32 polynomial, cppecc_u8 columns[8], cppecc_u8 inverse[8])
+{
+    for(cppecc_u32 j = 0; j < 8; ++j) {
+        columns[j] = inverse[j] = 0;
+    }
+    for(cppecc_u32 g = 2; g < CPPECC_GF_NW; ++g) {
+        cppecc_u8 y = 0;
+        for(cppecc_s32 k = 8; 0 <= k; --k) {
+            y = gf_aes_mul(y, CPPECC_STATIC_CAST(cppecc_u8)(g)) ^ CPPECC_STATIC_CAST(cppecc_u8)((polynomial >> k) & 1U);
+        }
+        if(0 == y) {
+            columns[0] = 1;
+            for(cppecc_u32 j = 1; j < 8; ++j) {
+                columns[j] = gf_aes_mul(columns[j - 1], CPPECC_STATIC_CAST(cppecc_u8)(g));
+            }
+            break;
+        }
+    }
+    for(cppecc_u32 a = 1; a < CPPECC_GF_NW; ++a) {
+        cppecc_u8 image = gf_bit_map(columns, CPPECC_STATIC_CAST(cppecc_u8)(a));
+        for(cppecc_u32 j = 0; j < 8; ++j) {
+            if(image == (1U << j)) {
+                inverse[j] = CPPECC_STATIC_CAST(cppecc_u8)(a);
+            }
+        }
+    }
+}
+
+/**
+ @brief Build matrices of the isomorphism and of roots, and remainders of x^(numSymbols+e) for e < 16 in the field of AES.
+ */
+CPPECC_STATIC void rs_gfni_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, const cppecc_u8 generator[], cppecc_u64 isomorphism[2], cppecc_u64 roots[], cppecc_u8 rows[])
+{
+    cppecc_u8 columns[8];
+    cppecc_u8 inverse[8];
+    gf_aes_isomorphism(field->polynomial_, columns, inverse);
+    isomorphism[0] = gf_bit_matrix(columns);
+    isomorphism[1] = gf_bit_matrix(inverse);
+    cppecc_s32 numGroups = (numSymbols + 7) / 8;
+    for(cppecc_s32 i = 0; i < numGroups * 8; ++i) {
+        cppecc_u64* group = roots + (i / 8) * 32 + (i % 8);
+        if(numSymbols <= i) {
+            group[0] = group[8] = group[16] = group[24] = 0;
+            continue;
+        }
+        cppecc_u32 e = CPPECC_STATIC_CAST(cppecc_u32)(field->fcr_ + i) % CPPECC_GF_NW1;
+        group[0] = gf_affine_matrix(field->polynomial_, field->exp_[(8 * e) % CPPECC_GF_NW1]);
+        group[8] = gf_affine_matrix(field->polynomial_, field->exp_[e]);
+        group[16] = gf_affine_matrix(field->polynomial_, field->exp_[(2 * e) % CPPECC_GF_NW1]);
+        group[24] = gf_affine_matrix(field->polynomial_, field->exp_[(4 * e) % CPPECC_GF_NW1]);
+    }
+    // x^numSymbols mod generator is the generator without the leading term, and each next row is multiplied by x
+    cppecc_s32 stride = (numSymbols + 63) & ~63;
+    for(cppecc_s32 e = 0; e < 16; ++e) {
+        cppecc_u8* row = rows + e * stride;
+        for(cppecc_s32 k = 0; k < stride; ++k) {
+            row[k] = 0;
+        }
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            if(0 == e) {
+                row[k] = generator[k + 1];
+            } else {
+                const cppecc_u8* previous = row - stride;
+                cppecc_u8 next = ((k + 1) < numSymbols) ? previous[k + 1] : 0;
+                row[k] = next ^ gf_field_mul(field, previous[0], generator[k + 1]);
+            }
+        }
+    }
+    // Rows are multiplied in the field of AES, after all of them are made on this field
+    for(cppecc_s32 k = 0; k < 16 * stride; ++k) {
+        rows[k] = gf_bit_map(columns, rows[k]);
+    }
+}
+#endif
+
+//! Number of tables in a context, the generator, slices, nibbles, shuffles, powers, chien, the scratch, matrices, roots and rows of GFNI
+#define CPPECC_CONTEXT_TABLES (10)
+
+/**
+ @brief Layout of the tables of a context, rs_context_layout decides it from numSymbols and the bound kernels.
+ */
+struct RSContextLayout
+{
+    cppecc_s32 numSlices_;
+    cppecc_s32 numNibbles_;
+    cppecc_s32 stride_;
+    cppecc_s32 gfni_; //!< 1 if the tables of GFNI are made
+    cppecc_size_t offsets_[CPPECC_CONTEXT_TABLES]; //!< offsets of the tables from the first cache line of storage
+};
+
+/**
+ @brief Decide the tables of a context for the kernels of features, the ones which no compiled kernel takes are empty.
+ @return total size of the tables
+
+ Slicing tables grow with numSymbols times slices, so long codes have fewer slices to keep them about 128 KiB or less.
+ The vector kernels encode with nibbles_, then slices_ only serve short heads and have one slice. Short codes have one slice in any case,
+ that is 256 bytes for each redundant symbol. The tables of GFNI are made only for the GFNI kernels, which fall back to AVX2 without them.
+ */
+CPPECC_STATIC cppecc_size_t rs_context_layout(cppecc_s32 numSymbols, cppecc_u32 features, CPPECC_STRUCT RSContextLayout* layout)
+{
+    if(numSymbols <= 64) {
+        layout->numNibbles_ = CPPECC_MAX_SLICES;
+    } else {
+        layout->numNibbles_ = (numSymbols <= 128 && 4 <= CPPECC_MAX_SLICES) ? 4 : 1;
+    }
+    layout->numSlices_ = layout->numNibbles_;
+#if defined(CPPECC_KERNEL_SSSE3)
+    if(numSymbols <= 16 && 4 <= CPPECC_MAX_SLICES) {
+        layout->numNibbles_ = 4;
+    }
+    if(0 != (features & CPPECC_CPU_SSSE3)) {
+        layout->numSlices_ = 1;
+    }
+#else
+    (void)features;
+    layout->numNibbles_ = 0;
+#endif
+    if(numSymbols <= 16) {
+        layout->numSlices_ = 1;
+    }
+    layout->stride_ = (numSymbols <= 16) ? 16 : ((numSymbols + 31) & ~31);
+    cppecc_s32 numPowers = (numSymbols < CPPECC_MAX_SCAN_SIZE) ? numSymbols : CPPECC_MAX_SCAN_SIZE;
+    cppecc_size_t sizes[CPPECC_CONTEXT_TABLES];
+    sizes[0] = numSymbols + 1;
+    sizes[1] = layout->numSlices_ * CPPECC_GF_NW * numSymbols;
+#if defined(CPPECC_KERNEL_SSSE3)
+    sizes[2] = layout->numNibbles_ * 32 * layout->stride_;
+    sizes[3] = layout->stride_ * 32;
+    sizes[4] = numPowers * 6 * 32;
+#else
+    // Only the vector kernels take nibbles, shuffles and powers
+    (void)numPowers;
+    sizes[2] = sizes[3] = sizes[4] = 0;
+#endif
+    sizes[5] = numSymbols / 2 * 6 * 32;
+    sizes[6] = sizeof(CPPECC_STRUCT RSScratch);
+    layout->gfni_ = 0;
+    sizes[7] = sizes[8] = sizes[9] = 0;
+#if defined(CPPECC_KERNEL_GFNI)
+    if(0 != (features & CPPECC_CPU_GFNI)) {
+        layout->gfni_ = 1;
+        sizes[7] = 2 * 8;
+        sizes[8] = (numSymbols + 7) / 8 * 4 * 64;
+        sizes[9] = 16 * ((numSymbols + 63) & ~63);
+    }
+#endif
+    cppecc_size_t offset = 0;
+    for(cppecc_s32 i = 0; i < CPPECC_CONTEXT_TABLES; ++i) {
+        layout->offsets_[i] = offset;
+        offset += rs_align_line(sizes[i]);
+    }
+    return offset;
+}
+
+#if defined(CPPECC_KERNEL_SSSE3)
+/**
+ @brief Same as rs_nibble_tables, but rows of the next tables are made from the previous ones, so slices needs only the first table.
+ */
+CPPECC_STATIC void rs_nibble_rows(cppecc_s32 numSymbols, cppecc_s32 numNibbles, cppecc_s32 stride, cppecc_u8 result[], const cppecc_u8 slices[])
+{
+    rs_nibble_tables(numSymbols, 1, stride, result, slices);
+    // x*r(x) mod g(x), the coefficient which overflows is reduced with the first table of slices
+    for(cppecc_s32 e = 1; e < numNibbles; ++e) {
+        for(cppecc_s32 n = 0; n < 32; ++n) {
+            const cppecc_u8* prev = result + ((e - 1) * 32 + n) * stride;
+            const cppecc_u8* t = slices + prev[0] * numSymbols;
+            cppecc_u8* row = result + (e * 32 + n) * stride;
+            for(cppecc_s32 k = 0; k < (numSymbols - 1); ++k) {
+                row[k] = prev[k + 1] ^ t[k];
+            }
+            row[numSymbols - 1] = t[numSymbols - 1];
+            for(cppecc_s32 k = numSymbols; k < stride; ++k) {
+                row[k] = 0;
+            }
+        }
+    }
+}
+#endif
+
+/**
+ @brief Put tables in storage, that is 'rs_context_layout + 64' bytes.
+ */
+CPPECC_STATIC void rs_context_build(CPPECC_STRUCT RSContext* context, cppecc_u8* storage, const CPPECC_STRUCT RSContextLayout* layout, cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field)
+{
+    const cppecc_size_t* offsets = layout->offsets_;
+    cppecc_u8* base = storage + (rs_align_line(CPPECC_REINTERPRET_CAST(uintptr_t)(storage)) - CPPECC_REINTERPRET_CAST(uintptr_t)(storage));
+    context->field_ = field;
+    context->numSymbols_ = numSymbols;
+    context->numSlices_ = layout->numSlices_;
+    context->numNibbles_ = layout->numNibbles_;
+    context->stride_ = layout->stride_;
+    context->generator_ = base + offsets[0];
+    context->slices_ = base + offsets[1];
+    context->nibbles_ = base + offsets[2];
+    context->shuffles_ = base + offsets[3];
+    context->powers_ = base + offsets[4];
+    context->chien_ = base + offsets[5];
+    context->scratch_ = CPPECC_REINTERPRET_CAST(CPPECC_STRUCT RSScratch*)(base + offsets[6]);
+#if defined(CPPECC_KERNEL_GFNI)
+    context->isomorphism_ = (0 != layout->gfni_) ? CPPECC_REINTERPRET_CAST(cppecc_u64*)(base + offsets[7]) : CPPECC_NULL;
+    context->roots_ = (0 != layout->gfni_) ? CPPECC_REINTERPRET_CAST(cppecc_u64*)(base + offsets[8]) : CPPECC_NULL;
+    context->rows_ = (0 != layout->gfni_) ? base + offsets[9] : CPPECC_NULL;
+#endif
+    context->deltas_ = CPPECC_NULL;
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_reset(context->scratch_);
+#endif
+
+    rs_field_generator_poly(field, numSymbols, context->generator_, context->scratch_->temp0_);
+    rs_slice_tables(field, numSymbols, context->numSlices_, context->slices_, context->generator_);
+#if defined(CPPECC_KERNEL_SSSE3)
+    if(0 < numSymbols) {
+        rs_nibble_rows(numSymbols, context->numNibbles_, context->stride_, context->nibbles_, context->slices_);
+    }
+    rs_shuffle_tables(field, numSymbols, context->stride_, context->shuffles_, context->generator_);
+    rs_power_tables(field, (numSymbols < CPPECC_MAX_SCAN_SIZE) ? numSymbols : CPPECC_MAX_SCAN_SIZE, context->powers_);
+#endif
+    rs_chien_tables(field, numSymbols / 2, context->chien_);
+#if defined(CPPECC_KERNEL_GFNI)
+    if(0 != layout->gfni_) {
+        rs_gfni_tables(field, numSymbols, context->generator_, context->isomorphism_, context->roots_, context->rows_);
+    }
+#endif
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+//
+cppecc_s32 gf_initialize(CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols)
+{
+    return gf_initialize_field(context, numSymbols, &gfdefault);
+}
+
+cppecc_s32 gf_initialize_field(CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    CPPECC_ASSERT(0 <= numSymbols && numSymbols < CPPECC_MAX_BODY_SIZE);
+    CPPECC_STRUCT RSContextLayout layout;
+    context->allocation_ = CPPECC_MALLOC(64 + rs_context_layout(numSymbols, rs_selected_kernels(), &layout));
+    if(CPPECC_NULL == context->allocation_) {
+        return CPPECC_ERROR;
+    }
+    rs_context_build(context, CPPECC_STATIC_CAST(cppecc_u8*)(context->allocation_), &layout, numSymbols, field);
+    return 0;
+}
+
+void gf_terminate(CPPECC_STRUCT RSContext* context)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_FREE(context->allocation_);
+    CPPECC_FREE(context->deltas_);
+    context->allocation_ = CPPECC_NULL;
+    context->deltas_ = CPPECC_NULL;
+}
+
+cppecc_size_t rs_context_size(cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(0 <= numSymbols && numSymbols < CPPECC_MAX_BODY_SIZE);
+    CPPECC_STRUCT RSContextLayout layout;
+    return sizeof(CPPECC_STRUCT RSContext) + 64 + rs_context_layout(numSymbols, rs_selected_kernels(), &layout);
+}
+
+CPPECC_STRUCT RSContext* rs_context_create(void* arena, cppecc_size_t arenaSize, cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field)
+{
+    CPPECC_ASSERT(CPPECC_NULL != arena);
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    CPPECC_ASSERT(0 == (CPPECC_REINTERPRET_CAST(uintptr_t)(arena) % sizeof(void*)));
+    CPPECC_ASSERT(0 <= numSymbols && numSymbols < CPPECC_MAX_BODY_SIZE);
+    // The layout is decided once, the kernels may be bound again after rs_context_size
+    CPPECC_STRUCT RSContextLayout layout;
+    if(arenaSize < sizeof(CPPECC_STRUCT RSContext) + 64 + rs_context_layout(numSymbols, rs_selected_kernels(), &layout)) {
+        return CPPECC_NULL;
+    }
+    // The header is at the front, and the tables follow it
+    CPPECC_STRUCT RSContext* context = CPPECC_STATIC_CAST(CPPECC_STRUCT RSContext*)(arena);
+    context->allocation_ = CPPECC_NULL;
+    rs_context_build(context, CPPECC_STATIC_CAST(cppecc_u8*)(arena) + sizeof(CPPECC_STRUCT RSContext), &layout, numSymbols, field);
+    return context;
+}
+
+CPPECC_STRUCT RSContext* rs_context_alloc(cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field)
+{
+    cppecc_size_t size = rs_context_size(numSymbols);
+    void* arena = CPPECC_MALLOC(size);
+    if(CPPECC_NULL == arena) {
+        return CPPECC_NULL;
+    }
+    return rs_context_create(arena, size, numSymbols, field);
+}
+
+void rs_context_free(CPPECC_STRUCT RSContext* context)
+{
+    if(CPPECC_NULL != context) {
+        CPPECC_FREE(context->deltas_);
+    }
+    CPPECC_FREE(context);
+}
+
+const CPPECC_STRUCT RSField* gf_default_field(void)
+{
+    return &gfdefault;
+}
+
+cppecc_s32 gf_field_build(CPPECC_STRUCT RSField* field, cppecc_u32 polynomial, cppecc_s32 fcr, cppecc_s32 prim)
+{
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    if(polynomial < CPPECC_GF_NW || (CPPECC_GF_NW << 1) <= polynomial || prim <= 0 || fcr < 0) {
+        return CPPECC_ERROR;
+    }
+    // Powers of alpha cycle with the period 255 only if the polynomial is primitive
+    cppecc_u8 alpha[CPPECC_GF_NW1];
+    cppecc_u32 x = 1;
+    for(cppecc_u32 i = 0; i < CPPECC_GF_NW1; ++i) {
+        if(0 < i && 1 == x) {
+            return CPPECC_ERROR;
+        }
+        alpha[i] = CPPECC_STATIC_CAST(cppecc_u8)(x);
+        x <<= 1;
+        if(CPPECC_GF_NW <= x) {
+            x ^= polynomial;
+        }
+    }
+    // beta = alpha^prim is also a primitive element if prim is coprime with 255
+    cppecc_u32 spacing = CPPECC_STATIC_CAST(cppecc_u32)(prim) % CPPECC_GF_NW1;
+    field->log_[0] = 0;
+    for(cppecc_u32 i = 0; i < CPPECC_GF_NW1; ++i) {
+        cppecc_u8 b = alpha[(i * spacing) % CPPECC_GF_NW1];
+        if(0 < i && 1 == b) {
+            return CPPECC_ERROR;
+        }
+        field->exp_[i] = b;
+        field->log_[b] = CPPECC_STATIC_CAST(cppecc_u8)(i);
+    }
+    field->exp_[CPPECC_GF_NW1] = 1;
+    field->polynomial_ = polynomial;
+    field->fcr_ = fcr % CPPECC_STATIC_CAST(cppecc_s32)(CPPECC_GF_NW1);
+    field->prim_ = CPPECC_STATIC_CAST(cppecc_s32)(spacing);
+    return 0;
+}
+
+cppecc_u8 gf_add(cppecc_u8 a, cppecc_u8 b)
+{
+    return a ^ b;
+}
+
+//
+cppecc_u8 gf_field_mul(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b)
+{
+    if(0 == a || 0 == b) {
+        return 0;
+    }
+    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_s32)(field->log_[a]) + field->log_[b];
+    if(CPPECC_GF_NW1 <= sum) {
+        sum -= CPPECC_GF_NW1;
+    }
+    return field->exp_[sum];
+}
+
+cppecc_u8 gf_mul(cppecc_u8 a, cppecc_u8 b)
+{
+    return gf_field_mul(&gfdefault, a, b);
+}
+
+cppecc_u8 gf_mulexp(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b)
+{
+    if(0 == a) {
+        return 0;
+    }
+    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_s32)(field->log_[a]) + b;
+    if(CPPECC_GF_NW1 <= sum) {
+        sum -= CPPECC_GF_NW1;
+    }
+    return field->exp_[sum];
+}
+
+//
+cppecc_u8 gf_field_div(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b)
+{
+    if(0 == a) {
+        return 0;
+    }
+    if(0 == b) {
+        return CPPECC_STATIC_CAST(cppecc_u8)(-1);
+    }
+    cppecc_s32 diff = CPPECC_STATIC_CAST(cppecc_s32)(field->log_[a]) - field->log_[b];
+    if(diff < 0) {
+        diff += CPPECC_GF_NW1;
+    }
+    return field->exp_[diff];
+}
+
+cppecc_u8 gf_div(cppecc_u8 a, cppecc_u8 b)
+{
+    return gf_field_div(&gfdefault, a, b);
+}
+
+cppecc_u8 gf_divexp(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b)
+{
+    if(0 == a) {
+        return 0;
+    }
+    cppecc_s32 diff = CPPECC_STATIC_CAST(cppecc_s32)(field->log_[a]) - b;
+    if(diff < 0) {
+        diff += CPPECC_GF_NW1;
+    }
+    return field->exp_[diff];
+}
+
+cppecc_u8 gf_field_pow(const CPPECC_STRUCT RSField* field, cppecc_u8 x, cppecc_s32 p)
+{
+    return field->exp_[(field->log_[x] * p) % CPPECC_GF_NW1];
+}
+
+cppecc_u8 gf_pow(cppecc_u8 x, cppecc_s32 p)
+{
+    return gf_field_pow(&gfdefault, x, p);
+}
+
+cppecc_u8 gf_field_inverse(const CPPECC_STRUCT RSField* field, cppecc_u8 x)
+{
+    return field->exp_[CPPECC_GF_NW1 - field->log_[x]];
+}
+
+cppecc_u8 gf_inverse(cppecc_u8 x)
+{
+    return gf_field_inverse(&gfdefault, x);
+}
+
+void gf_field_poly_scale(const CPPECC_STRUCT RSField* field, cppecc_s32 size, cppecc_u8 result[], const cppecc_u8 p[], cppecc_u8 x)
+{
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        result[i] = gf_field_mul(field, p[i], x);
+    }
+}
+
+void gf_poly_scale(cppecc_s32 size, cppecc_u8 result[], const cppecc_u8 p[], cppecc_u8 x)
+{
+    gf_field_poly_scale(&gfdefault, size, result, p, x);
+}
+
+cppecc_s32 gf_poly_add(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[])
+{
+    cppecc_s32 size = (psize < qsize) ? qsize : psize;
+    cppecc_s32 d = (psize < qsize) ? qsize - psize : 0;
+    for(cppecc_s32 i = 0; i < d; ++i) {
+        result[i] = 0;
+    }
+
+    for(cppecc_s32 i = 0; i < psize; ++i) {
+        result[i + size - psize] = p[i];
+    }
+
+    for(cppecc_s32 i = 0; i < qsize; ++i) {
+        result[i + size - qsize] ^= q[i];
+    }
+    return size;
+}
+
+cppecc_s32 gf_field_poly_mul(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[])
+{
+    cppecc_s32 total = psize + qsize - 1;
+    for(cppecc_s32 i = 0; i < total; ++i) {
+        result[i] = 0;
+    }
+    for(cppecc_s32 i = 0; i < qsize; ++i) {
+        for(cppecc_s32 j = 0; j < psize; ++j) {
+            result[i + j] ^= gf_field_mul(field, p[j], q[i]);
+        }
+    }
+    return total;
+}
+
+cppecc_s32 gf_poly_mul(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[])
+{
+    return gf_field_poly_mul(&gfdefault, result, psize, p, qsize, q);
+}
+
+cppecc_s32 gf_field_poly_mul_len(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[], cppecc_s32 l)
+{
+    cppecc_s32 total = l;
+    for(cppecc_s32 i = 0; i < total; ++i) {
+        result[i] = 0;
+    }
+    psize = (psize < l) ? psize : l;
+    for(cppecc_s32 i = 0; i < psize; ++i) {
+        if(0 == p[i]) {
+            continue;
+        }
+        cppecc_u8 logp = field->log_[p[i]];
+        cppecc_s32 qs = l - i;
+        qs = qsize < qs ? qsize : qs;
+        for(cppecc_s32 j = 0; j < qs; ++j) {
+            if(0 == q[j]) {
+                continue;
+            }
+            result[i + j] ^= gf_mulexp(field, q[j], logp);
+        }
+    }
+    return total;
+}
+
+cppecc_s32 gf_poly_mul_len(cppecc_u8 result[], cppecc_s32 psize, const cppecc_u8 p[], cppecc_s32 qsize, const cppecc_u8 q[], cppecc_s32 l)
+{
+    return gf_field_poly_mul_len(&gfdefault, result, psize, p, qsize, q, l);
+}
+
+cppecc_u8 gf_field_poly_eval(const CPPECC_STRUCT RSField* field, cppecc_s32 size, const cppecc_u8 poly[], cppecc_u8 x)
+{
+    cppecc_u8 y = poly[0];
+    for(cppecc_s32 i = 1; i < size; ++i) {
+        y = gf_field_mul(field, y, x) ^ poly[i];
+    }
+    return y;
+}
+
+cppecc_u8 gf_poly_eval(cppecc_s32 size, const cppecc_u8 poly[], cppecc_u8 x)
+{
+    return gf_field_poly_eval(&gfdefault, size, poly, x);
+}
+
+cppecc_s32 gf_field_poly_div(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 sizeDividend, const cppecc_u8 dividend[], cppecc_s32 sizeDivisor, const cppecc_u8 divisor[])
+{
+    for(cppecc_s32 i = 0; i < sizeDividend; ++i) {
+        result[i] = dividend[i];
+    }
+    cppecc_s32 size = sizeDividend - sizeDivisor + 1;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        cppecc_u8 coef = result[i];
+        if(0 != coef) {
+            for(cppecc_s32 j = 1; j < sizeDivisor; ++j) {
+                if(0 != divisor[j]) {
+                    result[i + j] ^= gf_field_mul(field, divisor[j], coef);
+                }
+            }
+        }
+    }
+
+    cppecc_s32 sizeResult = sizeDividend - size;
+    for(cppecc_s32 i = 0; i < sizeResult; ++i) {
+        result[i] = result[i + size];
+    }
+    return sizeResult;
+}
+
+cppecc_s32 gf_poly_div(cppecc_u8 result[], cppecc_s32 sizeDividend, const cppecc_u8 dividend[], cppecc_s32 sizeDivisor, const cppecc_u8 divisor[])
+{
+    return gf_field_poly_div(&gfdefault, result, sizeDividend, dividend, sizeDivisor, divisor);
+}
+
+cppecc_u8 gf_omega_value(const CPPECC_STRUCT RSField* field, cppecc_s32 numOmega, const cppecc_u8 omega[], cppecc_u8 l)
+{
+    cppecc_u8 w = l;
+    cppecc_u8 o = omega[0];
+    for(cppecc_s32 i = 1; i < numOmega; i++) {
+        o ^= gf_mulexp(field, omega[i], w);
+        w = (w + l) % CPPECC_GF_NW1;
+    }
+    return o;
+}
+
+cppecc_u8 gf_sigma_dash_value(const CPPECC_STRUCT RSField* field, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_u8 l)
+{
+    cppecc_s32 size = numSigma - 1;
+    cppecc_u8 l2 = (2 * l) % CPPECC_GF_NW1;
+    cppecc_u8 w = l2;
+    cppecc_u8 d = sigma[1];
+    for(cppecc_s32 i = 3; i <= size; i += 2) {
+        d ^= gf_mulexp(field, sigma[i], w);
+        w = (w + l2) % CPPECC_GF_NW1;
+    }
+    return d;
+}
+
+void rs_field_generator_poly(const CPPECC_STRUCT RSField* field, cppecc_s32 size, cppecc_u8 result[], cppecc_u8 tmp[])
+{
+    result[0] = 1;
+    cppecc_u8 poly[2] = {1, 0};
+    cppecc_s32 polySize = 1;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        poly[1] = field->exp_[(field->fcr_ + i) % CPPECC_GF_NW1];
+        polySize = gf_field_poly_mul(field, tmp, polySize, result, 2, poly);
+        for(cppecc_s32 j = 0; j < polySize; ++j) {
+            result[j] = tmp[j];
+        }
+    }
+}
+
+void rs_generator_poly(cppecc_s32 size, cppecc_u8 result[], cppecc_u8 tmp[])
+{
+    rs_field_generator_poly(&gfdefault, size, result, tmp);
+}
+
+void rs_power_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_u8 result[])
+{
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        for(cppecc_s32 f = 0; f < 6; ++f) {
+            cppecc_u8 x = field->exp_[(((field->fcr_ + i) % CPPECC_GF_NW1) << f) % CPPECC_GF_NW1];
+            cppecc_u8* table = result + (i * 6 + f) * 32;
+            for(cppecc_s32 n = 0; n < 16; ++n) {
+                table[n] = gf_field_mul(field, x, CPPECC_STATIC_CAST(cppecc_u8)(n));
+                table[16 + n] = gf_field_mul(field, x, CPPECC_STATIC_CAST(cppecc_u8)(n << 4));
+            }
+        }
+    }
+}
+
+void rs_chien_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numTerms, cppecc_u8 result[])
+{
+    for(cppecc_s32 j = 1; j <= numTerms; ++j) {
+        for(cppecc_s32 f = 0; f < 6; ++f) {
+            cppecc_u8 x = field->exp_[(CPPECC_GF_NW1 - ((j << f) % CPPECC_GF_NW1)) % CPPECC_GF_NW1];
+            cppecc_u8* table = result + ((j - 1) * 6 + f) * 32;
+            for(cppecc_s32 n = 0; n < 16; ++n) {
+                table[n] = gf_field_mul(field, x, CPPECC_STATIC_CAST(cppecc_u8)(n));
+                table[16 + n] = gf_field_mul(field, x, CPPECC_STATIC_CAST(cppecc_u8)(n << 4));
+            }
+        }
+    }
+}
+
+void rs_shuffle_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_s32 stride, cppecc_u8 result[], const cppecc_u8 generator[])
+{
+    CPPECC_ASSERT(numSymbols <= stride);
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        cppecc_u8* table = result + k * 32;
+        for(cppecc_s32 n = 0; n < 16; ++n) {
+            table[n] = gf_field_mul(field, generator[k + 1], CPPECC_STATIC_CAST(cppecc_u8)(n));
+            table[16 + n] = gf_field_mul(field, generator[k + 1], CPPECC_STATIC_CAST(cppecc_u8)(n << 4));
+        }
+    }
+    for(cppecc_s32 k = (0 < numSymbols ? numSymbols : 0) * 32; k < stride * 32; ++k) {
+        result[k] = 0;
+    }
+}
+
+void rs_slice_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_s32 slices, cppecc_u8 result[], const cppecc_u8 generator[])
+{
+    if(numSymbols <= 0) {
+        return;
+    }
+    // b*x^numSymbols mod g(x) = b*(g(x) - x^numSymbols)
+    for(cppecc_s32 b = 0; b < CPPECC_STATIC_CAST(cppecc_s32)(CPPECC_GF_NW); ++b) {
+        cppecc_u8* row = result + b * numSymbols;
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            row[k] = gf_field_mul(field, generator[k + 1], CPPECC_STATIC_CAST(cppecc_u8)(b));
+        }
+    }
+    // x*r(x) mod g(x), the coefficient which overflows is reduced with the first table
+    for(cppecc_s32 e = 1; e < slices; ++e) {
+        const cppecc_u8* prev = result + (e - 1) * CPPECC_GF_NW * numSymbols;
+        cppecc_u8* current = result + e * CPPECC_GF_NW * numSymbols;
+        for(cppecc_s32 b = 0; b < CPPECC_STATIC_CAST(cppecc_s32)(CPPECC_GF_NW); ++b) {
+            const cppecc_u8* p = prev + b * numSymbols;
+            const cppecc_u8* t = result + p[0] * numSymbols;
+            cppecc_u8* row = current + b * numSymbols;
+            for(cppecc_s32 k = 0; k < (numSymbols - 1); ++k) {
+                row[k] = p[k + 1] ^ t[k];
+            }
+            row[numSymbols - 1] = t[numSymbols - 1];
+        }
+    }
+}
+
+void rs_delta_tables(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, cppecc_s32 numRows, cppecc_u8 result[], const cppecc_u8 generator[])
+{
+    if(numSymbols <= 0 || numRows <= 0) {
+        return;
+    }
+    // x^numSymbols mod g(x) = g(x) - x^numSymbols, and each next row is multiplied by x
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        result[k] = generator[k + 1];
+    }
+    for(cppecc_s32 e = 1; e < numRows; ++e) {
+        const cppecc_u8* prev = result + (e - 1) * numSymbols;
+        cppecc_u8* row = result + e * numSymbols;
+        for(cppecc_s32 k = 0; k < (numSymbols - 1); ++k) {
+            row[k] = prev[k + 1] ^ gf_field_mul(field, prev[0], generator[k + 1]);
+        }
+        row[numSymbols - 1] = gf_field_mul(field, prev[0], generator[numSymbols]);
+    }
+}
+
+void rs_nibble_tables(cppecc_s32 numSymbols, cppecc_s32 slices, cppecc_s32 stride, cppecc_u8 result[], const cppecc_u8 sliceTables[])
+{
+    CPPECC_ASSERT(numSymbols <= stride);
+    // Products are linear, b*x^(numSymbols+e) = (b&0x0F)*x^(numSymbols+e) + (b&0xF0)*x^(numSymbols+e)
+    for(cppecc_s32 e = 0; e < slices; ++e) {
+        const cppecc_u8* table = sliceTables + e * CPPECC_GF_NW * numSymbols;
+        for(cppecc_s32 n = 0; n < 16; ++n) {
+            const cppecc_u8* lo = table + n * numSymbols;
+            const cppecc_u8* hi = table + (n << 4) * numSymbols;
+            cppecc_u8* rowLo = result + (e * 32 + n) * stride;
+            cppecc_u8* rowHi = result + (e * 32 + 16 + n) * stride;
+            for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+                rowLo[k] = lo[k];
+                rowHi[k] = hi[k];
+            }
+            for(cppecc_s32 k = (0 < numSymbols ? numSymbols : 0); k < stride; ++k) {
+                rowLo[k] = 0;
+                rowHi[k] = 0;
+            }
+        }
+    }
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+#if defined(CPPECC_KERNEL_SSSE3) || defined(CPPECC_KERNEL_AVX2) || defined(CPPECC_KERNEL_GFNI)
+/**
+ @brief Copy a seed of the LFSR to a buffer padded with zeros, so that kernels load whole registers. Null stays null.
+ */
+CPPECC_STATIC const cppecc_u8* rs_pad_seed(cppecc_u8 padded[CPPECC_GF_NW], const cppecc_u8 seed[], cppecc_s32 numSymbols)
+{
+    if(CPPECC_NULL == seed) {
+        return CPPECC_NULL;
+    }
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        padded[k] = seed[k];
+    }
+    for(cppecc_u32 k = CPPECC_STATIC_CAST(cppecc_u32)(numSymbols); k < CPPECC_GF_NW; ++k) {
+        padded[k] = 0;
+    }
+    return padded;
+}
+#endif
+
+#if defined(CPPECC_KERNEL_SSSE3)
+// The LFSR keeps the remainder in registers, symbol k is at byte k.
+// A step consumes N message bytes, the first N symbols of the remainder are combined with them as feedbacks,
+// the remainder is shifted down by N bytes, and each feedback is reduced with the split-nibble rows of the table for its distance from the end of the step.
+#    define CPPECC_NIBBLE_LO(nibbles, stride, e, x) ((nibbles) + ((e) * 32U + (CPPECC_STATIC_CAST(cppecc_u32)(x) & 0x0FU)) * (stride))
+#    define CPPECC_NIBBLE_HI(nibbles, stride, e, x) ((nibbles) + ((e) * 32U + 16U + (CPPECC_STATIC_CAST(cppecc_u32)(x) >> 4)) * (stride))
+#    define CPPECC_NIBBLE_ROW128(lo, hi, r) _mm_xor_si128(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)((lo) + 16 * (r))), _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)((hi) + 16 * (r))))
+
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_SSSE3 void rs_lfsr_ssse3(const cppecc_u8* nibbles, cppecc_u32 stride, cppecc_s32 numSlices, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 remainder[], const cppecc_s32 numRegisters)
+{
+    __m128i s[CPPECC_GF_NW / 16];
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        s[r] = (CPPECC_NULL != seed) ? _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(seed + 16 * r)) : _mm_setzero_si128();
+    }
+    cppecc_s32 i = 0;
+    for(; 8 <= numSlices && (i + 8) <= size; i += 8) {
+        cppecc_u32 f0 = CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(s[0]));
+        cppecc_u32 f1 = CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(_mm_srli_si128(s[0], 4)));
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 8);
+        }
+        s[numRegisters - 1] = _mm_srli_si128(s[numRegisters - 1], 8);
+        for(cppecc_s32 d = 0; d < 8; ++d) {
+            cppecc_u32 f = (d < 4) ? (f0 >> (8 * d)) : (f1 >> (8 * (d - 4)));
+            cppecc_u8 feedback = message[i + d] ^ CPPECC_STATIC_CAST(cppecc_u8)(f);
+            const cppecc_u8* lo = CPPECC_NIBBLE_LO(nibbles, stride, 7 - d, feedback);
+            const cppecc_u8* hi = CPPECC_NIBBLE_HI(nibbles, stride, 7 - d, feedback);
+            for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+                s[r] = _mm_xor_si128(s[r], CPPECC_NIBBLE_ROW128(lo, hi, r));
+            }
+        }
+    }
+    for(; 4 <= numSlices && (i + 4) <= size; i += 4) {
+        cppecc_u32 f0 = CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(s[0]));
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 4);
+        }
+        s[numRegisters - 1] = _mm_srli_si128(s[numRegisters - 1], 4);
+        for(cppecc_s32 d = 0; d < 4; ++d) {
+            cppecc_u8 feedback = message[i + d] ^ CPPECC_STATIC_CAST(cppecc_u8)(f0 >> (8 * d));
+            const cppecc_u8* lo = CPPECC_NIBBLE_LO(nibbles, stride, 3 - d, feedback);
+            const cppecc_u8* hi = CPPECC_NIBBLE_HI(nibbles, stride, 3 - d, feedback);
+            for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+                s[r] = _mm_xor_si128(s[r], CPPECC_NIBBLE_ROW128(lo, hi, r));
+            }
+        }
+    }
+    for(; i < size; ++i) {
+        cppecc_u8 feedback = message[i] ^ CPPECC_STATIC_CAST(cppecc_u8)(_mm_cvtsi128_si32(s[0]));
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 1);
+        }
+        s[numRegisters - 1] = _mm_srli_si128(s[numRegisters - 1], 1);
+        const cppecc_u8* lo = CPPECC_NIBBLE_LO(nibbles, stride, 0, feedback);
+        const cppecc_u8* hi = CPPECC_NIBBLE_HI(nibbles, stride, 0, feedback);
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            s[r] = _mm_xor_si128(s[r], CPPECC_NIBBLE_ROW128(lo, hi, r));
+        }
+    }
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(remainder + 16 * r), s[r]);
+    }
+}
+
+// Remainders up to 4 registers are unrolled and kept in registers, longer ones spill to the stack.
+CPPECC_STATIC CPPECC_TARGET_SSSE3 void rs_encode_ssse3(const cppecc_u8* nibbles, cppecc_s32 stride, cppecc_s32 numSlices, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_u8 padded[CPPECC_GF_NW];
+    const cppecc_u8* initial = rs_pad_seed(padded, seed, numSymbols);
+    cppecc_u32 rowStride = CPPECC_STATIC_CAST(cppecc_u32)(stride);
+    cppecc_s32 numRegisters = (numSymbols + 15) >> 4;
+    switch(numRegisters) {
+    case 1:
+        rs_lfsr_ssse3(nibbles, rowStride, numSlices, size, message, initial, remainder, 1);
+        break;
+    case 2:
+        rs_lfsr_ssse3(nibbles, rowStride, numSlices, size, message, initial, remainder, 2);
+        break;
+    case 3:
+        rs_lfsr_ssse3(nibbles, rowStride, numSlices, size, message, initial, remainder, 3);
+        break;
+    case 4:
+        rs_lfsr_ssse3(nibbles, rowStride, numSlices, size, message, initial, remainder, 4);
+        break;
+    default:
+        rs_lfsr_ssse3(nibbles, rowStride, numSlices, size, message, initial, remainder, numRegisters);
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i] = remainder[i];
+    }
+}
+#endif // CPPECC_KERNEL_SSSE3
+
+#if defined(CPPECC_KERNEL_AVX2)
+#    define CPPECC_NIBBLE_ROW256(lo, hi, r) _mm256_xor_si256(_mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)((lo) + 32 * (r))), _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)((hi) + 32 * (r))))
+// Shift registers down by N bytes across the 128 bit lanes, the last one is filled with zeros.
+#    define CPPECC_SHIFT256(s, numRegisters, n) \
+        do { \
+            for(cppecc_s32 r_ = 0; r_ < ((numRegisters)-1); ++r_) { \
+                (s)[r_] = _mm256_alignr_epi8(_mm256_permute2x128_si256((s)[r_], (s)[r_ + 1], 0x21), (s)[r_], (n)); \
+            } \
+            (s)[(numRegisters)-1] = _mm256_alignr_epi8(_mm256_permute2x128_si256((s)[(numRegisters)-1], (s)[(numRegisters)-1], 0x81), (s)[(numRegisters)-1], (n)); \
+        } while(0)
+
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_AVX2 void rs_lfsr_avx2(const cppecc_u8* nibbles, cppecc_u32 stride, cppecc_s32 numSlices, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 remainder[], const cppecc_s32 numRegisters)
+{
+    __m256i s[CPPECC_GF_NW / 32];
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        s[r] = (CPPECC_NULL != seed) ? _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(seed + 32 * r)) : _mm256_setzero_si256();
+    }
+    cppecc_s32 i = 0;
+    for(; 8 <= numSlices && (i + 8) <= size; i += 8) {
+        __m128i s0 = _mm256_castsi256_si128(s[0]);
+        cppecc_u32 f0 = CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(s0));
+        cppecc_u32 f1 = CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(_mm_srli_si128(s0, 4)));
+        CPPECC_SHIFT256(s, numRegisters, 8);
+        for(cppecc_s32 d = 0; d < 8; ++d) {
+            cppecc_u32 f = (d < 4) ? (f0 >> (8 * d)) : (f1 >> (8 * (d - 4)));
+            cppecc_u8 feedback = message[i + d] ^ CPPECC_STATIC_CAST(cppecc_u8)(f);
+            const cppecc_u8* lo = CPPECC_NIBBLE_LO(nibbles, stride, 7 - d, feedback);
+            const cppecc_u8* hi = CPPECC_NIBBLE_HI(nibbles, stride, 7 - d, feedback);
+            for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+                s[r] = _mm256_xor_si256(s[r], CPPECC_NIBBLE_ROW256(lo, hi, r));
+            }
+        }
+    }
+    for(; 4 <= numSlices && (i + 4) <= size; i += 4) {
+        cppecc_u32 f0 = CPPECC_STATIC_CAST(cppecc_u32)(_mm256_cvtsi256_si32(s[0]));
+        CPPECC_SHIFT256(s, numRegisters, 4);
+        for(cppecc_s32 d = 0; d < 4; ++d) {
+            cppecc_u8 feedback = message[i + d] ^ CPPECC_STATIC_CAST(cppecc_u8)(f0 >> (8 * d));
+            const cppecc_u8* lo = CPPECC_NIBBLE_LO(nibbles, stride, 3 - d, feedback);
+            const cppecc_u8* hi = CPPECC_NIBBLE_HI(nibbles, stride, 3 - d, feedback);
+            for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+                s[r] = _mm256_xor_si256(s[r], CPPECC_NIBBLE_ROW256(lo, hi, r));
+            }
+        }
+    }
+    for(; i < size; ++i) {
+        cppecc_u8 feedback = message[i] ^ CPPECC_STATIC_CAST(cppecc_u8)(_mm256_cvtsi256_si32(s[0]));
+        CPPECC_SHIFT256(s, numRegisters, 1);
+        const cppecc_u8* lo = CPPECC_NIBBLE_LO(nibbles, stride, 0, feedback);
+        const cppecc_u8* hi = CPPECC_NIBBLE_HI(nibbles, stride, 0, feedback);
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            s[r] = _mm256_xor_si256(s[r], CPPECC_NIBBLE_ROW256(lo, hi, r));
+        }
+    }
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(remainder + 32 * r), s[r]);
+    }
+}
+
+CPPECC_STATIC CPPECC_TARGET_AVX2 void rs_encode_avx2(const cppecc_u8* nibbles, cppecc_s32 stride, cppecc_s32 numSlices, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_u8 padded[CPPECC_GF_NW];
+    const cppecc_u8* initial = rs_pad_seed(padded, seed, numSymbols);
+    cppecc_u32 rowStride = CPPECC_STATIC_CAST(cppecc_u32)(stride);
+    cppecc_s32 numRegisters = (numSymbols + 31) >> 5;
+    switch(numRegisters) {
+    case 1:
+        rs_lfsr_avx2(nibbles, rowStride, numSlices, size, message, initial, remainder, 1);
+        break;
+    case 2:
+        rs_lfsr_avx2(nibbles, rowStride, numSlices, size, message, initial, remainder, 2);
+        break;
+    case 3:
+        rs_lfsr_avx2(nibbles, rowStride, numSlices, size, message, initial, remainder, 3);
+        break;
+    case 4:
+        rs_lfsr_avx2(nibbles, rowStride, numSlices, size, message, initial, remainder, 4);
+        break;
+    default:
+        rs_lfsr_avx2(nibbles, rowStride, numSlices, size, message, initial, remainder, numRegisters);
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i] = remainder[i];
+    }
+}
+#endif // CPPECC_KERNEL_AVX2
+
+#if defined(CPPECC_KERNEL_GFNI_AVX512)
+/**
+ @brief Slicing-by-16 with 64 symbols in a register, symbols are mapped to the field of AES and products are GF2P8MULB.
+
+ Each feedback byte is broadcast with a shuffle and multiplied by the row for its distance from the end of the step, that is x^(numSymbols+e) mod generator.
+ The first block is padded with leading zeros, they don't change the zero remainder. So all steps consume 16 bytes and shift the registers by two lanes.
+ A seed is not zero, so the size should be a multiple of 16 with a seed.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_GFNI void rs_lfsr_gfni(const cppecc_u64 isomorphism[2], const cppecc_u8* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 remainder[], const cppecc_s32 numRegisters)
+{
+    const __m512i toAES = _mm512_set1_epi64(CPPECC_STATIC_CAST(long long)(isomorphism[0]));
+    const __m512i fromAES = _mm512_set1_epi64(CPPECC_STATIC_CAST(long long)(isomorphism[1]));
+    __m512i s[CPPECC_GF_NW / 64];
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        s[r] = (CPPECC_NULL != seed) ? _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(seed + 64 * r), toAES, 0) : _mm512_setzero_si512();
+    }
+    cppecc_s32 numBlocks = (size + 15) >> 4;
+    cppecc_s32 head = (0 < numBlocks) ? size - ((numBlocks - 1) << 4) : 0;
+    cppecc_u8 first[16] = {0};
+    for(cppecc_s32 i = 0; i < head; ++i) {
+        first[16 - head + i] = message[i];
+    }
+    // Intrinsics with all lanes masked in, some compilers warn undefined lanes of the plain ones
+    for(cppecc_s32 j = 0; j < numBlocks; ++j) {
+        const cppecc_u8* block = (0 == j) ? first : (message + head + ((j - 1) << 4));
+        __m512i x = _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(0xFFFFULL, block), toAES, 0);
+        x = _mm512_xor_si512(x, s[0]);
+        x = _mm512_maskz_shuffle_i64x2(0xFF, x, x, 0);
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm512_maskz_alignr_epi64(0xFF, s[r + 1], s[r], 2);
+        }
+        s[numRegisters - 1] = _mm512_maskz_alignr_epi64(0xFF, _mm512_setzero_si512(), s[numRegisters - 1], 2);
+        __m512i feedback[16];
+        for(cppecc_s32 d = 0; d < 16; ++d) {
+            feedback[d] = _mm512_shuffle_epi8(x, _mm512_set1_epi8(CPPECC_STATIC_CAST(char)(d)));
+        }
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            __m512i p[16];
+            for(cppecc_s32 d = 0; d < 16; ++d) {
+                p[d] = _mm512_gf2p8mul_epi8(feedback[d], _mm512_loadu_si512(rows + (15 - d) * stride + 64 * r));
+            }
+            // Three way xors keep the tree shallow
+            __m512i t0 = _mm512_ternarylogic_epi64(p[0], p[1], p[2], 0x96);
+            __m512i t1 = _mm512_ternarylogic_epi64(p[3], p[4], p[5], 0x96);
+            __m512i t2 = _mm512_ternarylogic_epi64(p[6], p[7], p[8], 0x96);
+            __m512i t3 = _mm512_ternarylogic_epi64(p[9], p[10], p[11], 0x96);
+            __m512i t4 = _mm512_ternarylogic_epi64(p[12], p[13], p[14], 0x96);
+            __m512i u0 = _mm512_ternarylogic_epi64(t0, t1, t2, 0x96);
+            __m512i u1 = _mm512_ternarylogic_epi64(t3, t4, p[15], 0x96);
+            s[r] = _mm512_ternarylogic_epi64(s[r], u0, u1, 0x96);
+        }
+    }
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        _mm512_storeu_si512(remainder + 64 * r, _mm512_gf2p8affine_epi64_epi8(s[r], fromAES, 0));
+    }
+}
+
+CPPECC_STATIC CPPECC_TARGET_GFNI void rs_encode_gfni(const cppecc_u64 isomorphism[2], const cppecc_u8* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_s32 numRegisters = (numSymbols + 63) >> 6;
+    if(numRegisters <= 0) {
+        return;
+    }
+    cppecc_u8 padded[CPPECC_GF_NW];
+    const cppecc_u8* initial = rs_pad_seed(padded, seed, numSymbols);
+    switch(numRegisters) {
+    case 1:
+        rs_lfsr_gfni(isomorphism, rows, stride, size, message, initial, remainder, 1);
+        break;
+    case 2:
+        rs_lfsr_gfni(isomorphism, rows, stride, size, message, initial, remainder, 2);
+        break;
+    case 3:
+        rs_lfsr_gfni(isomorphism, rows, stride, size, message, initial, remainder, 3);
+        break;
+    default:
+        rs_lfsr_gfni(isomorphism, rows, stride, size, message, initial, remainder, 4);
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i] = remainder[i];
+    }
+}
+#endif // CPPECC_KERNEL_GFNI_AVX512
+
+#if defined(CPPECC_KERNEL_GFNI_AVX2)
+/**
+ @brief Same as rs_lfsr_gfni with the VEX encoded GFNI, 32 symbols in a register for CPUs without AVX-512.
+
+ A step shifts the registers by a 128 bit lane, that is a permutation of neighbouring registers.
+ Feedback bytes are applied one after another to all registers, so that registers of the remainder don't spill.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_GFNI_AVX2 void rs_lfsr_gfni_avx2(const cppecc_u64 isomorphism[2], const cppecc_u8* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 remainder[], const cppecc_s32 numRegisters)
+{
+    const __m256i toAES = _mm256_set1_epi64x(CPPECC_STATIC_CAST(long long)(isomorphism[0]));
+    const __m256i fromAES = _mm256_set1_epi64x(CPPECC_STATIC_CAST(long long)(isomorphism[1]));
+    __m256i s[CPPECC_GF_NW / 32];
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        s[r] = (CPPECC_NULL != seed) ? _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(seed + 32 * r)), toAES, 0) : _mm256_setzero_si256();
+    }
+    cppecc_s32 numBlocks = (size + 15) >> 4;
+    cppecc_s32 head = (0 < numBlocks) ? size - ((numBlocks - 1) << 4) : 0;
+    cppecc_u8 first[16] = {0};
+    for(cppecc_s32 i = 0; i < head; ++i) {
+        first[16 - head + i] = message[i];
+    }
+    for(cppecc_s32 j = 0; j < numBlocks; ++j) {
+        const cppecc_u8* block = (0 == j) ? first : (message + head + ((j - 1) << 4));
+        __m256i x = _mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(block)));
+        x = _mm256_xor_si256(_mm256_gf2p8affine_epi64_epi8(x, toAES, 0), _mm256_permute2x128_si256(s[0], s[0], 0x00));
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm256_permute2x128_si256(s[r], s[r + 1], 0x21);
+        }
+        s[numRegisters - 1] = _mm256_permute2x128_si256(s[numRegisters - 1], s[numRegisters - 1], 0x81);
+        for(cppecc_s32 d = 0; d < 16; ++d) {
+            const __m256i feedback = _mm256_shuffle_epi8(x, _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(d)));
+            const cppecc_u8* row = rows + (15 - d) * stride;
+            for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+                __m256i p = _mm256_gf2p8mul_epi8(feedback, _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(row + 32 * r)));
+                s[r] = _mm256_xor_si256(s[r], p);
+            }
+        }
+    }
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(remainder + 32 * r), _mm256_gf2p8affine_epi64_epi8(s[r], fromAES, 0));
+    }
+}
+
+CPPECC_STATIC CPPECC_TARGET_GFNI_AVX2 void rs_encode_gfni_avx2(const cppecc_u64 isomorphism[2], const cppecc_u8* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_s32 numRegisters = (numSymbols + 31) >> 5;
+    if(numRegisters <= 0) {
+        return;
+    }
+    cppecc_u8 padded[CPPECC_GF_NW];
+    const cppecc_u8* initial = rs_pad_seed(padded, seed, numSymbols);
+    switch(numRegisters) {
+    case 1:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 1);
+        break;
+    case 2:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 2);
+        break;
+    case 3:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 3);
+        break;
+    case 4:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 4);
+        break;
+    case 5:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 5);
+        break;
+    case 6:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 6);
+        break;
+    case 7:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 7);
+        break;
+    default:
+        rs_lfsr_gfni_avx2(isomorphism, rows, stride, size, message, initial, remainder, 8);
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i] = remainder[i];
+    }
+}
+#endif // CPPECC_KERNEL_GFNI_AVX2
+
+// Slicing-by-N, the first N symbols of the remainder are combined with the next N message bytes.
+// Then each of them is reduced at once with the table for its distance from the end of the step.
+CPPECC_STATIC void rs_lfsr_slicing(const cppecc_u8* slices, cppecc_s32 numSlices, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    const cppecc_s32 stride = CPPECC_GF_NW * numSymbols;
+    cppecc_u8 remainder[CPPECC_GF_NW + 8] = {0};
+    if(CPPECC_NULL != seed) {
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            remainder[k] = seed[k];
+        }
+    }
+    cppecc_s32 i = 0;
+    if(8 <= numSlices) {
+        for(; (i + 8) <= size; i += 8) {
+            const cppecc_u8* t0 = slices + 7 * stride + (message[i + 0] ^ remainder[0]) * numSymbols;
+            const cppecc_u8* t1 = slices + 6 * stride + (message[i + 1] ^ remainder[1]) * numSymbols;
+            const cppecc_u8* t2 = slices + 5 * stride + (message[i + 2] ^ remainder[2]) * numSymbols;
+            const cppecc_u8* t3 = slices + 4 * stride + (message[i + 3] ^ remainder[3]) * numSymbols;
+            const cppecc_u8* t4 = slices + 3 * stride + (message[i + 4] ^ remainder[4]) * numSymbols;
+            const cppecc_u8* t5 = slices + 2 * stride + (message[i + 5] ^ remainder[5]) * numSymbols;
+            const cppecc_u8* t6 = slices + 1 * stride + (message[i + 6] ^ remainder[6]) * numSymbols;
+            const cppecc_u8* t7 = slices + (message[i + 7] ^ remainder[7]) * numSymbols;
+            for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+                remainder[k] = remainder[k + 8] ^ t0[k] ^ t1[k] ^ t2[k] ^ t3[k] ^ t4[k] ^ t5[k] ^ t6[k] ^ t7[k];
+            }
+        }
+    }
+    if(4 <= numSlices) {
+        for(; (i + 4) <= size; i += 4) {
+            const cppecc_u8* t0 = slices + 3 * stride + (message[i + 0] ^ remainder[0]) * numSymbols;
+            const cppecc_u8* t1 = slices + 2 * stride + (message[i + 1] ^ remainder[1]) * numSymbols;
+            const cppecc_u8* t2 = slices + 1 * stride + (message[i + 2] ^ remainder[2]) * numSymbols;
+            const cppecc_u8* t3 = slices + (message[i + 3] ^ remainder[3]) * numSymbols;
+            for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+                remainder[k] = remainder[k + 4] ^ t0[k] ^ t1[k] ^ t2[k] ^ t3[k];
+            }
+        }
+    }
+    for(; i < size; ++i) {
+        const cppecc_u8* t0 = slices + (message[i] ^ remainder[0]) * numSymbols;
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            remainder[k] = remainder[k + 1] ^ t0[k];
+        }
+    }
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        parity[k] = remainder[k];
+    }
+}
+
+CPPECC_STATIC void rs_parity_slicing(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    rs_lfsr_slicing(context->slices_, context->numSlices_, size, message, seed, parity, numSymbols);
+}
+
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC void rs_parity_ssse3(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    rs_encode_ssse3(context->nibbles_, context->stride_, context->numNibbles_, size, message, seed, parity, numSymbols);
+}
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC void rs_parity_avx2(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    // A register of 16 symbols is enough for short remainders
+    if(16 < numSymbols) {
+        rs_encode_avx2(context->nibbles_, context->stride_, context->numNibbles_, size, message, seed, parity, numSymbols);
+    } else {
+        rs_encode_ssse3(context->nibbles_, context->stride_, context->numNibbles_, size, message, seed, parity, numSymbols);
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_GFNI_AVX512)
+CPPECC_STATIC void rs_parity_gfni(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    // Contexts made while other kernels were bound have no tables of GFNI
+    if(CPPECC_NULL == context->rows_) {
+        rs_parity_avx2(context, size, message, seed, parity, numSymbols);
+        return;
+    }
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_s32 head = size & 15;
+    if(CPPECC_NULL != seed && 0 != head) {
+        // Leading zeros would shift a seed, so the head is consumed by the tables until the rest is whole steps
+        rs_lfsr_slicing(context->slices_, context->numSlices_, head, message, seed, remainder, numSymbols);
+        seed = remainder;
+        message += head;
+        size -= head;
+    }
+    rs_encode_gfni(context->isomorphism_, context->rows_, (context->numSymbols_ + 63) & ~63, size, message, seed, parity, numSymbols);
+}
+#endif
+
+#if defined(CPPECC_KERNEL_GFNI_AVX2)
+CPPECC_STATIC void rs_parity_gfni_avx2(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    // The same steps of 16 bytes and fallback as rs_parity_gfni
+    if(CPPECC_NULL == context->rows_) {
+        rs_parity_avx2(context, size, message, seed, parity, numSymbols);
+        return;
+    }
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_s32 head = size & 15;
+    if(CPPECC_NULL != seed && 0 != head) {
+        rs_lfsr_slicing(context->slices_, context->numSlices_, head, message, seed, remainder, numSymbols);
+        seed = remainder;
+        message += head;
+        size -= head;
+    }
+    rs_encode_gfni_avx2(context->isomorphism_, context->rows_, (context->numSymbols_ + 63) & ~63, size, message, seed, parity, numSymbols);
+}
+#endif
+
+/**
+ @brief Kernels bound by rs_select_kernels. Each level of features has a constant table, and binding swaps the pointer to it.
+ */
+struct RSKernels
+{
+    cppecc_u32 features_;
+    void (*parity_)(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], const cppecc_u8 seed[], cppecc_u8 parity[], cppecc_s32 numSymbols); //!< seed is the remainder to continue from, or null for zeros
+    cppecc_u8 (*scan_)(const cppecc_u8 powers[], cppecc_s32 length, const cppecc_u8 message[], cppecc_s32 numSymbols);
+    cppecc_s32 scanSymbols_; //!< rs_check scans syndromes up to this number of symbols, 0 without scan_
+    cppecc_s32 (*chienScan_)(const CPPECC_STRUCT RSField* field, const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[], cppecc_u8 positions[], cppecc_u8 odds[], cppecc_u8 values[]);
+    void (*chienEvaluate_)(const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numTerms, const cppecc_u8 sigma[], const cppecc_u8 omega[], cppecc_u8 locators[], cppecc_u8 odds[], cppecc_u8 values[]);
+    void (*syndromes_)(const CPPECC_STRUCT RSContext* context, cppecc_s32 length, const cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_u8 syndromes[]); //!< all syndromes in a pass, null if the remainder is cheaper. See rs_has_syndromes
+    void (*mulAddRegion_)(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[]);
+    cppecc_s32 lanes_; //!< codewords which encodeLanes_ encodes in lockstep
+    void (*encodeLanes_)(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8* data, cppecc_s32 stride, cppecc_u8* parity, cppecc_s32 numSymbols); //!< rows are 'stride' bytes apart
+    cppecc_u8 (*symbolSum_)(cppecc_s32 size, const cppecc_u8 message[]); //!< syndrome at alpha^0, rs_check of one redundant symbol
+};
+
+//! One of the constant tables of rs_kernels_bind, null until the first context binds it
+CPPECC_STATIC const CPPECC_STRUCT RSKernels* rs_kernels_;
+
+CPPECC_STATIC const CPPECC_STRUCT RSKernels* rs_kernels(void);
+
+/**
+ @brief Whether syndromes_ of kernels can take the context, it needs the tables of GFNI.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE cppecc_s32 rs_has_syndromes(const CPPECC_STRUCT RSKernels* kernels, const CPPECC_STRUCT RSContext* context)
+{
+#if defined(CPPECC_KERNEL_GFNI)
+    return (CPPECC_NULL != kernels->syndromes_ && CPPECC_NULL != context->roots_) ? 1 : 0;
+#else
+    (void)context;
+    return CPPECC_NULL != kernels->syndromes_ ? 1 : 0;
+#endif
+}
+
+/**
+ @brief Remainder of message(x)*x^numSymbols divided by the generation polynomial, with the bound kernel.
+ */
+CPPECC_STATIC void rs_parity(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    rs_kernels()->parity_(context, size, message, CPPECC_NULL, parity, numSymbols);
+}
+
+/**
+ @brief Continue the LFSR from a remainder with the next part of a message, remainder is replaced with the result.
+
+ The remainder of the whole message is the same as rs_parity, so a message can be divided at any bytes.
+ */
+CPPECC_STATIC void rs_parity_continue(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], cppecc_u8 remainder[], cppecc_s32 numSymbols)
+{
+    rs_kernels()->parity_(context, size, message, remainder, remainder, numSymbols);
+}
+
+//! Byte lanes of the widest batch encoder, that is the size of tiles
+#define CPPECC_BATCH_LANES (32)
+
+// Each byte lane runs the LFSR of its own codeword. The remainders are kept as rows of vectors, row k holds symbol k of all lanes.
+// The feedback vector is multiplied by each coefficient of the generator with two shuffles.
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC CPPECC_TARGET_SSSE3 void rs_encode_lanes_ssse3(const cppecc_u8* shuffles, cppecc_s32 size, const cppecc_u8* data, cppecc_s32 stride, cppecc_u8* parity, cppecc_s32 numSymbols)
+{
+    __m128i remainder[CPPECC_GF_NW];
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        remainder[k] = _mm_setzero_si128();
+    }
+    cppecc_s32 last = numSymbols - 1;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        __m128i feedback = _mm_xor_si128(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(data + i * stride)), remainder[0]);
+        __m128i lo = _mm_and_si128(feedback, mask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(feedback, 4), mask);
+        const cppecc_u8* table = shuffles;
+        for(cppecc_s32 k = 0; k < last; ++k, table += 32) {
+            __m128i product = _mm_xor_si128(
+                _mm_shuffle_epi8(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table)), lo),
+                _mm_shuffle_epi8(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16)), hi));
+            remainder[k] = _mm_xor_si128(remainder[k + 1], product);
+        }
+        remainder[last] = _mm_xor_si128(
+            _mm_shuffle_epi8(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table)), lo),
+            _mm_shuffle_epi8(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16)), hi));
+    }
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(parity + k * stride), remainder[k]);
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC CPPECC_TARGET_AVX2 void rs_encode_lanes_avx2(const cppecc_u8* shuffles, cppecc_s32 size, const cppecc_u8* data, cppecc_s32 stride, cppecc_u8* parity, cppecc_s32 numSymbols)
+{
+    __m256i remainder[CPPECC_GF_NW];
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        remainder[k] = _mm256_setzero_si256();
+    }
+    cppecc_s32 last = numSymbols - 1;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        __m256i feedback = _mm256_xor_si256(_mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(data + i * stride)), remainder[0]);
+        __m256i lo = _mm256_and_si256(feedback, mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(feedback, 4), mask);
+        const cppecc_u8* table = shuffles;
+        for(cppecc_s32 k = 0; k < last; ++k, table += 32) {
+            __m256i product = _mm256_xor_si256(
+                _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table))), lo),
+                _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16))), hi));
+            remainder[k] = _mm256_xor_si256(remainder[k + 1], product);
+        }
+        remainder[last] = _mm256_xor_si256(
+            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table))), lo),
+            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16))), hi));
+    }
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(parity + k * stride), remainder[k]);
+    }
+}
+#endif // CPPECC_KERNEL_AVX2
+
+/**
+ @brief Encode interleaved codewords in lockstep, rows are 'stride' bytes apart. The portable kernel encodes a codeword of them.
+ */
+CPPECC_STATIC void rs_batch_scalar(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8* data, cppecc_s32 stride, cppecc_u8* parity, cppecc_s32 numSymbols)
+{
+    cppecc_u8 message[CPPECC_GF_NW];
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        message[i] = data[i * stride];
+    }
+    rs_parity(context, size, message, remainder, numSymbols);
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i * stride] = remainder[i];
+    }
+}
+
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC void rs_batch_ssse3(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8* data, cppecc_s32 stride, cppecc_u8* parity, cppecc_s32 numSymbols)
+{
+    rs_encode_lanes_ssse3(context->shuffles_, size, data, stride, parity, numSymbols);
+}
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC void rs_batch_avx2(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8* data, cppecc_s32 stride, cppecc_u8* parity, cppecc_s32 numSymbols)
+{
+    rs_encode_lanes_avx2(context->shuffles_, size, data, stride, parity, numSymbols);
+}
+#endif
+
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_SSSE3 __m128i rs_mul_ssse3(__m128i x, const cppecc_u8* table)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    return _mm_xor_si128(
+        _mm_shuffle_epi8(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table)), _mm_and_si128(x, mask)),
+        _mm_shuffle_epi8(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16)), _mm_and_si128(_mm_srli_epi16(x, 4), mask)));
+}
+
+/**
+ @brief Fold 16 lanes in halves, (the upper half)*alpha^(i*half) + (the lower half), the syndrome is in the lowest lane.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_SSSE3 __m128i rs_syndrome_fold_ssse3(__m128i x, const cppecc_u8* table)
+{
+    x = _mm_xor_si128(rs_mul_ssse3(x, table + 3 * 32), _mm_srli_si128(x, 8));
+    x = _mm_xor_si128(rs_mul_ssse3(x, table + 2 * 32), _mm_srli_si128(x, 4));
+    x = _mm_xor_si128(rs_mul_ssse3(x, table + 1 * 32), _mm_srli_si128(x, 2));
+    return _mm_xor_si128(rs_mul_ssse3(x, table), _mm_srli_si128(x, 1));
+}
+
+/**
+ @brief Evaluate the message at alpha^i for all syndromes, and return non-zero if any of them is not zero.
+
+ Each syndrome is a Horner's rule over vectors, every lane evaluates the symbols of the same position modulo the vector width.
+ Then, lanes are folded in halves. The first block is padded with leading zeros, so that the last block ends at the last symbol.
+ */
+CPPECC_STATIC CPPECC_TARGET_SSSE3 cppecc_u8 rs_syndrome_scan_ssse3(const cppecc_u8 powers[], cppecc_s32 length, const cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    static const cppecc_s32 Width = 16;
+    cppecc_s32 numBlocks = (length + Width - 1) / Width;
+    cppecc_s32 head = length - (numBlocks - 1) * Width;
+    cppecc_u8 first[16] = {0};
+    for(cppecc_s32 i = 0; i < head; ++i) {
+        first[Width - head + i] = message[i];
+    }
+    const cppecc_u8* blocks = message + head;
+
+    __m128i result = _mm_setzero_si128();
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        const cppecc_u8* table = powers + i * 6 * 32;
+        __m128i x = _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(first));
+        for(cppecc_s32 j = 1; j < numBlocks; ++j) {
+            x = _mm_xor_si128(rs_mul_ssse3(x, table + 4 * 32), _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(blocks + (j - 1) * Width)));
+        }
+        result = _mm_or_si128(result, rs_syndrome_fold_ssse3(x, table));
+    }
+    return CPPECC_STATIC_CAST(cppecc_u8)(_mm_cvtsi128_si32(result));
+}
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+/**
+ @brief Same as rs_syndrome_scan_ssse3, with 32 lanes. The upper 128 bits are folded first.
+ */
+CPPECC_STATIC CPPECC_TARGET_AVX2 cppecc_u8 rs_syndrome_scan_avx2(const cppecc_u8 powers[], cppecc_s32 length, const cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    static const cppecc_s32 Width = 32;
+    cppecc_s32 numBlocks = (length + Width - 1) / Width;
+    cppecc_s32 head = length - (numBlocks - 1) * Width;
+    cppecc_u8 first[32] = {0};
+    for(cppecc_s32 i = 0; i < head; ++i) {
+        first[Width - head + i] = message[i];
+    }
+    const cppecc_u8* blocks = message + head;
+
+    __m128i result = _mm_setzero_si128();
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        const cppecc_u8* table = powers + i * 6 * 32;
+        const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 5 * 32)));
+        const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 5 * 32 + 16)));
+        __m256i y = _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(first));
+        for(cppecc_s32 j = 1; j < numBlocks; ++j) {
+            __m256i product = _mm256_xor_si256(
+                _mm256_shuffle_epi8(lo, _mm256_and_si256(y, mask)),
+                _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(y, 4), mask)));
+            y = _mm256_xor_si256(product, _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(blocks + (j - 1) * Width)));
+        }
+        __m128i x = _mm_xor_si128(rs_mul_ssse3(_mm256_castsi256_si128(y), table + 4 * 32), _mm256_extracti128_si256(y, 1));
+        result = _mm_or_si128(result, rs_syndrome_fold_ssse3(x, table));
+    }
+    return CPPECC_STATIC_CAST(cppecc_u8)(_mm_cvtsi128_si32(result));
+}
+#endif
+
+#if defined(CPPECC_KERNEL_GFNI_AVX512)
+/**
+ @brief Syndromes of 8 roots in each of numRegisters registers, a 64 bit lane is a root.
+
+ Bytes of a lane are Horner's rules of the symbols of the same position modulo 8, which step with the matrix of r^8.
+ At the end, byte c is multiplied by r^(7-c) with masked products by r, r^2 and r^4, then the bytes of each lane are summed up.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_GFNI void rs_syndromes_group_gfni(const cppecc_u64* roots, cppecc_s32 numBlocks, const cppecc_u8 first[], const cppecc_u8 blocks[], cppecc_u8 syndromes[], const cppecc_s32 numRegisters)
+{
+    __m512i s[4];
+    __m512i m[4];
+    const __m512i x = _mm512_set1_epi64(_mm_cvtsi128_si64(_mm_loadl_epi64(CPPECC_REINTERPRET_CAST(const __m128i*)(first))));
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        m[r] = _mm512_loadu_si512(roots + 32 * r);
+        s[r] = x;
+    }
+    for(cppecc_s32 j = 1; j < numBlocks; ++j) {
+        const __m512i y = _mm512_set1_epi64(_mm_cvtsi128_si64(_mm_loadl_epi64(CPPECC_REINTERPRET_CAST(const __m128i*)(blocks + ((j - 1) << 3)))));
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            s[r] = _mm512_xor_si512(_mm512_gf2p8affine_epi64_epi8(s[r], m[r], 0), y);
+        }
+    }
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        const cppecc_u64* table = roots + 32 * r;
+        __m512i y = _mm512_mask_gf2p8affine_epi64_epi8(s[r], 0x5555555555555555ULL, s[r], _mm512_loadu_si512(table + 8), 0);
+        y = _mm512_mask_gf2p8affine_epi64_epi8(y, 0x3333333333333333ULL, y, _mm512_loadu_si512(table + 16), 0);
+        y = _mm512_mask_gf2p8affine_epi64_epi8(y, 0x0F0F0F0F0F0F0F0FULL, y, _mm512_loadu_si512(table + 24), 0);
+        // The lowest byte of a lane depends only on the bytes of the lane, the others may take bytes of the next lane
+        y = _mm512_xor_si512(y, _mm512_bsrli_epi128(y, 4));
+        y = _mm512_xor_si512(y, _mm512_bsrli_epi128(y, 2));
+        y = _mm512_xor_si512(y, _mm512_bsrli_epi128(y, 1));
+        _mm_storel_epi64(CPPECC_REINTERPRET_CAST(__m128i*)(syndromes + 8 * r), _mm512_maskz_cvtepi64_epi8(0xFF, y));
+    }
+}
+
+/**
+ @brief Evaluate the message at all roots, 32 roots in a pass of the message.
+
+ The message is not reduced by the generator, so this costs the length times numSymbols/8 instructions, but they are independent of each other.
+ */
+CPPECC_STATIC CPPECC_TARGET_GFNI void rs_syndromes_gfni(const CPPECC_STRUCT RSContext* context, cppecc_s32 length, const cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_u8 syndromes[])
+{
+    cppecc_s32 numBlocks = (length + 7) >> 3;
+    cppecc_s32 head = (0 < numBlocks) ? length - ((numBlocks - 1) << 3) : 0;
+    cppecc_u8 first[8] = {0};
+    for(cppecc_s32 i = 0; i < head; ++i) {
+        first[8 - head + i] = message[i];
+    }
+    const cppecc_u8* blocks = message + head;
+    cppecc_u8 result[CPPECC_GF_NW];
+    cppecc_s32 numGroups = (numSymbols + 7) >> 3;
+    cppecc_s32 g = 0;
+    for(; (g + 4) <= numGroups; g += 4) {
+        rs_syndromes_group_gfni(context->roots_ + 32 * g, numBlocks, first, blocks, result + 8 * g, 4);
+    }
+    switch(numGroups - g) {
+    case 1:
+        rs_syndromes_group_gfni(context->roots_ + 32 * g, numBlocks, first, blocks, result + 8 * g, 1);
+        break;
+    case 2:
+        rs_syndromes_group_gfni(context->roots_ + 32 * g, numBlocks, first, blocks, result + 8 * g, 2);
+        break;
+    case 3:
+        rs_syndromes_group_gfni(context->roots_ + 32 * g, numBlocks, first, blocks, result + 8 * g, 3);
+        break;
+    default:
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        syndromes[i] = result[i];
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_GFNI_AVX2)
+/**
+ @brief Same as rs_syndromes_group_gfni with 4 roots in a register, a group of 8 roots in the tables is two registers.
+
+ Blends take the place of masked products, and the lowest byte of each lane is read from memory at the end.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_GFNI_AVX2 void rs_syndromes_quad_gfni_avx2(const cppecc_u64* roots, cppecc_s32 numBlocks, const cppecc_u8 first[], const cppecc_u8 blocks[], cppecc_u8 syndromes[], const cppecc_s32 numRegisters)
+{
+    __m256i s[4];
+    __m256i m[4];
+    const __m256i x = _mm256_broadcastq_epi64(_mm_loadl_epi64(CPPECC_REINTERPRET_CAST(const __m128i*)(first)));
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        m[r] = _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(roots + 32 * (r >> 1) + 4 * (r & 1)));
+        s[r] = x;
+    }
+    for(cppecc_s32 j = 1; j < numBlocks; ++j) {
+        const __m256i y = _mm256_broadcastq_epi64(_mm_loadl_epi64(CPPECC_REINTERPRET_CAST(const __m128i*)(blocks + ((j - 1) << 3))));
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            s[r] = _mm256_xor_si256(_mm256_gf2p8affine_epi64_epi8(s[r], m[r], 0), y);
+        }
+    }
+    // Byte c is multiplied by r^(7-c), the masks select bytes whose power has the bit 1, 2 or 4
+    const __m256i bit1 = _mm256_set1_epi16(0x00FF);
+    const __m256i bit2 = _mm256_set1_epi32(0x0000FFFF);
+    const __m256i bit4 = _mm256_set1_epi64x(0x00000000FFFFFFFFLL);
+    for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+        const cppecc_u64* table = roots + 32 * (r >> 1) + 4 * (r & 1);
+        __m256i y = _mm256_blendv_epi8(s[r], _mm256_gf2p8affine_epi64_epi8(s[r], _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(table + 8)), 0), bit1);
+        y = _mm256_blendv_epi8(y, _mm256_gf2p8affine_epi64_epi8(y, _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(table + 16)), 0), bit2);
+        y = _mm256_blendv_epi8(y, _mm256_gf2p8affine_epi64_epi8(y, _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(table + 24)), 0), bit4);
+        y = _mm256_xor_si256(y, _mm256_srli_si256(y, 4));
+        y = _mm256_xor_si256(y, _mm256_srli_si256(y, 2));
+        y = _mm256_xor_si256(y, _mm256_srli_si256(y, 1));
+        cppecc_u64 lanes[4];
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(lanes), y);
+        for(cppecc_s32 k = 0; k < 4; ++k) {
+            syndromes[4 * r + k] = CPPECC_STATIC_CAST(cppecc_u8)(lanes[k]);
+        }
+    }
+}
+
+/**
+ @brief Evaluate the message at all roots, 16 roots in a pass of the message.
+ */
+CPPECC_STATIC CPPECC_TARGET_GFNI_AVX2 void rs_syndromes_gfni_avx2(const CPPECC_STRUCT RSContext* context, cppecc_s32 length, const cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_u8 syndromes[])
+{
+    cppecc_s32 numBlocks = (length + 7) >> 3;
+    cppecc_s32 head = (0 < numBlocks) ? length - ((numBlocks - 1) << 3) : 0;
+    cppecc_u8 first[8] = {0};
+    for(cppecc_s32 i = 0; i < head; ++i) {
+        first[8 - head + i] = message[i];
+    }
+    const cppecc_u8* blocks = message + head;
+    cppecc_u8 result[CPPECC_GF_NW];
+    cppecc_s32 numQuads = (numSymbols + 3) >> 2;
+    cppecc_s32 q = 0;
+    for(; (q + 4) <= numQuads; q += 4) {
+        rs_syndromes_quad_gfni_avx2(context->roots_ + 16 * q, numBlocks, first, blocks, result + 4 * q, 4);
+    }
+    switch(numQuads - q) {
+    case 1:
+        rs_syndromes_quad_gfni_avx2(context->roots_ + 16 * q, numBlocks, first, blocks, result + 4 * q, 1);
+        break;
+    case 2:
+        rs_syndromes_quad_gfni_avx2(context->roots_ + 16 * q, numBlocks, first, blocks, result + 4 * q, 2);
+        break;
+    case 3:
+        rs_syndromes_quad_gfni_avx2(context->roots_ + 16 * q, numBlocks, first, blocks, result + 4 * q, 3);
+        break;
+    default:
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        syndromes[i] = result[i];
+    }
+}
+#endif
+
+CPPECC_STATIC void rs_mul_add_region_scalar(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[])
+{
+    if(0 == coefficient) {
+        return;
+    }
+    cppecc_u32 exponent = field->log_[coefficient];
+    for(cppecc_size_t i = 0; i < size; ++i) {
+        if(0 != source[i]) {
+            cppecc_u32 sum = field->log_[source[i]] + exponent;
+            destination[i] ^= field->exp_[(CPPECC_GF_NW1 <= sum) ? sum - CPPECC_GF_NW1 : sum];
+        }
+    }
+}
+
+#if defined(CPPECC_KERNEL_SSSE3) || defined(CPPECC_KERNEL_AVX2)
+/**
+ @brief Products by a coefficient for low and high nibbles, the shuffle table of the SIMD kernels.
+ */
+CPPECC_STATIC void rs_mul_nibbles(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_u8 table[32])
+{
+    for(cppecc_u32 i = 0; i < 16; ++i) {
+        table[i] = gf_field_mul(field, coefficient, CPPECC_STATIC_CAST(cppecc_u8)(i));
+        table[16 + i] = gf_field_mul(field, coefficient, CPPECC_STATIC_CAST(cppecc_u8)(i << 4));
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC CPPECC_TARGET_SSSE3 void rs_mul_add_region_ssse3(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[])
+{
+    cppecc_u8 table[32];
+    rs_mul_nibbles(field, coefficient, table);
+    cppecc_size_t i = 0;
+    for(; (i + 16) <= size; i += 16) {
+        __m128i x = rs_mul_ssse3(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(source + i)), table);
+        __m128i* d = CPPECC_REINTERPRET_CAST(__m128i*)(destination + i);
+        _mm_storeu_si128(d, _mm_xor_si128(_mm_loadu_si128(d), x));
+    }
+    for(; i < size; ++i) {
+        destination[i] ^= table[source[i] & 0x0FU] ^ table[16 + (source[i] >> 4)];
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC CPPECC_TARGET_AVX2 void rs_mul_add_region_avx2(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[])
+{
+    cppecc_u8 table[32];
+    rs_mul_nibbles(field, coefficient, table);
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table)));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    cppecc_size_t i = 0;
+    for(; (i + 32) <= size; i += 32) {
+        __m256i x = _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(source + i));
+        __m256i product = _mm256_xor_si256(
+            _mm256_shuffle_epi8(lo, _mm256_and_si256(x, mask)),
+            _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask)));
+        __m256i* d = CPPECC_REINTERPRET_CAST(__m256i*)(destination + i);
+        _mm256_storeu_si256(d, _mm256_xor_si256(_mm256_loadu_si256(d), product));
+    }
+    for(; i < size; ++i) {
+        destination[i] ^= table[source[i] & 0x0FU] ^ table[16 + (source[i] >> 4)];
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_GFNI_AVX512)
+/**
+ @brief 64 products in an instruction, the tail is a masked load and store.
+ */
+CPPECC_STATIC CPPECC_TARGET_GFNI void rs_mul_add_region_gfni(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[])
+{
+    const __m512i matrix = _mm512_set1_epi64(CPPECC_STATIC_CAST(long long)(gf_affine_matrix(field->polynomial_, coefficient)));
+    cppecc_size_t i = 0;
+    for(; (i + 128) <= size; i += 128) {
+        __m512i x0 = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(source + i), matrix, 0);
+        __m512i x1 = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(source + i + 64), matrix, 0);
+        _mm512_storeu_si512(destination + i, _mm512_xor_si512(_mm512_loadu_si512(destination + i), x0));
+        _mm512_storeu_si512(destination + i + 64, _mm512_xor_si512(_mm512_loadu_si512(destination + i + 64), x1));
+    }
+    for(; i < size; i += 64) {
+        cppecc_size_t rest = size - i;
+        __mmask64 mask = (64 <= rest) ? ~0ULL : ((1ULL << rest) - 1ULL);
+        __m512i x = _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(mask, source + i), matrix, 0);
+        _mm512_mask_storeu_epi8(destination + i, mask, _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, destination + i), x));
+    }
+}
+#endif
+
+#if defined(CPPECC_KERNEL_GFNI_AVX2)
+/**
+ @brief 32 products in an instruction, the tail is the portable kernel.
+ */
+CPPECC_STATIC CPPECC_TARGET_GFNI_AVX2 void rs_mul_add_region_gfni_avx2(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[])
+{
+    const __m256i matrix = _mm256_set1_epi64x(CPPECC_STATIC_CAST(long long)(gf_affine_matrix(field->polynomial_, coefficient)));
+    cppecc_size_t i = 0;
+    for(; (i + 64) <= size; i += 64) {
+        __m256i x0 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(source + i)), matrix, 0);
+        __m256i x1 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(source + i + 32)), matrix, 0);
+        __m256i* d0 = CPPECC_REINTERPRET_CAST(__m256i*)(destination + i);
+        __m256i* d1 = CPPECC_REINTERPRET_CAST(__m256i*)(destination + i + 32);
+        _mm256_storeu_si256(d0, _mm256_xor_si256(_mm256_loadu_si256(d0), x0));
+        _mm256_storeu_si256(d1, _mm256_xor_si256(_mm256_loadu_si256(d1), x1));
+    }
+    for(; (i + 32) <= size; i += 32) {
+        __m256i x = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(source + i)), matrix, 0);
+        __m256i* d = CPPECC_REINTERPRET_CAST(__m256i*)(destination + i);
+        _mm256_storeu_si256(d, _mm256_xor_si256(_mm256_loadu_si256(d), x));
+    }
+    rs_mul_add_region_scalar(field, coefficient, size - i, source + i, destination + i);
+}
+#endif
+
+/**
+ @brief Sum of all symbols, that is the syndrome at alpha^0.
+ */
+CPPECC_STATIC cppecc_u8 rs_symbol_sum_scalar(cppecc_s32 size, const cppecc_u8 message[])
+{
+    cppecc_u8 s = 0;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        s ^= message[i];
+    }
+    return s;
+}
+
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC CPPECC_TARGET_SSSE3 cppecc_u8 rs_symbol_sum_fold(__m128i sum, cppecc_s32 i, cppecc_s32 size, const cppecc_u8 message[])
+{
+    for(; (i + 16) <= size; i += 16) {
+        sum = _mm_xor_si128(sum, _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(message + i)));
+    }
+    sum = _mm_xor_si128(sum, _mm_srli_si128(sum, 8));
+    sum = _mm_xor_si128(sum, _mm_srli_si128(sum, 4));
+    sum = _mm_xor_si128(sum, _mm_srli_si128(sum, 2));
+    sum = _mm_xor_si128(sum, _mm_srli_si128(sum, 1));
+    cppecc_u8 s = CPPECC_STATIC_CAST(cppecc_u8)(_mm_cvtsi128_si32(sum));
+    return s ^ rs_symbol_sum_scalar(size - i, message + i);
+}
+
+CPPECC_STATIC CPPECC_TARGET_SSSE3 cppecc_u8 rs_symbol_sum_ssse3(cppecc_s32 size, const cppecc_u8 message[])
+{
+    return rs_symbol_sum_fold(_mm_setzero_si128(), 0, size, message);
+}
+#endif
+
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC CPPECC_TARGET_AVX2 cppecc_u8 rs_symbol_sum_avx2(cppecc_s32 size, const cppecc_u8 message[])
+{
+    cppecc_s32 i = 0;
+    __m256i sum = _mm256_setzero_si256();
+    for(; (i + 32) <= size; i += 32) {
+        sum = _mm256_xor_si256(sum, _mm256_loadu_si256(CPPECC_REINTERPRET_CAST(const __m256i*)(message + i)));
+    }
+    return rs_symbol_sum_fold(_mm_xor_si128(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)), i, size, message);
+}
+#endif
+
+CPPECC_NAMESPACE_EMPTY_END
+
+void rs_encode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    rs_parity(context, size, message, message + size, numSymbols);
+}
+
+void rs_encode_scalar(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+
+    const CPPECC_STRUCT RSField* field = context->field_;
+    cppecc_u8* result = context->scratch_->temp0_;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        result[i] = message[i];
+    }
+    cppecc_u8* generator = context->generator_;
+    cppecc_s32 total = size + numSymbols;
+    for(cppecc_s32 i = size; i < total; ++i) {
+        result[i] = 0;
+    }
+
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        if(0 != result[i]) {
+            for(cppecc_s32 j = 1; j <= numSymbols; ++j) {
+                result[i + j] ^= gf_field_mul(field, generator[j], result[i]);
+            }
+        }
+    }
+    for(cppecc_s32 i = size; i < total; ++i) {
+        message[i] = result[i];
+    }
+}
+
+void rs_encode_slicing(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_s32 slices)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context->numSymbols_);
+    CPPECC_ASSERT(0 < slices && slices <= context->numSlices_);
+    rs_lfsr_slicing(context->slices_, slices, size, message, CPPECC_NULL, message + size, numSymbols);
+}
+
+void rs_interleave(cppecc_s32 count, cppecc_s32 length, const cppecc_u8* const src[], cppecc_u8 dst[])
+{
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        const cppecc_u8* s = src[i];
+        for(cppecc_s32 j = 0; j < length; ++j) {
+            dst[j * count + i] = s[j];
+        }
+    }
+}
+
+void rs_deinterleave(cppecc_s32 count, cppecc_s32 length, const cppecc_u8 src[], cppecc_u8* const dst[])
+{
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* d = dst[i];
+        for(cppecc_s32 j = 0; j < length; ++j) {
+            d[j] = src[j * count + i];
+        }
+    }
+}
+
+void rs_encode_interleaved(CPPECC_STRUCT RSContext* context, cppecc_s32 count, cppecc_s32 size, cppecc_u8 block[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context->numSymbols_);
+
+    const CPPECC_STRUCT RSKernels* kernels = rs_kernels();
+    const cppecc_s32 width = kernels->lanes_;
+    cppecc_u8* parity = block + size * count;
+    cppecc_s32 i = 0;
+    for(; (i + width) <= count; i += width) {
+        kernels->encodeLanes_(context, size, block + i, count, parity + i, numSymbols);
+    }
+    if(count <= i) {
+        return;
+    }
+    // Pad the rest lanes
+    cppecc_u8 tile[CPPECC_GF_NW * CPPECC_BATCH_LANES];
+    cppecc_s32 rest = count - i;
+    cppecc_s32 total = size + numSymbols;
+    for(cppecc_s32 j = 0; j < size; ++j) {
+        for(cppecc_s32 k = 0; k < rest; ++k) {
+            tile[j * width + k] = block[j * count + i + k];
+        }
+        for(cppecc_s32 k = rest; k < width; ++k) {
+            tile[j * width + k] = 0;
+        }
+    }
+    kernels->encodeLanes_(context, size, tile, width, tile + size * width, numSymbols);
+    for(cppecc_s32 j = size; j < total; ++j) {
+        for(cppecc_s32 k = 0; k < rest; ++k) {
+            block[j * count + i + k] = tile[j * width + k];
+        }
+    }
+}
+
+void rs_encode_batch(CPPECC_STRUCT RSContext* context, cppecc_s32 count, cppecc_s32 size, cppecc_u8* const messages[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context->numSymbols_);
+    const CPPECC_STRUCT RSKernels* kernels = rs_kernels();
+    const cppecc_s32 width = kernels->lanes_;
+    if(width <= 1) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            rs_parity(context, size, messages[i], messages[i] + size, numSymbols);
+        }
+        return;
+    }
+
+    cppecc_u8 tile[CPPECC_GF_NW * CPPECC_BATCH_LANES];
+    cppecc_u8* parity = tile + size * width;
+    for(cppecc_s32 i = 0; i < count; i += width) {
+        cppecc_s32 lanes = (count - i) < width ? (count - i) : width;
+        for(cppecc_s32 k = 0; k < lanes; ++k) {
+            const cppecc_u8* m = messages[i + k];
+            for(cppecc_s32 j = 0; j < size; ++j) {
+                tile[j * width + k] = m[j];
+            }
+        }
+        // Pad the rest lanes
+        for(cppecc_s32 k = lanes; k < width; ++k) {
+            for(cppecc_s32 j = 0; j < size; ++j) {
+                tile[j * width + k] = 0;
+            }
+        }
+        kernels->encodeLanes_(context, size, tile, width, parity, numSymbols);
+        for(cppecc_s32 k = 0; k < lanes; ++k) {
+            cppecc_u8* m = messages[i + k] + size;
+            for(cppecc_s32 j = 0; j < numSymbols; ++j) {
+                m[j] = parity[j * width + k];
+            }
+        }
+    }
+}
+
+void rs_field_forney_syndromes(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numSyndromes, const cppecc_u8 syndromes[], cppecc_s32 numErasures, const cppecc_u8 erasures[])
+{
+    for(cppecc_s32 i = 0; i < numSyndromes; ++i) {
+        result[i] = syndromes[i];
+    }
+    // Each step cancels an erasure X from S[j] = sum(Y*X^j), and the sequence becomes one shorter.
+    for(cppecc_s32 i = 0; i < numErasures; ++i) {
+        cppecc_u8 x = field->exp_[messageSize - 1 - erasures[i]];
+        cppecc_s32 size = numSyndromes - 1 - i;
+        for(cppecc_s32 j = 0; j < size; ++j) {
+            result[j] = gf_field_mul(field, result[j], x) ^ result[j + 1];
+        }
+    }
+}
+
+void rs_forney_syndromes(cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numSyndromes, const cppecc_u8 syndromes[], cppecc_s32 numErasures, const cppecc_u8 erasures[])
+{
+    rs_field_forney_syndromes(&gfdefault, result, messageSize, numSyndromes, syndromes, numErasures, erasures);
+}
+
+cppecc_s32 rs_field_erasure_locator(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numErasures, const cppecc_u8 erasures[])
+{
+    result[0] = 1;
+    for(cppecc_s32 i = 0; i < numErasures; ++i) {
+        cppecc_u8 x = field->exp_[messageSize - 1 - erasures[i]];
+        result[i + 1] = 0;
+        for(cppecc_s32 j = i + 1; 0 < j; --j) {
+            result[j] ^= gf_field_mul(field, result[j - 1], x);
+        }
+    }
+    return numErasures + 1;
+}
+
+cppecc_s32 rs_erasure_locator(cppecc_u8 result[], cppecc_s32 messageSize, cppecc_s32 numErasures, const cppecc_u8 erasures[])
+{
+    return rs_field_erasure_locator(&gfdefault, result, messageSize, numErasures, erasures);
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+CPPECC_STATIC cppecc_s32 rs_berlekamp_massey_work(const CPPECC_STRUCT RSField* field, cppecc_u8 work[], cppecc_u8 result[], cppecc_s32 numSyndromes, const cppecc_u8 syndromes[])
+{
+    cppecc_u8 b0[CPPECC_GF_NW] = {
+        0,
+        1,
+    };
+    cppecc_u8 b1[CPPECC_GF_NW] = {
+        1,
+    };
+
+    cppecc_u8* sg0 = b0;
+    cppecc_u8* sg1 = b1;
+    for(cppecc_s32 i = 0; i <= numSyndromes; ++i) {
+        work[i] = 0;
+    }
+
+    cppecc_s32 s0 = 1;
+    cppecc_s32 s1 = 0;
+
+    cppecc_s32 k = -1;
+
+    for(cppecc_s32 i = 0; i < numSyndromes; ++i) {
+        cppecc_s32 s = syndromes[i];
+        for(cppecc_s32 j = 1; j <= s1; ++j) {
+            s ^= gf_field_mul(field, sg1[j], syndromes[i - j]);
+        }
+        if(0 != s) {
+            cppecc_u8 l = field->log_[s];
+            for(cppecc_s32 j = 0; j <= i; ++j) {
+                work[j] = sg1[j] ^ gf_mulexp(field, sg0[j], l);
+            }
+            cppecc_s32 d = i - k;
+            if(s1 < d) {
+                for(cppecc_s32 j = 0; j <= s0; ++j) {
+                    sg0[j] = gf_divexp(field, sg1[j], l);
+                }
+                k = i - s1;
+                s0 = d;
+                s1 = d;
+            }
+            cppecc_u8* tmp = sg1;
+            sg1 = work;
+            work = tmp;
+        } //if(0 != s)
+        for(cppecc_s32 j = s0 - 1; 0 <= j; --j) {
+            sg0[j + 1] = sg0[j];
+        }
+        sg0[0] = 0;
+        ++s0;
+    } //for(cppecc_s32 i=0
+
+    if(0 == sg1[s1]) {
+        return -1;
+    }
+    cppecc_s32 size = s1 + 1;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        result[i] = sg1[i];
+    }
+    return size;
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+cppecc_s32 rs_modified_berlekamp_massey(CPPECC_STRUCT RSContext* context, cppecc_u8 result[], cppecc_s32 numSyndromes, const cppecc_u8 syndromes[])
+{
+    return rs_berlekamp_massey_work(context->field_, context->scratch_->temp0_, result, numSyndromes, syndromes);
+}
+
+cppecc_s32 rs_field_chien_search_two(const CPPECC_STRUCT RSField* field, cppecc_u8 result[2], cppecc_u8 start, cppecc_u8 end, cppecc_u8 a, cppecc_u8 b)
+{
+    for(cppecc_u8 i = start; i < end; ++i) {
+        cppecc_u8 z0 = field->exp_[i];
+        cppecc_u8 z1 = CPPECC_STATIC_CAST(cppecc_u8)(a) ^ z0;
+
+        if(b == gf_mulexp(field, z1, i)) {
+            cppecc_u8 index = field->log_[z1];
+            if(index <= i || end <= index) {
+                return -1;
+            }
+            result[0] = z1;
+            result[1] = z0;
+            return 2;
+        }
+    }
+    return -1;
+}
+
+cppecc_s32 rs_chien_search_two(cppecc_u8 result[2], cppecc_u8 start, cppecc_u8 end, cppecc_u8 a, cppecc_u8 b)
+{
+    return rs_field_chien_search_two(&gfdefault, result, start, end, a, b);
+}
+
+cppecc_s32 rs_field_chien_search(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_u8 size, cppecc_u8 numSigma, const cppecc_u8 sigma[])
+{
+    cppecc_u8 s0 = numSigma - 1;
+    cppecc_u8 sum = sigma[1];
+    cppecc_u8 mul = sigma[s0];
+    if(1 == s0) {
+        if(size <= field->log_[sum]) {
+            return -1;
+        }
+        result[0] = sum;
+        return 1;
+    }
+    if(2 == s0) {
+        return rs_field_chien_search_two(field, result, 0, size, sum, mul);
+    }
+
+    cppecc_u8 temp0[4];
+    cppecc_u8 index = s0 - 1;
+    for(cppecc_u8 i = 0, z = CPPECC_GF_NW1; i < size; ++i, --z) {
+        cppecc_u8 temp = 1;
+        for(cppecc_u8 j = 1, wz = z; j <= s0; ++j, wz = (wz + z) % CPPECC_GF_NW1) {
+            temp ^= gf_mulexp(field, sigma[j], wz);
+        }
+        if(0 != temp) {
+            continue;
+        }
+        cppecc_u8 p = field->exp_[i];
+        sum ^= p;
+        mul = gf_field_div(field, mul, p);
+        result[index--] = p;
+        if(1 == index) {
+            cppecc_s32 t = rs_field_chien_search_two(field, temp0, i + 1, size, sum, mul);
+            if(t < 0) {
+                return -1;
+            }
+            result[0] = temp0[0];
+            result[1] = temp0[1];
+            return s0;
+        }
+    }
+    return -1;
+}
+
+cppecc_s32 rs_chien_search(cppecc_u8 result[], cppecc_u8 size, cppecc_u8 numSigma, const cppecc_u8 sigma[])
+{
+    return rs_field_chien_search(&gfdefault, result, size, numSigma, sigma);
+}
+
+void rs_field_error_correct_forney(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u8 pos[], cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[])
+{
+    // Y = X^(1-fcr) * omega(X^-1) / sigma'(X^-1)
+    cppecc_u32 power = (CPPECC_GF_NW - field->fcr_) % CPPECC_GF_NW1;
+    for(cppecc_s32 i = 0; i < numErrors; ++i) {
+        cppecc_u8 x = field->log_[pos[i]];
+        cppecc_u8 l = CPPECC_GF_NW1 - x;
+        cppecc_u8 d = gf_sigma_dash_value(field, numSigma, sigma, l);
+        cppecc_u8 o = gf_omega_value(field, numOmega, omega, l);
+        cppecc_s32 p = length - 1 - x;
+        result[p] ^= gf_mulexp(field, gf_field_div(field, o, d), CPPECC_STATIC_CAST(cppecc_u8)((x * power) % CPPECC_GF_NW1));
+    }
+}
+
+void rs_error_correct_forney(cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u8 pos[], cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[])
+{
+    rs_field_error_correct_forney(&gfdefault, result, length, numErrors, pos, numSigma, sigma, numOmega, omega);
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_AVX2 __m256i rs_mul_avx2(__m256i x, const cppecc_u8* table)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    return _mm256_xor_si256(
+        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table))), _mm256_and_si256(x, mask)),
+        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16))), _mm256_and_si256(_mm256_srli_epi16(x, 4), mask)));
+}
+
+/**
+ @brief Same as rs_chien_registers_ssse3, for 32 positions.
+ */
+CPPECC_STATIC CPPECC_TARGET_AVX2 void rs_chien_registers_avx2(const cppecc_u8 tables[], cppecc_s32 numTerms, const cppecc_u8 coefficients[], __m256i registers[])
+{
+    const __m256i lanes = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+    for(cppecc_s32 j = 1; j <= numTerms; ++j) {
+        const cppecc_u8* table = tables + (j - 1) * 6 * 32;
+        __m256i x = _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(coefficients[j]));
+        for(cppecc_s32 f = 0; f < 5; ++f) {
+            const __m256i bit = _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(1 << f));
+            const __m256i mask = _mm256_cmpeq_epi8(_mm256_and_si256(lanes, bit), bit);
+            x = _mm256_xor_si256(x, _mm256_and_si256(mask, _mm256_xor_si256(x, rs_mul_avx2(x, table + f * 32))));
+        }
+        registers[j - 1] = x;
+    }
+}
+
+/**
+ @brief Same as rs_chien_scan_ssse3, for 32 positions in a step.
+ */
+CPPECC_STATIC CPPECC_TARGET_AVX2 cppecc_s32 rs_chien_scan_avx2(const CPPECC_STRUCT RSField* field, const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[], cppecc_u8 positions[], cppecc_u8 odds[], cppecc_u8 values[])
+{
+    (void)field;
+    __m256i s[CPPECC_GF_NW / 2];
+    __m256i w[CPPECC_GF_NW / 2];
+    rs_chien_registers_avx2(tables, numSigma - 1, sigma, s);
+    rs_chien_registers_avx2(tables, numOmega - 1, omega, w);
+
+    cppecc_s32 numRoots = 0;
+    for(cppecc_s32 i = 0; i < length; i += 32) {
+        __m256i even = _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(sigma[0]));
+        __m256i odd = _mm256_setzero_si256();
+        for(cppecc_s32 j = 1; j < numSigma; j += 2) {
+            odd = _mm256_xor_si256(odd, s[j - 1]);
+            s[j - 1] = rs_mul_avx2(s[j - 1], tables + ((j - 1) * 6 + 5) * 32);
+        }
+        for(cppecc_s32 j = 2; j < numSigma; j += 2) {
+            even = _mm256_xor_si256(even, s[j - 1]);
+            s[j - 1] = rs_mul_avx2(s[j - 1], tables + ((j - 1) * 6 + 5) * 32);
+        }
+        __m256i o = _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(omega[0]));
+        for(cppecc_s32 k = 1; k < numOmega; ++k) {
+            o = _mm256_xor_si256(o, w[k - 1]);
+            w[k - 1] = rs_mul_avx2(w[k - 1], tables + ((k - 1) * 6 + 5) * 32);
+        }
+        cppecc_u32 roots = CPPECC_STATIC_CAST(cppecc_u32)(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_xor_si256(even, odd), _mm256_setzero_si256())));
+        if((length - i) < 32) {
+            roots &= (1U << (length - i)) - 1U;
+        }
+        if(0 == roots) {
+            continue;
+        }
+        cppecc_u8 oddLanes[32];
+        cppecc_u8 omegaLanes[32];
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(oddLanes), odd);
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(omegaLanes), o);
+        for(cppecc_s32 l = 0; l < 32; ++l) {
+            if(0 == (roots & (1U << l))) {
+                continue;
+            }
+            if((numSigma - 1) <= numRoots) {
+                return CPPECC_ERROR;
+            }
+            positions[numRoots] = CPPECC_STATIC_CAST(cppecc_u8)(i + l);
+            odds[numRoots] = oddLanes[l];
+            values[numRoots] = omegaLanes[l];
+            ++numRoots;
+        }
+    }
+    return numRoots;
+}
+/**
+ @brief Same as rs_chien_evaluate_ssse3, for 32 positions in a step.
+ */
+CPPECC_STATIC CPPECC_TARGET_AVX2 void rs_chien_evaluate_avx2(const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numTerms, const cppecc_u8 sigma[], const cppecc_u8 omega[], cppecc_u8 locators[], cppecc_u8 odds[], cppecc_u8 values[])
+{
+    __m256i s[CPPECC_GF_NW / 2];
+    __m256i w[CPPECC_GF_NW / 2];
+    rs_chien_registers_avx2(tables, numTerms, sigma, s);
+    rs_chien_registers_avx2(tables, numTerms - 1, omega, w);
+
+    for(cppecc_s32 i = 0; i < length; i += 32) {
+        __m256i even = _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(sigma[0]));
+        __m256i odd = _mm256_setzero_si256();
+        for(cppecc_s32 j = 1; j <= numTerms; j += 2) {
+            odd = _mm256_xor_si256(odd, s[j - 1]);
+            s[j - 1] = rs_mul_avx2(s[j - 1], tables + ((j - 1) * 6 + 5) * 32);
+        }
+        for(cppecc_s32 j = 2; j <= numTerms; j += 2) {
+            even = _mm256_xor_si256(even, s[j - 1]);
+            s[j - 1] = rs_mul_avx2(s[j - 1], tables + ((j - 1) * 6 + 5) * 32);
+        }
+        __m256i o = _mm256_set1_epi8(CPPECC_STATIC_CAST(char)(omega[0]));
+        for(cppecc_s32 k = 1; k < numTerms; ++k) {
+            o = _mm256_xor_si256(o, w[k - 1]);
+            w[k - 1] = rs_mul_avx2(w[k - 1], tables + ((k - 1) * 6 + 5) * 32);
+        }
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(locators + i), _mm256_xor_si256(even, odd));
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(odds + i), odd);
+        _mm256_storeu_si256(CPPECC_REINTERPRET_CAST(__m256i*)(values + i), o);
+    }
+}
+
+#endif
+
+#if defined(CPPECC_KERNEL_SSSE3)
+/**
+ @brief Registers of terms 1 to numTerms of a polynomial, lane l of register j-1 is coefficients[j]*beta^(-j*l).
+
+ Registers start from coefficients[j] in all lanes, and lanes of which bit f is set are multiplied by beta^(-j*2^f), the same as rs_power_tables.
+ */
+CPPECC_STATIC CPPECC_TARGET_SSSE3 void rs_chien_registers_ssse3(const cppecc_u8 tables[], cppecc_s32 numTerms, const cppecc_u8 coefficients[], __m128i registers[])
+{
+    const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for(cppecc_s32 j = 1; j <= numTerms; ++j) {
+        const cppecc_u8* table = tables + (j - 1) * 6 * 32;
+        __m128i x = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(coefficients[j]));
+        for(cppecc_s32 f = 0; f < 4; ++f) {
+            const __m128i bit = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(1 << f));
+            const __m128i mask = _mm_cmpeq_epi8(_mm_and_si128(lanes, bit), bit);
+            x = _mm_xor_si128(x, _mm_and_si128(mask, _mm_xor_si128(x, rs_mul_ssse3(x, table + f * 32))));
+        }
+        registers[j - 1] = x;
+    }
+}
+
+/**
+ @brief Find roots of sigma at positions [0, length), and evaluate the odd terms of sigma and omega at them.
+ @param [in] field ... used only by the portable kernel
+ @param [in] tables ... chien_ of a context
+ @param [out] positions[] ... positions of roots, X = beta^position
+ @param [out] odds[] ... the odd terms of sigma at X^-1, that is X^-1*sigma'(X^-1)
+ @param [out] values[] ... omega at X^-1
+ @return number of roots, or CPPECC_ERROR if sigma has more roots than its degree
+
+ Register j keeps sigma[j]*X^-j of 16 positions, and a step multiplies it by beta^(-16*j).
+ */
+CPPECC_STATIC CPPECC_TARGET_SSSE3 cppecc_s32 rs_chien_scan_ssse3(const CPPECC_STRUCT RSField* field, const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[], cppecc_u8 positions[], cppecc_u8 odds[], cppecc_u8 values[])
+{
+    (void)field;
+    __m128i s[CPPECC_GF_NW / 2];
+    __m128i w[CPPECC_GF_NW / 2];
+    rs_chien_registers_ssse3(tables, numSigma - 1, sigma, s);
+    rs_chien_registers_ssse3(tables, numOmega - 1, omega, w);
+
+    cppecc_s32 numRoots = 0;
+    for(cppecc_s32 i = 0; i < length; i += 16) {
+        __m128i even = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(sigma[0]));
+        __m128i odd = _mm_setzero_si128();
+        for(cppecc_s32 j = 1; j < numSigma; j += 2) {
+            odd = _mm_xor_si128(odd, s[j - 1]);
+            s[j - 1] = rs_mul_ssse3(s[j - 1], tables + ((j - 1) * 6 + 4) * 32);
+        }
+        for(cppecc_s32 j = 2; j < numSigma; j += 2) {
+            even = _mm_xor_si128(even, s[j - 1]);
+            s[j - 1] = rs_mul_ssse3(s[j - 1], tables + ((j - 1) * 6 + 4) * 32);
+        }
+        __m128i o = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(omega[0]));
+        for(cppecc_s32 k = 1; k < numOmega; ++k) {
+            o = _mm_xor_si128(o, w[k - 1]);
+            w[k - 1] = rs_mul_ssse3(w[k - 1], tables + ((k - 1) * 6 + 4) * 32);
+        }
+        cppecc_u32 roots = CPPECC_STATIC_CAST(cppecc_u32)(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_xor_si128(even, odd), _mm_setzero_si128())));
+        if((length - i) < 16) {
+            roots &= (1U << (length - i)) - 1U;
+        }
+        if(0 == roots) {
+            continue;
+        }
+        cppecc_u8 oddLanes[16];
+        cppecc_u8 omegaLanes[16];
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(oddLanes), odd);
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(omegaLanes), o);
+        for(cppecc_s32 l = 0; l < 16; ++l) {
+            if(0 == (roots & (1U << l))) {
+                continue;
+            }
+            if((numSigma - 1) <= numRoots) {
+                return CPPECC_ERROR;
+            }
+            positions[numRoots] = CPPECC_STATIC_CAST(cppecc_u8)(i + l);
+            odds[numRoots] = oddLanes[l];
+            values[numRoots] = omegaLanes[l];
+            ++numRoots;
+        }
+    }
+    return numRoots;
+}
+/**
+ @brief Evaluate sigma, the odd terms of sigma and omega at all positions [0, length) without looking for roots.
+ @param [in] tables ... chien_ of a context
+ @param [in] numTerms ... degree of sigma, sigma has 'numTerms + 1' coefficients and omega has numTerms
+ @param [out] locators[] ... sigma at X^-1, the size should be length rounded up to the width of registers
+ @param [out] odds[] ... the odd terms of sigma at X^-1
+ @param [out] values[] ... omega at X^-1
+ */
+CPPECC_STATIC CPPECC_TARGET_SSSE3 void rs_chien_evaluate_ssse3(const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numTerms, const cppecc_u8 sigma[], const cppecc_u8 omega[], cppecc_u8 locators[], cppecc_u8 odds[], cppecc_u8 values[])
+{
+    __m128i s[CPPECC_GF_NW / 2];
+    __m128i w[CPPECC_GF_NW / 2];
+    rs_chien_registers_ssse3(tables, numTerms, sigma, s);
+    rs_chien_registers_ssse3(tables, numTerms - 1, omega, w);
+
+    for(cppecc_s32 i = 0; i < length; i += 16) {
+        __m128i even = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(sigma[0]));
+        __m128i odd = _mm_setzero_si128();
+        for(cppecc_s32 j = 1; j <= numTerms; j += 2) {
+            odd = _mm_xor_si128(odd, s[j - 1]);
+            s[j - 1] = rs_mul_ssse3(s[j - 1], tables + ((j - 1) * 6 + 4) * 32);
+        }
+        for(cppecc_s32 j = 2; j <= numTerms; j += 2) {
+            even = _mm_xor_si128(even, s[j - 1]);
+            s[j - 1] = rs_mul_ssse3(s[j - 1], tables + ((j - 1) * 6 + 4) * 32);
+        }
+        __m128i o = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(omega[0]));
+        for(cppecc_s32 k = 1; k < numTerms; ++k) {
+            o = _mm_xor_si128(o, w[k - 1]);
+            w[k - 1] = rs_mul_ssse3(w[k - 1], tables + ((k - 1) * 6 + 4) * 32);
+        }
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(locators + i), _mm_xor_si128(even, odd));
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(odds + i), odd);
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(values + i), o);
+    }
+}
+
+#endif
+
+/**
+ @brief Same as rs_chien_scan_ssse3, a step multiplies each term by beta^-j with the first shuffle table of the term, and omega is evaluated only at roots.
+ */
+CPPECC_STATIC cppecc_s32 rs_chien_scan_scalar(const CPPECC_STRUCT RSField* field, const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[], cppecc_u8 positions[], cppecc_u8 odds[], cppecc_u8 values[])
+{
+    cppecc_u8 terms[CPPECC_GF_NW / 2];
+    for(cppecc_s32 j = 1; j < numSigma; ++j) {
+        terms[j - 1] = sigma[j];
+    }
+    cppecc_s32 numRoots = 0;
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        cppecc_u8 even = sigma[0];
+        cppecc_u8 odd = 0;
+        for(cppecc_s32 j = 1; j < numSigma; j += 2) {
+            const cppecc_u8* table = tables + (j - 1) * 6 * 32;
+            cppecc_u8 x = terms[j - 1];
+            odd ^= x;
+            terms[j - 1] = table[x & 0x0FU] ^ table[16 + (x >> 4)];
+        }
+        for(cppecc_s32 j = 2; j < numSigma; j += 2) {
+            const cppecc_u8* table = tables + (j - 1) * 6 * 32;
+            cppecc_u8 x = terms[j - 1];
+            even ^= x;
+            terms[j - 1] = table[x & 0x0FU] ^ table[16 + (x >> 4)];
+        }
+        if(even != odd) {
+            continue;
+        }
+        if((numSigma - 1) <= numRoots) {
+            return CPPECC_ERROR;
+        }
+        // Horner's rule at X^-1 = beta^-i
+        cppecc_u8 l = CPPECC_STATIC_CAST(cppecc_u8)((CPPECC_GF_NW1 - i) % CPPECC_GF_NW1);
+        cppecc_u8 o = omega[numOmega - 1];
+        for(cppecc_s32 k = numOmega - 2; 0 <= k; --k) {
+            o = gf_mulexp(field, o, l) ^ omega[k];
+        }
+        positions[numRoots] = CPPECC_STATIC_CAST(cppecc_u8)(i);
+        odds[numRoots] = odd;
+        values[numRoots] = o;
+        ++numRoots;
+    }
+    return numRoots;
+}
+/**
+ @brief Same as rs_chien_evaluate_ssse3, the terms of sigma and omega step one position with the first shuffle tables.
+ */
+CPPECC_STATIC void rs_chien_evaluate_scalar(const cppecc_u8 tables[], cppecc_s32 length, cppecc_s32 numTerms, const cppecc_u8 sigma[], const cppecc_u8 omega[], cppecc_u8 locators[], cppecc_u8 odds[], cppecc_u8 values[])
+{
+    cppecc_u8 s[CPPECC_GF_NW / 2];
+    cppecc_u8 w[CPPECC_GF_NW / 2];
+    for(cppecc_s32 j = 1; j <= numTerms; ++j) {
+        s[j - 1] = sigma[j];
+    }
+    for(cppecc_s32 k = 1; k < numTerms; ++k) {
+        w[k - 1] = omega[k];
+    }
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        cppecc_u8 even = sigma[0];
+        cppecc_u8 odd = 0;
+        for(cppecc_s32 j = 1; j <= numTerms; ++j) {
+            const cppecc_u8* table = tables + (j - 1) * 6 * 32;
+            cppecc_u8 x = s[j - 1];
+            if(j & 1) {
+                odd ^= x;
+            } else {
+                even ^= x;
+            }
+            s[j - 1] = table[x & 0x0FU] ^ table[16 + (x >> 4)];
+        }
+        cppecc_u8 o = omega[0];
+        for(cppecc_s32 k = 1; k < numTerms; ++k) {
+            const cppecc_u8* table = tables + (k - 1) * 6 * 32;
+            cppecc_u8 x = w[k - 1];
+            o ^= x;
+            w[k - 1] = table[x & 0x0FU] ^ table[16 + (x >> 4)];
+        }
+        locators[i] = even ^ odd;
+        odds[i] = odd;
+        values[i] = o;
+    }
+}
+
+CPPECC_STATIC const CPPECC_STRUCT RSKernels rs_kernels_scalar = {0, rs_parity_slicing, CPPECC_NULL, 0, rs_chien_scan_scalar, rs_chien_evaluate_scalar, CPPECC_NULL, rs_mul_add_region_scalar, 1, rs_batch_scalar, rs_symbol_sum_scalar};
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_STATIC const CPPECC_STRUCT RSKernels rs_kernels_ssse3 = {CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3, rs_parity_ssse3, rs_syndrome_scan_ssse3, 16, rs_chien_scan_ssse3, rs_chien_evaluate_ssse3, CPPECC_NULL, rs_mul_add_region_ssse3, 16, rs_batch_ssse3, rs_symbol_sum_ssse3};
+#endif
+#if defined(CPPECC_KERNEL_AVX2)
+CPPECC_STATIC const CPPECC_STRUCT RSKernels rs_kernels_avx2 = {CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3 | CPPECC_CPU_AVX2, rs_parity_avx2, rs_syndrome_scan_avx2, CPPECC_MAX_SCAN_SIZE, rs_chien_scan_avx2, rs_chien_evaluate_avx2, CPPECC_NULL, rs_mul_add_region_avx2, 32, rs_batch_avx2, rs_symbol_sum_avx2};
+#endif
+#if defined(CPPECC_KERNEL_GFNI_AVX2)
+// The VEX encoded GFNI on AVX2 registers, for CPUs which have GFNI without AVX-512
+CPPECC_STATIC const CPPECC_STRUCT RSKernels rs_kernels_gfni_avx2 = {CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3 | CPPECC_CPU_AVX2 | CPPECC_CPU_GFNI, rs_parity_gfni_avx2, rs_syndrome_scan_avx2, CPPECC_MAX_SCAN_SIZE, rs_chien_scan_avx2, rs_chien_evaluate_avx2, rs_syndromes_gfni_avx2, rs_mul_add_region_gfni_avx2, 32, rs_batch_avx2, rs_symbol_sum_avx2};
+#endif
+#if defined(CPPECC_KERNEL_GFNI_AVX512)
+// The Chien search keeps the AVX2 kernels, its shuffle tables are already a product in an instruction
+CPPECC_STATIC const CPPECC_STRUCT RSKernels rs_kernels_gfni = {CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3 | CPPECC_CPU_AVX2 | CPPECC_CPU_AVX512BW | CPPECC_CPU_GFNI, rs_parity_gfni, rs_syndrome_scan_avx2, CPPECC_MAX_SCAN_SIZE, rs_chien_scan_avx2, rs_chien_evaluate_avx2, rs_syndromes_gfni, rs_mul_add_region_gfni, 32, rs_batch_avx2, rs_symbol_sum_avx2};
+#endif
+
+/**
+ @brief Bind the best kernels within features, which are compiled and supported by this CPU.
+
+ The tables are constant from the start, so threads which load the pointer while another one binds see either of whole tables.
+ The kernels of a level need all features of the lower levels.
+ */
+CPPECC_STATIC cppecc_u32 rs_kernels_bind(cppecc_u32 features)
+{
+    features &= rs_cpu_features();
+    const CPPECC_STRUCT RSKernels* kernels = &rs_kernels_scalar;
+#if defined(CPPECC_KERNEL_SSSE3)
+    if(0 != (features & CPPECC_CPU_SSSE3)) {
+        kernels = &rs_kernels_ssse3;
+    }
+#endif
+#if defined(CPPECC_KERNEL_AVX2)
+    if(0 != (features & CPPECC_CPU_SSSE3) && 0 != (features & CPPECC_CPU_AVX2)) {
+        kernels = &rs_kernels_avx2;
+    }
+#endif
+#if defined(CPPECC_KERNEL_GFNI_AVX2)
+    if(rs_kernels_gfni_avx2.features_ == (features & rs_kernels_gfni_avx2.features_)) {
+        kernels = &rs_kernels_gfni_avx2;
+    }
+#endif
+#if defined(CPPECC_KERNEL_GFNI_AVX512)
+    if(rs_kernels_gfni.features_ == (features & rs_kernels_gfni.features_)) {
+        kernels = &rs_kernels_gfni;
+    }
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+    // Stores of aligned pointers are atomic, and the tables need no ordering
+    *CPPECC_STATIC_CAST(const CPPECC_STRUCT RSKernels* volatile*)(&rs_kernels_) = kernels;
+#elif defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&rs_kernels_, kernels, __ATOMIC_RELEASE);
+#else
+    rs_kernels_ = kernels;
+#endif
+    return kernels->features_;
+}
+
+/**
+ @brief The bound kernels, this binds the best ones at the first call.
+ */
+CPPECC_STATIC const CPPECC_STRUCT RSKernels* rs_kernels(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    const CPPECC_STRUCT RSKernels* kernels = *CPPECC_STATIC_CAST(const CPPECC_STRUCT RSKernels* const volatile*)(&rs_kernels_);
+#elif defined(__GNUC__) || defined(__clang__)
+    const CPPECC_STRUCT RSKernels* kernels = __atomic_load_n(&rs_kernels_, __ATOMIC_ACQUIRE);
+#else
+    const CPPECC_STRUCT RSKernels* kernels = rs_kernels_;
+#endif
+    if(CPPECC_NULL == kernels) {
+        // Threads of the first calls bind the same table
+        rs_kernels_bind(~0U);
+        return rs_kernels();
+    }
+    return kernels;
+}
+
+CPPECC_STATIC void rs_kernels_initialize(void)
+{
+    rs_kernels();
+}
+
+#if defined(CPPECC_ENABLE_STATS)
+CPPECC_STATIC CPPECC_FORCEINLINE void rs_stats_stage(CPPECC_STRUCT RSScratch* scratch, cppecc_s32 stage, cppecc_u64 start)
+{
+    if(CPPECC_NULL != scratch) {
+        scratch->stats_.cycles_[stage] += CPPECC_STATS_CYCLES() - start;
+        scratch->stats_.calls_[stage] += 1;
+    }
+}
+#endif
+
+/**
+ @brief Same as rs_chien_forney, and counts stages and calls the callback of scratch if it's not null.
+ */
+CPPECC_STATIC cppecc_s32 rs_chien_forney_scratch(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(length) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numOmega <= numSigma);
+    const CPPECC_STRUCT RSField* field = context->field_;
+    cppecc_s32 numErrors = numSigma - 1;
+    if(numErrors <= 0 || (context->numSymbols_ / 2) < numErrors) {
+        return CPPECC_ERROR;
+    }
+#if defined(CPPECC_ENABLE_STATS)
+    cppecc_u64 start = CPPECC_STATS_CYCLES();
+#else
+    (void)scratch;
+#endif
+    cppecc_u8 positions[CPPECC_GF_NW / 2];
+    if(numErrors <= 2) {
+        // Roots of linear and quadratic locators are found without scanning all positions
+        if(rs_field_chien_search(field, positions, CPPECC_STATIC_CAST(cppecc_u8)(length), CPPECC_STATIC_CAST(cppecc_u8)(numSigma), sigma) < 0) {
+            return CPPECC_ERROR;
+        }
+#if defined(CPPECC_ENABLE_STATS)
+        rs_stats_stage(scratch, CPPECC_STAGE_CHIEN, start);
+        start = CPPECC_STATS_CYCLES();
+        cppecc_u8 before[2];
+        for(cppecc_s32 i = 0; i < numErrors; ++i) {
+            before[i] = result[length - 1 - field->log_[positions[i]]];
+        }
+#endif
+        rs_field_error_correct_forney(field, result, length, numErrors, positions, numSigma, sigma, numOmega, omega);
+#if defined(CPPECC_ENABLE_STATS)
+        rs_stats_stage(scratch, CPPECC_STAGE_FORNEY, start);
+        if(CPPECC_NULL != scratch && CPPECC_NULL != scratch->callback_) {
+            for(cppecc_s32 i = 0; i < numErrors; ++i) {
+                cppecc_s32 p = length - 1 - field->log_[positions[i]];
+                scratch->callback_(scratch->user_, p, before[i] ^ result[p]);
+            }
+        }
+#endif
+        return numErrors;
+    }
+
+    cppecc_u8 odds[CPPECC_GF_NW / 2];
+    cppecc_u8 values[CPPECC_GF_NW / 2];
+    cppecc_s32 numRoots = rs_kernels()->chienScan_(field, context->chien_, length, numSigma, sigma, numOmega, omega, positions, odds, values);
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_stage(scratch, CPPECC_STAGE_CHIEN, start);
+    start = CPPECC_STATS_CYCLES();
+#endif
+    if(numRoots != numErrors) {
+        return CPPECC_ERROR;
+    }
+    // Y = X^(1-fcr) * omega(X^-1) / sigma'(X^-1) = X^(-fcr) * omega(X^-1) / (X^-1*sigma'(X^-1))
+    cppecc_u32 power = (CPPECC_GF_NW1 - field->fcr_ % CPPECC_GF_NW1) % CPPECC_GF_NW1;
+    for(cppecc_s32 i = 0; i < numRoots; ++i) {
+        cppecc_s32 x = positions[i];
+        values[i] = gf_mulexp(field, gf_field_div(field, values[i], odds[i]), CPPECC_STATIC_CAST(cppecc_u8)((x * power) % CPPECC_GF_NW1));
+        result[length - 1 - x] ^= values[i];
+    }
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_stage(scratch, CPPECC_STAGE_FORNEY, start);
+    if(CPPECC_NULL != scratch && CPPECC_NULL != scratch->callback_) {
+        for(cppecc_s32 i = 0; i < numRoots; ++i) {
+            scratch->callback_(scratch->user_, length - 1 - positions[i], values[i]);
+        }
+    }
+#endif
+    return numErrors;
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+cppecc_u32 rs_cpu_features(void)
+{
+#if defined(CPPECC_ENABLE_DISPATCH)
+    cppecc_u32 regs[4];
+#    if defined(_MSC_VER)
+#        define CPPECC_CPUID(leaf, sub, r) __cpuidex(CPPECC_REINTERPRET_CAST(int*)(r), (leaf), (sub))
+#    else
+#        define CPPECC_CPUID(leaf, sub, r) __cpuid_count((leaf), (sub), (r)[0], (r)[1], (r)[2], (r)[3])
+#    endif
+    CPPECC_CPUID(0, 0, regs);
+    cppecc_u32 maxLeaf = regs[0];
+    if(maxLeaf < 1) {
+        return 0;
+    }
+    CPPECC_CPUID(1, 0, regs);
+    cppecc_u32 features = 0;
+    features |= 0 != (regs[3] & (1U << 26)) ? CPPECC_CPU_SSE2 : 0;
+    features |= 0 != (regs[2] & (1U << 9)) ? CPPECC_CPU_SSSE3 : 0;
+    // AVX registers are usable only if the OS saves them, XCR0 tells which ones
+    cppecc_u64 xcr0 = 0;
+    if(0 != (regs[2] & (1U << 27))) {
+#    if defined(_MSC_VER)
+        xcr0 = _xgetbv(0);
+#    else
+        cppecc_u32 lo;
+        cppecc_u32 hi;
+        __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        xcr0 = (CPPECC_STATIC_CAST(cppecc_u64)(hi) << 32) | lo;
+#    endif
+    }
+    if(7 <= maxLeaf) {
+        CPPECC_CPUID(7, 0, regs);
+        features |= (0 != (regs[1] & (1U << 5)) && 0x06U == (xcr0 & 0x06U)) ? CPPECC_CPU_AVX2 : 0;
+        features |= (0 != (regs[1] & (1U << 30)) && 0xE6U == (xcr0 & 0xE6U)) ? CPPECC_CPU_AVX512BW : 0;
+        features |= 0 != (regs[2] & (1U << 8)) ? CPPECC_CPU_GFNI : 0;
+    }
+#    undef CPPECC_CPUID
+    return features;
+#else
+    // Without runtime dispatch, the target of the compiler is assumed
+    cppecc_u32 features = 0;
+#    if defined(CPPECC_ENABLE_SSSE3)
+    features |= CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3;
+#    endif
+#    if defined(CPPECC_ENABLE_AVX2)
+    features |= CPPECC_CPU_AVX2;
+#    endif
+#    if defined(CPPECC_KERNEL_GFNI_AVX512)
+    features |= CPPECC_CPU_AVX512BW;
+#    endif
+#    if defined(CPPECC_KERNEL_GFNI)
+    features |= CPPECC_CPU_GFNI;
+#    endif
+    return features;
+#endif
+}
+
+cppecc_u32 rs_select_kernels(cppecc_u32 features)
+{
+    return rs_kernels_bind(features);
+}
+
+cppecc_u32 rs_selected_kernels(void)
+{
+    return rs_kernels()->features_;
+}
+
+void gf_mul_add_region(const CPPECC_STRUCT RSField* field, cppecc_u8 coefficient, cppecc_size_t size, const cppecc_u8 source[], cppecc_u8 destination[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    CPPECC_ASSERT(0 == size || (CPPECC_NULL != source && CPPECC_NULL != destination));
+    rs_kernels()->mulAddRegion_(field, coefficient, size, source, destination);
+}
+
+cppecc_s32 rs_chien_forney(const CPPECC_STRUCT RSContext* context, cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[])
+{
+    return rs_chien_forney_scratch(context, CPPECC_NULL, result, length, numSigma, sigma, numOmega, omega);
+}
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+/**
+ @brief 0xFF if x is not zero, otherwise 0.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE cppecc_u8 gf_mask_nonzero(cppecc_u32 x)
+{
+    return CPPECC_STATIC_CAST(cppecc_u8)((0U - x) >> 24);
+}
+
+/**
+ @brief Same as gf_field_mul without branches, zeros are masked after the lookup.
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE cppecc_u8 gf_mul_masked(const CPPECC_STRUCT RSField* field, cppecc_u8 a, cppecc_u8 b)
+{
+    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_u32)(field->log_[a]) + field->log_[b];
+    sum -= CPPECC_GF_NW1 & (0U - ((CPPECC_GF_NW1 - 1U - sum) >> 31));
+    return field->exp_[sum] & gf_mask_nonzero(a) & gf_mask_nonzero(b);
+}
+
+/**
+ @brief Inversionless Berlekamp-Massey with exactly numSyndromes iterations.
+ @param [out] result[] ... sigma from x^0, the size should be 'numSyndromes + 1'. sigma is scaled by a nonzero constant.
+ @return degree of sigma
+
+ Each iteration updates sigma = gamma*sigma + delta*x*B, and B and gamma are replaced with masks when 'delta != 0' and '2L <= r'.
+ */
+CPPECC_STATIC cppecc_s32 rs_berlekamp_massey_constant(const CPPECC_STRUCT RSField* field, cppecc_u8 result[], cppecc_s32 numSyndromes, const cppecc_u8 syndromes[])
+{
+    cppecc_u8 b[CPPECC_GF_NW + 1];
+    for(cppecc_s32 i = 0; i <= numSyndromes; ++i) {
+        result[i] = 0;
+        b[i] = 0;
+    }
+    result[0] = 1;
+    b[0] = 1;
+    cppecc_u8 gamma = 1;
+    cppecc_u32 l = 0;
+    for(cppecc_s32 r = 0; r < numSyndromes; ++r) {
+        cppecc_u8 delta = 0;
+        for(cppecc_s32 j = 0; j <= r; ++j) {
+            delta ^= gf_mul_masked(field, result[j], syndromes[r - j]);
+        }
+        // (delta != 0) && (2L <= r)
+        cppecc_u8 swap = gf_mask_nonzero(delta) & CPPECC_STATIC_CAST(cppecc_u8)(0U - ((2U * l - CPPECC_STATIC_CAST(cppecc_u32)(r) - 1U) >> 31));
+        for(cppecc_s32 j = numSyndromes; 0 < j; --j) {
+            cppecc_u8 s = result[j];
+            result[j] = gf_mul_masked(field, gamma, s) ^ gf_mul_masked(field, delta, b[j - 1]);
+            b[j] = b[j - 1] ^ (swap & (s ^ b[j - 1]));
+        }
+        cppecc_u8 s = result[0];
+        result[0] = gf_mul_masked(field, gamma, s);
+        b[0] = swap & s;
+        gamma ^= swap & (gamma ^ delta);
+        cppecc_u32 mask = 0U - (swap & 1U);
+        l ^= mask & (l ^ (CPPECC_STATIC_CAST(cppecc_u32)(r) + 1U - l));
+    }
+    return CPPECC_STATIC_CAST(cppecc_s32)(l);
+}
+
+/**
+ @brief Syndromes from the remainder of a received message, message(beta^(fcr+i)) = remainder(beta^(fcr+i)).
+ */
+CPPECC_STATIC void rs_remainder_syndromes(const CPPECC_STRUCT RSField* field, cppecc_s32 numSymbols, const cppecc_u8 remainder[], cppecc_u8 syndromes[])
+{
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        syndromes[i] = gf_field_poly_eval(field, numSymbols, remainder, field->exp_[(field->fcr_ + i) % CPPECC_GF_NW1]);
+    }
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+
+cppecc_s32 rs_syndromes(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], cppecc_s32 numSymbols, cppecc_u8 syndromes[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+
+    const CPPECC_STRUCT RSKernels* kernels = rs_kernels();
+    if(0 != rs_has_syndromes(kernels, context)) {
+        kernels->syndromes_(context, size + numSymbols, message, numSymbols, syndromes);
+        cppecc_u8 dirty = 0;
+        for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+            dirty |= syndromes[i];
+        }
+        return 0 != dirty ? 1 : 0;
+    }
+    // message(x) = q(x)*g(x) + r(x), and g(beta^(fcr+i)) = 0, so message(beta^(fcr+i)) = r(beta^(fcr+i)).
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    rs_parity(context, size, message, remainder, numSymbols);
+    const cppecc_u8* parity = message + size;
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        remainder[i] ^= parity[i];
+        hasError |= remainder[i];
+    }
+    if(0 == hasError) {
+        for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+            syndromes[i] = 0;
+        }
+        return 0;
+    }
+    rs_remainder_syndromes(context->field_, numSymbols, remainder, syndromes);
+    return 1;
+}
+
+cppecc_s32 rs_check(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, const cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    if(numSymbols <= 0) {
+        return 0;
+    }
+    if(1 == numSymbols && 0 == context->field_->fcr_) {
+        // The generation polynomial is (x + 1)
+        return 0 != rs_kernels()->symbolSum_(size + numSymbols, message) ? 1 : 0;
+    }
+    const CPPECC_STRUCT RSKernels* kernels = rs_kernels();
+    if(0 != rs_has_syndromes(kernels, context)) {
+        cppecc_u8 syndromes[CPPECC_GF_NW];
+        kernels->syndromes_(context, size + numSymbols, message, numSymbols, syndromes);
+        cppecc_u8 dirty = 0;
+        for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+            dirty |= syndromes[i];
+        }
+        return 0 != dirty ? 1 : 0;
+    }
+    // The cost of scanning grows with the number of syndromes, but the encoder's is almost constant.
+    if(numSymbols <= kernels->scanSymbols_) {
+        return 0 != kernels->scan_(context->powers_, size + numSymbols, message, numSymbols) ? 1 : 0;
+    }
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    rs_parity(context, size, message, remainder, numSymbols);
+    const cppecc_u8* parity = message + size;
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        hasError |= remainder[i] ^ parity[i];
+    }
+    return 0 != hasError ? 1 : 0;
+}
+
+cppecc_s32 rs_decode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    return rs_decode_scratch(context, context->scratch_, size, message, numSymbols);
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+/**
+ @brief The locator, the Chien search and Forney's formula for syndromes which are not all zero, corrections are added to message.
+ */
+CPPECC_STATIC cppecc_s32 rs_correct_syndromes(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, cppecc_u8 message[], cppecc_s32 messageSize, cppecc_s32 numSymbols, const cppecc_u8 syndromes[])
+{
+    const CPPECC_STRUCT RSField* field = context->field_;
+#if defined(CPPECC_ENABLE_STATS)
+    cppecc_u64 start = CPPECC_STATS_CYCLES();
+#endif
+    cppecc_u8* sigma = scratch->sigma_;
+    cppecc_s32 numSigma = rs_berlekamp_massey_work(field, scratch->temp0_, sigma, numSymbols, syndromes);
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_stage(scratch, CPPECC_STAGE_LOCATOR, start);
+#endif
+    if(numSigma < 0) {
+        return CPPECC_ERROR;
+    }
+
+    cppecc_u8* omega = scratch->omega_;
+    cppecc_s32 numOmega = gf_field_poly_mul_len(field, omega, numSymbols, syndromes, numSigma, sigma, numSigma - 1);
+    return rs_chien_forney_scratch(context, scratch, message, messageSize, numSigma, sigma, numOmega, omega);
+}
+
+CPPECC_STATIC cppecc_s32 rs_decode_stages(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    cppecc_s32 messageSize = size + numSymbols;
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(messageSize) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+
+    cppecc_u8* syndromes = scratch->syndromes_;
+#if defined(CPPECC_ENABLE_STATS)
+    cppecc_u64 start = CPPECC_STATS_CYCLES();
+    cppecc_s32 dirty = rs_syndromes(context, size, message, numSymbols, syndromes);
+    rs_stats_stage(scratch, CPPECC_STAGE_SYNDROMES, start);
+    if(0 == dirty) {
+        return 0;
+    }
+#else
+    if(0 == rs_syndromes(context, size, message, numSymbols, syndromes)) {
+        return 0;
+    }
+#endif
+    return rs_correct_syndromes(context, scratch, message, messageSize, numSymbols, syndromes);
+}
+
+/**
+ @brief Count a decoded codeword in the stats of scratch.
+ @return result as it is
+ */
+CPPECC_STATIC cppecc_s32 rs_stats_word(CPPECC_STRUCT RSScratch* scratch, cppecc_s32 result)
+{
+#if defined(CPPECC_ENABLE_STATS)
+    scratch->stats_.words_ += 1;
+    if(result < 0) {
+        scratch->stats_.uncorrectable_ += 1;
+    } else {
+        scratch->stats_.corrected_[result] += 1;
+    }
+#else
+    (void)scratch;
+#endif
+    return result;
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+cppecc_s32 rs_decode_scratch(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    return rs_stats_word(scratch, rs_decode_stages(context, scratch, size, message, numSymbols));
+}
+cppecc_s32 rs_decode_constant(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+{
+    cppecc_s32 length = size + numSymbols;
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(length) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    const CPPECC_STRUCT RSField* field = context->field_;
+    cppecc_s32 maxErrors = numSymbols / 2;
+
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_u8 syndromes[CPPECC_GF_NW];
+    rs_parity(context, size, message, remainder, numSymbols);
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        remainder[i] ^= message[size + i];
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        cppecc_u8 x = field->exp_[(field->fcr_ + i) % CPPECC_GF_NW1];
+        cppecc_u8 y = remainder[0];
+        for(cppecc_s32 k = 1; k < numSymbols; ++k) {
+            y = gf_mul_masked(field, y, x) ^ remainder[k];
+        }
+        syndromes[i] = y;
+    }
+
+    cppecc_u8 sigma[CPPECC_GF_NW + 1];
+    cppecc_u8 omega[CPPECC_GF_NW / 2];
+    cppecc_s32 numErrors = rs_berlekamp_massey_constant(field, sigma, numSymbols, syndromes);
+    // omega = syndromes * sigma mod x^maxErrors
+    for(cppecc_s32 k = 0; k < maxErrors; ++k) {
+        cppecc_u8 o = 0;
+        for(cppecc_s32 j = 0; j <= k; ++j) {
+            o ^= gf_mul_masked(field, sigma[j], syndromes[k - j]);
+        }
+        omega[k] = o;
+    }
+
+    cppecc_u8 locators[CPPECC_GF_NW];
+    cppecc_u8 odds[CPPECC_GF_NW];
+    cppecc_u8 values[CPPECC_GF_NW];
+    if(0 < maxErrors) {
+        rs_kernels()->chienEvaluate_(context->chien_, length, maxErrors, sigma, omega, locators, odds, values);
+    } else {
+        for(cppecc_s32 i = 0; i < length; ++i) {
+            locators[i] = sigma[0];
+            odds[i] = 0;
+            values[i] = 0;
+        }
+    }
+
+    // Y = X^(-fcr) * omega(X^-1) / (X^-1*sigma'(X^-1)) at roots, and 0 at others
+    cppecc_u32 power = (CPPECC_GF_NW1 - field->fcr_ % CPPECC_GF_NW1) % CPPECC_GF_NW1;
+    cppecc_u32 exponent = 0;
+    cppecc_u32 numRoots = 0;
+    cppecc_u8 fail = 0;
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        cppecc_u8 root = CPPECC_STATIC_CAST(cppecc_u8)(~gf_mask_nonzero(locators[i]));
+        cppecc_u32 e = exponent + field->log_[values[i]] + (CPPECC_GF_NW1 - field->log_[odds[i]]);
+        e -= CPPECC_GF_NW1 & (0U - ((CPPECC_GF_NW1 - 1U - e) >> 31));
+        e -= CPPECC_GF_NW1 & (0U - ((CPPECC_GF_NW1 - 1U - e) >> 31));
+        remainder[i] = field->exp_[e] & gf_mask_nonzero(values[i]) & root;
+        fail |= root & CPPECC_STATIC_CAST(cppecc_u8)(~gf_mask_nonzero(odds[i]));
+        numRoots += root & 1U;
+        exponent += power;
+        exponent -= CPPECC_GF_NW1 & (0U - ((CPPECC_GF_NW1 - 1U - exponent) >> 31));
+    }
+
+    // Corrections are applied only when sigma has as many distinct roots as its degree
+    cppecc_u32 count = CPPECC_STATIC_CAST(cppecc_u32)(numErrors);
+    cppecc_u32 invalid = (0U - ((count ^ numRoots) | (fail & 1U) | ((CPPECC_STATIC_CAST(cppecc_u32)(maxErrors) - count) >> 31))) >> 31;
+    cppecc_u8 mask = CPPECC_STATIC_CAST(cppecc_u8)(invalid - 1U);
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        message[length - 1 - i] ^= remainder[i] & mask;
+    }
+    cppecc_u32 result = (count & (0U - (mask & 1U))) | (CPPECC_STATIC_CAST(cppecc_u32)(CPPECC_ERROR) & (0U - invalid));
+    return CPPECC_STATIC_CAST(cppecc_s32)(result);
+}
+
+
+cppecc_s32 rs_decode_erasures(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols, const cppecc_u8 erasures[], cppecc_s32 numErasures)
+{
+    cppecc_s32 messageSize = size + numSymbols;
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(messageSize) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    if(numErasures <= 0) {
+        return rs_decode(context, size, message, numSymbols);
+    }
+    if(numSymbols < numErasures) {
+        return CPPECC_ERROR;
+    }
+    cppecc_u8 erased[CPPECC_GF_NW];
+    for(cppecc_s32 i = 0; i < messageSize; ++i) {
+        erased[i] = 0;
+    }
+    for(cppecc_s32 i = 0; i < numErasures; ++i) {
+        if(messageSize <= erasures[i] || 0 != erased[erasures[i]]) {
+            return CPPECC_ERROR;
+        }
+        erased[erasures[i]] = 1;
+    }
+
+    const CPPECC_STRUCT RSField* field = context->field_;
+    cppecc_u8* syndromes = context->scratch_->syndromes_;
+    if(0 == rs_syndromes(context, size, message, numSymbols, syndromes)) {
+        return 0;
+    }
+
+    // Find unknown errors from the syndromes without erasures
+    cppecc_u8 forneySyndromes[CPPECC_GF_NW];
+    rs_field_forney_syndromes(field, forneySyndromes, messageSize, numSymbols, syndromes, numErasures, erasures);
+    cppecc_s32 numForneySyndromes = numSymbols - numErasures;
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 i = 0; i < numForneySyndromes; ++i) {
+        hasError |= forneySyndromes[i];
+    }
+
+    cppecc_u8* errorPositions = context->scratch_->errorPositions_;
+    cppecc_u8* sigma = context->scratch_->sigma_;
+    cppecc_s32 numSigma = 1;
+    cppecc_s32 numErrorPositions = 0;
+    sigma[0] = 1;
+    if(0 != hasError) {
+        numSigma = rs_modified_berlekamp_massey(context, sigma, numForneySyndromes, forneySyndromes);
+        if(numSigma < 0 || numForneySyndromes < 2 * (numSigma - 1)) {
+            return CPPECC_ERROR;
+        }
+        if(1 < numSigma) {
+            numErrorPositions = rs_field_chien_search(field, errorPositions + numErasures, CPPECC_STATIC_CAST(cppecc_u8)(messageSize), CPPECC_STATIC_CAST(cppecc_u8)(numSigma), sigma);
+            if(numErrorPositions != (numSigma - 1)) {
+                return CPPECC_ERROR;
+            }
+        }
+    }
+    // Unknown errors are not at erased positions, otherwise the locators have a common root
+    for(cppecc_s32 i = 0; i < numErrorPositions; ++i) {
+        if(0 != erased[messageSize - 1 - field->log_[errorPositions[numErasures + i]]]) {
+            return CPPECC_ERROR;
+        }
+    }
+    for(cppecc_s32 i = 0; i < numErasures; ++i) {
+        errorPositions[i] = field->exp_[messageSize - 1 - erasures[i]];
+    }
+
+    // Errata locator is the product of the erasure locator and the error locator
+    cppecc_u8 gamma[CPPECC_GF_NW];
+    cppecc_u8 psi[CPPECC_GF_NW + 1];
+    cppecc_s32 numGamma = rs_field_erasure_locator(field, gamma, messageSize, numErasures, erasures);
+    cppecc_s32 numPsi = gf_field_poly_mul(field, psi, numGamma, gamma, numSigma, sigma);
+    cppecc_u8* omega = context->scratch_->omega_;
+    cppecc_s32 numOmega = gf_field_poly_mul_len(field, omega, numSymbols, syndromes, numPsi, psi, numPsi - 1);
+
+    // Corrections are made in a zero codeword, and applied only when they explain all of the syndromes
+    cppecc_s32 numErrata = numErasures + numErrorPositions;
+    cppecc_u8 errata[CPPECC_GF_NW];
+    cppecc_u8 errataSyndromes[CPPECC_GF_NW];
+    for(cppecc_s32 i = 0; i < messageSize; ++i) {
+        errata[i] = 0;
+    }
+    rs_field_error_correct_forney(field, errata, messageSize, numErrata, errorPositions, numPsi, psi, numOmega, omega);
+    rs_syndromes(context, size, errata, numSymbols, errataSyndromes);
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        if(errataSyndromes[i] != syndromes[i]) {
+            return CPPECC_ERROR;
+        }
+    }
+    for(cppecc_s32 i = 0; i < messageSize; ++i) {
+        message[i] ^= errata[i];
+    }
+    return numErrata;
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+/**
+ @brief Remainder of the concatenation of segments, the LFSR continues from one segment to the next.
+ @return total length of segments
+ */
+CPPECC_STATIC cppecc_s32 rs_segments_parity(const CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSSegment segments[], cppecc_s32 numSegments, cppecc_u8 remainder[], cppecc_s32 numSymbols)
+{
+    cppecc_s32 size = 0;
+    for(cppecc_s32 i = 0; i < numSegments; ++i) {
+        cppecc_s32 length = CPPECC_STATIC_CAST(cppecc_s32)(segments[i].length_);
+        if(0 == length) {
+            continue;
+        }
+        CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + length + numSymbols) < CPPECC_GF_NW);
+        const cppecc_u8* data = CPPECC_STATIC_CAST(const cppecc_u8*)(segments[i].base_);
+        if(0 == size) {
+            rs_parity(context, length, data, remainder, numSymbols);
+        } else {
+            rs_parity_continue(context, length, data, remainder, numSymbols);
+        }
+        size += length;
+    }
+    if(0 == size) {
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            remainder[k] = 0;
+        }
+    }
+    return size;
+}
+
+CPPECC_STATIC cppecc_s32 rs_decode_segments(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, const CPPECC_STRUCT RSSegment segments[], cppecc_s32 numSegments, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+#if defined(CPPECC_ENABLE_STATS)
+    cppecc_u64 start = CPPECC_STATS_CYCLES();
+#endif
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    cppecc_s32 size = rs_segments_parity(context, segments, numSegments, remainder, numSymbols);
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        remainder[i] ^= parity[i];
+        hasError |= remainder[i];
+    }
+    cppecc_u8* syndromes = scratch->syndromes_;
+    if(0 != hasError) {
+        rs_remainder_syndromes(context->field_, numSymbols, remainder, syndromes);
+    }
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_stage(scratch, CPPECC_STAGE_SYNDROMES, start);
+#endif
+    if(0 == hasError) {
+        return 0;
+    }
+
+    // Corrections are made in a zero codeword, then added to the segments which hold their positions
+    cppecc_s32 length = size + numSymbols;
+    cppecc_u8 errors[CPPECC_GF_NW];
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        errors[i] = 0;
+    }
+    cppecc_s32 result = rs_correct_syndromes(context, scratch, errors, length, numSymbols, syndromes);
+    if(result <= 0) {
+        return result;
+    }
+    const cppecc_u8* error = errors;
+    for(cppecc_s32 i = 0; i < numSegments; ++i) {
+        cppecc_u8* data = CPPECC_STATIC_CAST(cppecc_u8*)(segments[i].base_);
+        for(cppecc_size_t j = 0; j < segments[i].length_; ++j) {
+            data[j] ^= error[j];
+        }
+        error += segments[i].length_;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i] ^= error[i];
+    }
+    return result;
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+void rs_encode_parity(const CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSSegment segments[], cppecc_s32 numSegments, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    rs_segments_parity(context, segments, numSegments, parity, numSymbols);
+}
+
+cppecc_s32 rs_decode_parity(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSSegment segments[], cppecc_s32 numSegments, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    return rs_stats_word(context->scratch_, rs_decode_segments(context, context->scratch_, segments, numSegments, parity, numSymbols));
+}
+
+void rs_encoder_init(CPPECC_STRUCT RSEncoder* encoder, const CPPECC_STRUCT RSContext* context, cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != encoder);
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    encoder->context_ = context;
+    encoder->numSymbols_ = numSymbols;
+    encoder->size_ = 0;
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        encoder->remainder_[k] = 0;
+    }
+}
+
+void rs_encoder_update(CPPECC_STRUCT RSEncoder* encoder, const cppecc_u8 data[], cppecc_size_t size)
+{
+    CPPECC_ASSERT(CPPECC_NULL != encoder);
+    if(0 == size) {
+        return;
+    }
+    cppecc_s32 length = CPPECC_STATIC_CAST(cppecc_s32)(size);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(encoder->size_ + length + encoder->numSymbols_) < CPPECC_GF_NW);
+    // The first piece starts from zeros, that the kernels take without a seed
+    if(0 == encoder->size_) {
+        rs_parity(encoder->context_, length, data, encoder->remainder_, encoder->numSymbols_);
+    } else {
+        rs_parity_continue(encoder->context_, length, data, encoder->remainder_, encoder->numSymbols_);
+    }
+    encoder->size_ += length;
+}
+
+void rs_encoder_final(const CPPECC_STRUCT RSEncoder* encoder, cppecc_u8 parity[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != encoder);
+    for(cppecc_s32 k = 0; k < encoder->numSymbols_; ++k) {
+        parity[k] = encoder->remainder_[k];
+    }
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+/**
+ @brief The table of positions of the context, it's made at the first call of the delta API.
+ @return The table, or null if allocation failed.
+
+ Threads of the first calls may make it at the same time, the first one is kept and the others are freed.
+ */
+CPPECC_STATIC const cppecc_u8* rs_context_deltas(const CPPECC_STRUCT RSContext* context)
+{
+    cppecc_u8** slot = CPPECC_CONST_CAST(cppecc_u8**)(&context->deltas_);
+#if defined(_MSC_VER) && !defined(__clang__)
+    cppecc_u8* deltas = *CPPECC_STATIC_CAST(cppecc_u8* const volatile*)(slot);
+#elif defined(__GNUC__) || defined(__clang__)
+    cppecc_u8* deltas = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+#else
+    cppecc_u8* deltas = *slot;
+#endif
+    if(CPPECC_NULL != deltas) {
+        return deltas;
+    }
+    cppecc_s32 numSymbols = context->numSymbols_;
+    cppecc_s32 numRows = CPPECC_STATIC_CAST(cppecc_s32)(CPPECC_GF_NW1) - numSymbols;
+    deltas = CPPECC_STATIC_CAST(cppecc_u8*)(CPPECC_MALLOC(CPPECC_STATIC_CAST(cppecc_size_t)(numRows * numSymbols)));
+    if(CPPECC_NULL == deltas) {
+        return CPPECC_NULL;
+    }
+    rs_delta_tables(context->field_, numSymbols, numRows, deltas, context->generator_);
+#if defined(_MSC_VER) && !defined(__clang__)
+    cppecc_u8* current = CPPECC_STATIC_CAST(cppecc_u8*)(_InterlockedCompareExchangePointer(CPPECC_REINTERPRET_CAST(void* volatile*)(slot), deltas, CPPECC_NULL));
+#elif defined(__GNUC__) || defined(__clang__)
+    cppecc_u8* current = CPPECC_NULL;
+    __atomic_compare_exchange_n(slot, &current, deltas, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#else
+    cppecc_u8* current = *slot;
+    *slot = (CPPECC_NULL == current) ? deltas : current;
+#endif
+    if(CPPECC_NULL != current) {
+        CPPECC_FREE(deltas);
+        return current;
+    }
+    return deltas;
+}
+
+/**
+ @brief Add a row of the tables of positions multiplied by coefficient to parity.
+
+ The vector kernels make a table or a matrix for each coefficient, that costs more than they save for short rows.
+ */
+CPPECC_STATIC void rs_mul_add_row(const CPPECC_STRUCT RSContext* context, const cppecc_u8* deltas, cppecc_u8 coefficient, cppecc_s32 e, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    const cppecc_u8* row = deltas + e * numSymbols;
+    if(numSymbols < 64) {
+        rs_mul_add_region_scalar(context->field_, coefficient, CPPECC_STATIC_CAST(cppecc_size_t)(numSymbols), row, parity);
+    } else {
+        rs_kernels()->mulAddRegion_(context->field_, coefficient, CPPECC_STATIC_CAST(cppecc_size_t)(numSymbols), row, parity);
+    }
+}
+
+/**
+ @brief Add remainder(x)*x^distance mod generator to parity, that is the remainder of a part which is followed by 'distance' symbols in a message.
+
+ Coefficient k of the remainder is at the degree 'numSymbols - 1 - k + distance'. The ones at numSymbols or higher are rows of the tables, the others stay.
+ */
+CPPECC_STATIC void rs_parity_shift(const CPPECC_STRUCT RSContext* context, const cppecc_u8 remainder[], cppecc_s32 distance, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    const cppecc_u8* deltas = rs_context_deltas(context);
+    if(CPPECC_NULL == deltas) {
+        // Without the table, the LFSR continues from the remainder over 'distance' zeros
+        cppecc_u8 zeros[CPPECC_GF_NW] = {0};
+        cppecc_u8 shifted[CPPECC_GF_NW];
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            shifted[k] = remainder[k];
+        }
+        rs_parity_continue(context, distance, zeros, shifted, numSymbols);
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            parity[k] ^= shifted[k];
+        }
+        return;
+    }
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        if(0 == remainder[k]) {
+            continue;
+        }
+        cppecc_s32 e = distance - 1 - k;
+        if(0 <= e) {
+            rs_mul_add_row(context, deltas, remainder[k], e, parity, numSymbols);
+        } else {
+            parity[k - distance] ^= remainder[k];
+        }
+    }
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+void rs_update_parity(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_s32 offset, const cppecc_u8 oldBytes[], const cppecc_u8 newBytes[], cppecc_s32 length, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    CPPECC_ASSERT(0 <= offset && 0 <= length && (offset + length) <= size);
+    // A row costs numSymbols products, and encoding the difference costs about a step of the kernels for each symbol and one shift
+    const cppecc_u8* deltas = (length < numSymbols) ? rs_context_deltas(context) : CPPECC_NULL;
+    if(CPPECC_NULL != deltas) {
+        for(cppecc_s32 i = 0; i < length; ++i) {
+            cppecc_u8 delta = oldBytes[i] ^ newBytes[i];
+            if(0 != delta) {
+                cppecc_s32 e = size - 1 - offset - i;
+                rs_mul_add_row(context, deltas, delta, e, parity, numSymbols);
+            }
+        }
+        return;
+    }
+    cppecc_u8 delta[CPPECC_GF_NW];
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        delta[i] = oldBytes[i] ^ newBytes[i];
+    }
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    rs_parity(context, length, delta, remainder, numSymbols);
+    rs_parity_shift(context, remainder, size - offset - length, parity, numSymbols);
+}
+
+void rs_encode_chunk(const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_s32 offset, const cppecc_u8 chunk[], cppecc_s32 length, cppecc_u8 parity[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    CPPECC_ASSERT(0 <= offset && 0 <= length && (offset + length) <= size);
+    cppecc_u8 remainder[CPPECC_GF_NW];
+    rs_parity(context, length, chunk, remainder, numSymbols);
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        parity[k] = 0;
+    }
+    rs_parity_shift(context, remainder, size - offset - length, parity, numSymbols);
+}
+
+void rs_combine_parity(cppecc_s32 numSymbols, cppecc_u8 parity[], const cppecc_u8 chunkParity[])
+{
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        parity[k] ^= chunkParity[k];
+    }
+}
+
+void rs_decoder_init(CPPECC_STRUCT RSDecoder* decoder, const CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != decoder);
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(0 <= size && CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    decoder->context_ = context;
+    decoder->size_ = size;
+    decoder->numSymbols_ = numSymbols;
+    decoder->received_ = 0;
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        decoder->remainder_[k] = 0;
+    }
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_reset(&decoder->scratch_);
+#endif
+}
+
+void rs_decoder_update(CPPECC_STRUCT RSDecoder* decoder, const cppecc_u8 data[], cppecc_size_t size)
+{
+    CPPECC_ASSERT(CPPECC_NULL != decoder);
+    CPPECC_ASSERT(size <= CPPECC_STATIC_CAST(cppecc_size_t)(decoder->size_ + decoder->numSymbols_ - decoder->received_));
+    cppecc_s32 length = CPPECC_STATIC_CAST(cppecc_s32)(size);
+    if(decoder->received_ < decoder->size_ && 0 < length) {
+        cppecc_s32 count = (length < (decoder->size_ - decoder->received_)) ? length : decoder->size_ - decoder->received_;
+        if(0 == decoder->received_) {
+            rs_parity(decoder->context_, count, data, decoder->remainder_, decoder->numSymbols_);
+        } else {
+            rs_parity_continue(decoder->context_, count, data, decoder->remainder_, decoder->numSymbols_);
+        }
+        data += count;
+        length -= count;
+        decoder->received_ += count;
+    }
+    cppecc_u8* parity = decoder->parity_ + (decoder->received_ - decoder->size_);
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        parity[i] = data[i];
+    }
+    decoder->received_ += length;
+}
+
+cppecc_s32 rs_decoder_final(CPPECC_STRUCT RSDecoder* decoder, cppecc_u8 positions[], cppecc_u8 values[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != decoder);
+    CPPECC_ASSERT(decoder->received_ == (decoder->size_ + decoder->numSymbols_));
+    const CPPECC_STRUCT RSContext* context = decoder->context_;
+    CPPECC_STRUCT RSScratch* scratch = &decoder->scratch_;
+    cppecc_s32 numSymbols = decoder->numSymbols_;
+    cppecc_u8* remainder = decoder->remainder_;
+    cppecc_u8 hasError = 0;
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        remainder[i] ^= decoder->parity_[i];
+        hasError |= remainder[i];
+    }
+    if(0 == hasError) {
+        return rs_stats_word(scratch, 0);
+    }
+    rs_remainder_syndromes(context->field_, numSymbols, remainder, scratch->syndromes_);
+
+    // Corrections are made in a zero codeword, and its non-zero symbols are the errors
+    cppecc_s32 length = decoder->size_ + numSymbols;
+    cppecc_u8 errors[CPPECC_GF_NW];
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        errors[i] = 0;
+    }
+    cppecc_s32 result = rs_correct_syndromes(context, scratch, errors, length, numSymbols, scratch->syndromes_);
+    if(0 < result) {
+        cppecc_s32 count = 0;
+        for(cppecc_s32 i = 0; i < length && count < result; ++i) {
+            if(0 != errors[i]) {
+                positions[count] = CPPECC_STATIC_CAST(cppecc_u8)(i);
+                values[count] = errors[i];
+                ++count;
+            }
+        }
+        result = count;
+    }
+    return rs_stats_word(scratch, result);
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+// Codes which rs_code_acquire made, they are searched by the field and numSymbols
+CPPECC_STATIC CPPECC_STRUCT RSCode* rs_codes_ = CPPECC_NULL;
+#if defined(_MSC_VER) && !defined(__clang__)
+CPPECC_STATIC volatile long rs_codes_lock_ = 0;
+#else
+CPPECC_STATIC cppecc_s32 rs_codes_lock_ = 0;
+#endif
+
+// A lock of rs_codes_, it's held only while the registry is searched or a code is built.
+// Waiters spin on reads with pause for a short while, then yield, because building tables of a long code takes milliseconds.
+CPPECC_STATIC void rs_codes_lock(void)
+{
+    cppecc_s32 spins = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+    while(0 != _InterlockedExchange(&rs_codes_lock_, 1)) {
+        while(0 != rs_codes_lock_) {
+#else
+    while(0 != __atomic_exchange_n(&rs_codes_lock_, 1, __ATOMIC_ACQUIRE)) {
+        while(0 != __atomic_load_n(&rs_codes_lock_, __ATOMIC_RELAXED)) {
+#endif
+            if(spins < 64) {
+                ++spins;
+                CPPECC_PAUSE();
+            } else {
+                CPPECC_YIELD();
+            }
+        }
+    }
+}
+
+CPPECC_STATIC void rs_codes_unlock(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchange(&rs_codes_lock_, 0);
+#else
+    __atomic_store_n(&rs_codes_lock_, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+const CPPECC_STRUCT RSCode* rs_code_acquire(cppecc_s32 numSymbols, const CPPECC_STRUCT RSField* field)
+{
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    CPPECC_ASSERT(0 <= numSymbols && numSymbols < CPPECC_MAX_BODY_SIZE);
+    rs_codes_lock();
+    CPPECC_STRUCT RSCode* code = rs_codes_;
+    while(CPPECC_NULL != code && (code->numSymbols_ != numSymbols || code->field_ != field)) {
+        code = code->next_;
+    }
+    if(CPPECC_NULL == code) {
+        // Built under the lock, so other threads see the tables only after they are complete
+        code = CPPECC_STATIC_CAST(CPPECC_STRUCT RSCode*)(CPPECC_MALLOC(sizeof(CPPECC_STRUCT RSCode)));
+        if(CPPECC_NULL != code) {
+            CPPECC_STRUCT RSContext* context = rs_context_alloc(numSymbols, field);
+            if(CPPECC_NULL == context) {
+                CPPECC_FREE(code);
+                code = CPPECC_NULL;
+            } else {
+                code->context_ = context;
+                code->arena_ = context;
+                code->field_ = field;
+                code->numSymbols_ = numSymbols;
+                code->references_ = 0;
+                code->next_ = rs_codes_;
+                rs_codes_ = code;
+            }
+        }
+    }
+    if(CPPECC_NULL != code) {
+        ++code->references_;
+    }
+    rs_codes_unlock();
+    return code;
+}
+
+void rs_code_release(const CPPECC_STRUCT RSCode* code)
+{
+    CPPECC_ASSERT(CPPECC_NULL != code);
+    rs_codes_lock();
+    for(CPPECC_STRUCT RSCode* i = rs_codes_; CPPECC_NULL != i; i = i->next_) {
+        if(i == code) {
+            CPPECC_ASSERT(0 < i->references_);
+            --i->references_;
+            break;
+        }
+    }
+    rs_codes_unlock();
+}
+
+cppecc_s32 rs_code_purge(void)
+{
+    cppecc_s32 count = 0;
+    rs_codes_lock();
+    CPPECC_STRUCT RSCode** link = &rs_codes_;
+    while(CPPECC_NULL != *link) {
+        CPPECC_STRUCT RSCode* code = *link;
+        if(0 < code->references_) {
+            link = &code->next_;
+            continue;
+        }
+        *link = code->next_;
+        rs_context_free(CPPECC_STATIC_CAST(CPPECC_STRUCT RSContext*)(code->arena_));
+        CPPECC_FREE(code);
+        ++count;
+    }
+    rs_codes_unlock();
+    return count;
+}
+
+void rs_workspace_init(CPPECC_STRUCT RSWorkspace* workspace, const CPPECC_STRUCT RSCode* code)
+{
+    CPPECC_ASSERT(CPPECC_NULL != workspace);
+    CPPECC_ASSERT(CPPECC_NULL != code);
+    workspace->code_ = code;
+#if defined(CPPECC_ENABLE_STATS)
+    rs_stats_reset(&workspace->scratch_);
+#endif
+}
+
+void rs_workspace_encode(const CPPECC_STRUCT RSWorkspace* workspace, cppecc_s32 size, cppecc_u8 message[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != workspace);
+    const CPPECC_STRUCT RSCode* code = workspace->code_;
+    CPPECC_ASSERT(0 <= size && CPPECC_STATIC_CAST(cppecc_u32)(size + code->numSymbols_) < CPPECC_GF_NW);
+    rs_parity(code->context_, size, message, message + size, code->numSymbols_);
+}
+
+cppecc_s32 rs_workspace_decode(CPPECC_STRUCT RSWorkspace* workspace, cppecc_s32 size, cppecc_u8 message[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != workspace);
+    const CPPECC_STRUCT RSCode* code = workspace->code_;
+    return rs_decode_scratch(code->context_, &workspace->scratch_, size, message, code->numSymbols_);
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+/**
+ @brief outputs[t] = sum of rows[t*numInputs + c] * inputs[c], in blocks which keep outputs in L1 or L2 while inputs stream through.
+ */
+CPPECC_STATIC void rs_stripe_apply(const CPPECC_STRUCT RSField* field, cppecc_size_t chunkSize, cppecc_s32 numInputs, const cppecc_u8* const inputs[], cppecc_s32 numOutputs, cppecc_u8* const outputs[], const cppecc_u8 rows[])
+{
+    const CPPECC_STRUCT RSKernels* kernels = rs_kernels();
+    cppecc_size_t block = CPPECC_STATIC_CAST(cppecc_size_t)(32 * 1024 / numOutputs) & ~CPPECC_STATIC_CAST(cppecc_size_t)(63);
+    block = (block < 1024) ? 1024 : block;
+    for(cppecc_size_t offset = 0; offset < chunkSize; offset += block) {
+        cppecc_size_t length = (block < (chunkSize - offset)) ? block : chunkSize - offset;
+        for(cppecc_s32 t = 0; t < numOutputs; ++t) {
+            cppecc_u8* output = outputs[t] + offset;
+            for(cppecc_size_t i = 0; i < length; ++i) {
+                output[i] = 0;
+            }
+        }
+        for(cppecc_s32 c = 0; c < numInputs; ++c) {
+            for(cppecc_s32 t = 0; t < numOutputs; ++t) {
+                cppecc_u8 coefficient = rows[t * numInputs + c];
+                if(0 != coefficient) {
+                    kernels->mulAddRegion_(field, coefficient, length, inputs[c] + offset, outputs[t] + offset);
+                }
+            }
+        }
+    }
+}
+
+/**
+ @brief Invert the left half of work, [size][size * 2], to the right half with Gauss-Jordan elimination.
+ @return 0, or CPPECC_ERROR if it's singular
+ */
+CPPECC_STATIC cppecc_s32 rs_stripe_invert(const CPPECC_STRUCT RSField* field, cppecc_s32 size, cppecc_u8 work[])
+{
+    const cppecc_s32 width = size * 2;
+    for(cppecc_s32 r = 0; r < size; ++r) {
+        for(cppecc_s32 c = 0; c < size; ++c) {
+            work[r * width + size + c] = (r == c) ? 1 : 0;
+        }
+    }
+    for(cppecc_s32 c = 0; c < size; ++c) {
+        cppecc_s32 pivot = c;
+        while(pivot < size && 0 == work[pivot * width + c]) {
+            ++pivot;
+        }
+        if(size <= pivot) {
+            return CPPECC_ERROR;
+        }
+        if(pivot != c) {
+            for(cppecc_s32 i = 0; i < width; ++i) {
+                cppecc_u8 t = work[pivot * width + i];
+                work[pivot * width + i] = work[c * width + i];
+                work[c * width + i] = t;
+            }
+        }
+        cppecc_u8* row = work + c * width;
+        cppecc_u8 inverse = gf_field_div(field, 1, row[c]);
+        for(cppecc_s32 i = 0; i < width; ++i) {
+            row[i] = gf_field_mul(field, row[i], inverse);
+        }
+        for(cppecc_s32 r = 0; r < size; ++r) {
+            cppecc_u8 factor = work[r * width + c];
+            if(r != c && 0 != factor) {
+                rs_mul_add_region_scalar(field, factor, CPPECC_STATIC_CAST(cppecc_size_t)(width), row, work + r * width);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ @brief Find the decoder of a loss pattern in the cache, or make one in the oldest entry.
+ @return The decoder, or null if the survivors are singular.
+ */
+CPPECC_STATIC CPPECC_STRUCT RSStripeDecoder* rs_stripe_decoder(CPPECC_STRUCT RSStripe* stripe, const cppecc_u64 lost[], cppecc_s32 numLost)
 {
-    cppecc_u8 y = poly[0];
-    for(cppecc_s32 i = 1; i < size; ++i) {
-        y = gf_mul(y, x) ^ poly[i];
+    static const cppecc_s32 Words = CPPECC_GF_NW / 64;
+    CPPECC_STRUCT RSStripeDecoder* decoder = &stripe->decoders_[0];
+    for(cppecc_s32 i = 0; i < CPPECC_STRIPE_CACHE_SIZE; ++i) {
+        CPPECC_STRUCT RSStripeDecoder* entry = &stripe->decoders_[i];
+        cppecc_s32 w = 0;
+        while(w < Words && entry->lost_[w] == lost[w]) {
+            ++w;
+        }
+        if(Words == w && 0 != entry->stamp_) {
+            entry->stamp_ = ++stripe->clock_;
+            return entry;
+        }
+        if(entry->stamp_ < decoder->stamp_) {
+            decoder = entry;
+        }
     }
-    return y;
+
+    const CPPECC_STRUCT RSField* field = stripe->field_;
+    const cppecc_s32 numData = stripe->numData_;
+    const cppecc_s32 width = numData * 2;
+    decoder->stamp_ = 0;
+    cppecc_s32 count = 0;
+    for(cppecc_s32 i = 0; count < numData; ++i) {
+        if(0 == ((lost[i >> 6] >> (i & 63)) & 1U)) {
+            decoder->survivors_[count] = CPPECC_STATIC_CAST(cppecc_u8)(i);
+            ++count;
+        }
+    }
+    // Rows of the survivors in the systematic matrix, identity rows for data and Cauchy rows for parity
+    cppecc_u8* work = stripe->work_;
+    for(cppecc_s32 r = 0; r < numData; ++r) {
+        cppecc_s32 s = decoder->survivors_[r];
+        for(cppecc_s32 c = 0; c < numData; ++c) {
+            work[r * width + c] = (s < numData) ? ((s == c) ? 1 : 0) : stripe->matrix_[(s - numData) * numData + c];
+        }
+    }
+    if(0 != rs_stripe_invert(field, numData, work)) {
+        return CPPECC_NULL;
+    }
+
+    // Lost data is a row of the inverse, lost parity is its Cauchy row times the inverse
+    cppecc_s32 t = 0;
+    for(cppecc_s32 i = 0; t < numLost; ++i) {
+        if(0 == ((lost[i >> 6] >> (i & 63)) & 1U)) {
+            continue;
+        }
+        cppecc_u8* row = decoder->rows_ + t * numData;
+        if(i < numData) {
+            for(cppecc_s32 c = 0; c < numData; ++c) {
+                row[c] = work[i * width + numData + c];
+            }
+        } else {
+            for(cppecc_s32 c = 0; c < numData; ++c) {
+                row[c] = 0;
+            }
+            const cppecc_u8* cauchy = stripe->matrix_ + (i - numData) * numData;
+            for(cppecc_s32 j = 0; j < numData; ++j) {
+                rs_mul_add_region_scalar(field, cauchy[j], CPPECC_STATIC_CAST(cppecc_size_t)(numData), work + j * width + numData, row);
+            }
+        }
+        ++t;
+    }
+    for(cppecc_s32 w = 0; w < Words; ++w) {
+        decoder->lost_[w] = lost[w];
+    }
+    decoder->numLost_ = numLost;
+    decoder->stamp_ = ++stripe->clock_;
+    return decoder;
 }
 
-#if 0
-cppecc_s32 gf_poly_div(cppecc_u8 result[], cppecc_s32 sizeDividend, const cppecc_u8 dividend[], cppecc_s32 sizeDivisor, const cppecc_u8 divisor[])
+CPPECC_NAMESPACE_EMPTY_END
+
+cppecc_size_t rs_stripe_size(cppecc_s32 numData, cppecc_s32 numParity)
 {
-    for(cppecc_s32 i=0; i<sizeDividend; ++i){
-        result[i] = dividend[i];
+    CPPECC_ASSERT(0 < numData && 0 <= numParity);
+    CPPECC_ASSERT(numData + numParity <= CPPECC_STATIC_CAST(cppecc_s32)(CPPECC_GF_NW));
+    cppecc_size_t matrix = CPPECC_STATIC_CAST(cppecc_size_t)(numParity * numData);
+    cppecc_size_t work = CPPECC_STATIC_CAST(cppecc_size_t)(numData * numData * 2);
+    return sizeof(CPPECC_STRUCT RSStripe) + matrix + work + CPPECC_STRIPE_CACHE_SIZE * matrix;
+}
+
+CPPECC_STRUCT RSStripe* rs_stripe_create(void* arena, cppecc_size_t arenaSize, cppecc_s32 numData, cppecc_s32 numParity, const CPPECC_STRUCT RSField* field)
+{
+    CPPECC_ASSERT(CPPECC_NULL != arena);
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    CPPECC_ASSERT(0 == (CPPECC_REINTERPRET_CAST(uintptr_t)(arena) % sizeof(void*)));
+    if(arenaSize < rs_stripe_size(numData, numParity)) {
+        return CPPECC_NULL;
     }
-    cppecc_s32 size = sizeDividend - sizeDivisor + 1;
-    for(cppecc_s32 i=0; i<size; ++i){
-        cppecc_u8 coef = result[i];
-        if( 0 != coef){
-            for(cppecc_s32 j=1; j<sizeDivisor; ++j){
-                if(0 != divisor[j]){
-                    result[i+j] ^= gf_mul(divisor[j], coef);
+    rs_kernels_initialize();
+    CPPECC_STRUCT RSStripe* stripe = CPPECC_STATIC_CAST(CPPECC_STRUCT RSStripe*)(arena);
+    cppecc_u8* base = CPPECC_STATIC_CAST(cppecc_u8*)(arena) + sizeof(CPPECC_STRUCT RSStripe);
+    stripe->field_ = field;
+    stripe->numData_ = numData;
+    stripe->numParity_ = numParity;
+    stripe->clock_ = 0;
+    stripe->matrix_ = base;
+    stripe->work_ = base + numParity * numData;
+    base = stripe->work_ + numData * numData * 2;
+    for(cppecc_s32 i = 0; i < CPPECC_STRIPE_CACHE_SIZE; ++i) {
+        stripe->decoders_[i].stamp_ = 0;
+        stripe->decoders_[i].numLost_ = 0;
+        stripe->decoders_[i].rows_ = base + i * numParity * numData;
+    }
+    for(cppecc_s32 i = 0; i < numParity; ++i) {
+        for(cppecc_s32 j = 0; j < numData; ++j) {
+            stripe->matrix_[i * numData + j] = gf_field_div(field, 1, CPPECC_STATIC_CAST(cppecc_u8)((numData + i) ^ j));
+        }
+    }
+    return stripe;
+}
+
+CPPECC_STRUCT RSStripe* rs_stripe_alloc(cppecc_s32 numData, cppecc_s32 numParity, const CPPECC_STRUCT RSField* field)
+{
+    cppecc_size_t size = rs_stripe_size(numData, numParity);
+    void* arena = CPPECC_MALLOC(size);
+    if(CPPECC_NULL == arena) {
+        return CPPECC_NULL;
+    }
+    return rs_stripe_create(arena, size, numData, numParity, field);
+}
+
+void rs_stripe_free(CPPECC_STRUCT RSStripe* stripe)
+{
+    CPPECC_FREE(stripe);
+}
+
+void rs_stripe_encode(const CPPECC_STRUCT RSStripe* stripe, cppecc_size_t chunkSize, const cppecc_u8* const data[], cppecc_u8* const parity[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != stripe);
+    CPPECC_ASSERT(CPPECC_NULL != data && CPPECC_NULL != parity);
+    if(0 < stripe->numParity_) {
+        rs_stripe_apply(stripe->field_, chunkSize, stripe->numData_, data, stripe->numParity_, parity, stripe->matrix_);
+    }
+}
+
+cppecc_s32 rs_stripe_rebuild(CPPECC_STRUCT RSStripe* stripe, cppecc_size_t chunkSize, cppecc_u8* const chunks[], const cppecc_u8 lost[], cppecc_s32 numLost)
+{
+    CPPECC_ASSERT(CPPECC_NULL != stripe);
+    CPPECC_ASSERT(CPPECC_NULL != chunks);
+    CPPECC_ASSERT(0 <= numLost);
+    if(stripe->numParity_ < numLost) {
+        return CPPECC_ERROR;
+    }
+    if(numLost <= 0) {
+        return 0;
+    }
+    cppecc_u64 set[CPPECC_GF_NW / 64] = {0};
+    for(cppecc_s32 i = 0; i < numLost; ++i) {
+        CPPECC_ASSERT(lost[i] < stripe->numData_ + stripe->numParity_);
+        CPPECC_ASSERT(0 == ((set[lost[i] >> 6] >> (lost[i] & 63)) & 1U));
+        set[lost[i] >> 6] |= 1ULL << (lost[i] & 63);
+    }
+    const CPPECC_STRUCT RSStripeDecoder* decoder = rs_stripe_decoder(stripe, set, numLost);
+    if(CPPECC_NULL == decoder) {
+        return CPPECC_ERROR;
+    }
+
+    const cppecc_u8* inputs[CPPECC_GF_NW];
+    cppecc_u8* outputs[CPPECC_GF_NW];
+    for(cppecc_s32 c = 0; c < stripe->numData_; ++c) {
+        inputs[c] = chunks[decoder->survivors_[c]];
+    }
+    cppecc_s32 t = 0;
+    for(cppecc_s32 i = 0; t < numLost; ++i) {
+        if(0 != ((set[i >> 6] >> (i & 63)) & 1U)) {
+            outputs[t] = chunks[i];
+            ++t;
+        }
+    }
+    rs_stripe_apply(stripe->field_, chunkSize, stripe->numData_, inputs, numLost, outputs, decoder->rows_);
+    return 0;
+}
+
+cppecc_size_t rs_buffer_blocks(cppecc_size_t size, cppecc_s32 blockSize)
+{
+    CPPECC_ASSERT(0 < blockSize);
+    cppecc_size_t block = CPPECC_STATIC_CAST(cppecc_size_t)(blockSize);
+    return (size + block - 1) / block;
+}
+
+cppecc_size_t rs_buffer_encoded_size(cppecc_size_t size, cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout)
+{
+    cppecc_size_t redundants = rs_buffer_blocks(size, blockSize) * CPPECC_STATIC_CAST(cppecc_size_t)(numSymbols);
+    return (CPPECC_LAYOUT_SEPARATE == layout) ? redundants : size + redundants;
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+CPPECC_STATIC cppecc_s32 rs_buffer_block_size(cppecc_size_t size, cppecc_s32 blockSize, cppecc_size_t index)
+{
+    cppecc_size_t rest = size - index * blockSize;
+    return (rest < CPPECC_STATIC_CAST(cppecc_size_t)(blockSize)) ? CPPECC_STATIC_CAST(cppecc_s32)(rest) : blockSize;
+}
+
+// Blocks in [begin, end) of a buffer. These only read the context, and threads can run them for disjoint ranges.
+CPPECC_STATIC void rs_encode_blocks(const CPPECC_STRUCT RSContext* context, cppecc_size_t size, const cppecc_u8 data[], cppecc_u8 output[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_size_t begin, cppecc_size_t end)
+{
+    cppecc_size_t stride = CPPECC_STATIC_CAST(cppecc_size_t)((CPPECC_LAYOUT_SEPARATE == layout) ? numSymbols : blockSize + numSymbols);
+    for(cppecc_size_t i = begin; i < end; ++i) {
+        const cppecc_u8* block = data + i * blockSize;
+        cppecc_s32 length = rs_buffer_block_size(size, blockSize, i);
+        cppecc_u8* codeword = output + i * stride;
+        if(CPPECC_LAYOUT_SEPARATE == layout) {
+            rs_parity(context, length, block, codeword, numSymbols);
+            continue;
+        }
+        for(cppecc_s32 j = 0; j < length; ++j) {
+            codeword[j] = block[j];
+        }
+        rs_parity(context, length, block, codeword + length, numSymbols);
+    }
+}
+
+CPPECC_STATIC cppecc_s32 rs_check_blocks(const CPPECC_STRUCT RSContext* context, cppecc_size_t size, const cppecc_u8 data[], const cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_size_t begin, cppecc_size_t end, cppecc_s32 status[])
+{
+    cppecc_s32 numDirty = 0;
+    for(cppecc_size_t i = begin; i < end; ++i) {
+        cppecc_s32 length = rs_buffer_block_size(size, blockSize, i);
+        cppecc_s32 dirty = 0;
+        if(CPPECC_LAYOUT_CODEWORDS == layout) {
+            dirty = rs_check(context, length, data + i * (blockSize + numSymbols), numSymbols);
+        } else {
+            const cppecc_u8* redundants = parity + i * numSymbols;
+            cppecc_u8 remainder[CPPECC_GF_NW];
+            rs_parity(context, length, data + i * blockSize, remainder, numSymbols);
+            cppecc_u8 hasError = 0;
+            for(cppecc_s32 j = 0; j < numSymbols; ++j) {
+                hasError |= remainder[j] ^ redundants[j];
+            }
+            dirty = 0 != hasError ? 1 : 0;
+        }
+        if(CPPECC_NULL != status) {
+            status[i] = dirty;
+        }
+        numDirty += dirty;
+    }
+    return numDirty;
+}
+
+CPPECC_STATIC cppecc_s32 rs_decode_blocks(const CPPECC_STRUCT RSContext* context, CPPECC_STRUCT RSScratch* scratch, cppecc_size_t size, cppecc_u8 data[], cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_size_t begin, cppecc_size_t end, cppecc_s32 status[], cppecc_s32* numFailed)
+{
+    cppecc_s32 total = 0;
+    for(cppecc_size_t i = begin; i < end; ++i) {
+        cppecc_s32 length = rs_buffer_block_size(size, blockSize, i);
+        cppecc_s32 corrected = 0;
+        if(CPPECC_LAYOUT_CODEWORDS == layout) {
+            corrected = rs_decode_scratch(context, scratch, length, data + i * (blockSize + numSymbols), numSymbols);
+        } else if(0 != rs_check_blocks(context, size, data, parity, blockSize, numSymbols, layout, i, i + 1, CPPECC_NULL)) {
+            cppecc_u8* block = data + i * blockSize;
+            cppecc_u8* redundants = parity + i * numSymbols;
+            cppecc_u8 codeword[CPPECC_GF_NW];
+            for(cppecc_s32 j = 0; j < length; ++j) {
+                codeword[j] = block[j];
+            }
+            for(cppecc_s32 j = 0; j < numSymbols; ++j) {
+                codeword[length + j] = redundants[j];
+            }
+            corrected = rs_decode_scratch(context, scratch, length, codeword, numSymbols);
+            if(0 <= corrected) {
+                for(cppecc_s32 j = 0; j < length; ++j) {
+                    block[j] = codeword[j];
+                }
+                for(cppecc_s32 j = 0; j < numSymbols; ++j) {
+                    redundants[j] = codeword[length + j];
                 }
             }
         }
+        if(CPPECC_NULL != status) {
+            status[i] = corrected;
+        }
+        if(corrected < 0) {
+            ++*numFailed;
+        } else {
+            total += corrected;
+        }
     }
+    return total;
+}
 
-    cppecc_s32 sizeResult = sizeDividend - size;
-    for(cppecc_s32 i=0; i<sizeResult; ++i){
-        result[i] = result[i+size];
+CPPECC_NAMESPACE_EMPTY_END
+
+void rs_encode_buffer(const CPPECC_STRUCT RSContext* context, cppecc_size_t size, const cppecc_u8 data[], cppecc_u8 output[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(0 < blockSize && (blockSize + numSymbols) <= CPPECC_MAX_BODY_SIZE);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context->numSymbols_);
+    CPPECC_ASSERT(CPPECC_LAYOUT_CODEWORDS == layout || CPPECC_LAYOUT_SEPARATE == layout);
+    rs_encode_blocks(context, size, data, output, blockSize, numSymbols, layout, 0, rs_buffer_blocks(size, blockSize));
+}
+
+cppecc_s32 rs_check_buffer(const CPPECC_STRUCT RSContext* context, cppecc_size_t size, const cppecc_u8 data[], const cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(0 < blockSize && (blockSize + numSymbols) <= CPPECC_MAX_BODY_SIZE);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context->numSymbols_);
+    CPPECC_ASSERT(CPPECC_LAYOUT_CODEWORDS == layout || (CPPECC_LAYOUT_SEPARATE == layout && CPPECC_NULL != parity));
+    return rs_check_blocks(context, size, data, parity, blockSize, numSymbols, layout, 0, rs_buffer_blocks(size, blockSize), status);
+}
+
+cppecc_s32 rs_decode_buffer(CPPECC_STRUCT RSContext* context, cppecc_size_t size, cppecc_u8 data[], cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(0 < blockSize && (blockSize + numSymbols) <= CPPECC_MAX_BODY_SIZE);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context->numSymbols_);
+    CPPECC_ASSERT(CPPECC_LAYOUT_CODEWORDS == layout || (CPPECC_LAYOUT_SEPARATE == layout && CPPECC_NULL != parity));
+    cppecc_s32 numFailed = 0;
+    cppecc_s32 total = rs_decode_blocks(context, context->scratch_, size, data, parity, blockSize, numSymbols, layout, 0, rs_buffer_blocks(size, blockSize), status, &numFailed);
+    return (0 < numFailed) ? CPPECC_ERROR : total;
+}
+
+//--- Stats
+#if defined(CPPECC_ENABLE_STATS)
+void rs_stats_reset(CPPECC_STRUCT RSScratch* scratch)
+{
+    CPPECC_ASSERT(CPPECC_NULL != scratch);
+    for(cppecc_s32 i = 0; i < CPPECC_STAGE_MAX; ++i) {
+        scratch->stats_.cycles_[i] = 0;
+        scratch->stats_.calls_[i] = 0;
+    }
+    scratch->stats_.words_ = 0;
+    scratch->stats_.uncorrectable_ = 0;
+    for(cppecc_u32 i = 0; i <= CPPECC_GF_NW / 2; ++i) {
+        scratch->stats_.corrected_[i] = 0;
+    }
+    scratch->callback_ = CPPECC_NULL;
+    scratch->user_ = CPPECC_NULL;
+}
+
+void rs_stats_set_callback(CPPECC_STRUCT RSScratch* scratch, cppecc_error_callback callback, void* user)
+{
+    CPPECC_ASSERT(CPPECC_NULL != scratch);
+    scratch->callback_ = callback;
+    scratch->user_ = user;
+}
+
+void rs_stats_snapshot(const CPPECC_STRUCT RSScratch* scratch, CPPECC_STRUCT RSStats* result)
+{
+    CPPECC_ASSERT(CPPECC_NULL != scratch);
+    CPPECC_ASSERT(CPPECC_NULL != result);
+    *result = scratch->stats_;
+}
+
+void rs_stats_merge(CPPECC_STRUCT RSStats* result, const CPPECC_STRUCT RSStats* stats)
+{
+    CPPECC_ASSERT(CPPECC_NULL != result);
+    CPPECC_ASSERT(CPPECC_NULL != stats);
+    for(cppecc_s32 i = 0; i < CPPECC_STAGE_MAX; ++i) {
+        result->cycles_[i] += stats->cycles_[i];
+        result->calls_[i] += stats->calls_[i];
+    }
+    result->words_ += stats->words_;
+    result->uncorrectable_ += stats->uncorrectable_;
+    for(cppecc_u32 i = 0; i <= CPPECC_GF_NW / 2; ++i) {
+        result->corrected_[i] += stats->corrected_[i];
     }
-    return sizeResult;
+}
+
+const char* rs_stats_stage_name(cppecc_s32 stage)
+{
+    static const char* names[] = {"syndromes", "locator", "chien", "forney"};
+    return (0 <= stage && stage < CPPECC_STAGE_MAX) ? names[stage] : "";
+}
+
+cppecc_s32 rs_stats_json(const CPPECC_STRUCT RSStats* stats, char buffer[], cppecc_size_t size)
+{
+    CPPECC_ASSERT(CPPECC_NULL != stats);
+    // Count the length without writing when buffer is full, the same as snprintf
+    cppecc_size_t length = 0;
+    char dummy[1];
+#    define CPPECC_STATS_PRINT(...) \
+        length += CPPECC_STATIC_CAST(cppecc_size_t)(snprintf(length < size ? buffer + length : dummy, length < size ? size - length : 1, __VA_ARGS__))
+    CPPECC_STATS_PRINT("{\"words\": %llu, \"uncorrectable\": %llu, \"stages\": {", CPPECC_STATIC_CAST(unsigned long long)(stats->words_), CPPECC_STATIC_CAST(unsigned long long)(stats->uncorrectable_));
+    for(cppecc_s32 i = 0; i < CPPECC_STAGE_MAX; ++i) {
+        CPPECC_STATS_PRINT("%s\"%s\": {\"calls\": %llu, \"cycles\": %llu}", 0 < i ? ", " : "", rs_stats_stage_name(i), CPPECC_STATIC_CAST(unsigned long long)(stats->calls_[i]), CPPECC_STATIC_CAST(unsigned long long)(stats->cycles_[i]));
+    }
+    // Histogram is sparse, only non zero bins
+    CPPECC_STATS_PRINT("}, \"corrected\": {");
+    cppecc_s32 count = 0;
+    for(cppecc_u32 i = 0; i <= CPPECC_GF_NW / 2; ++i) {
+        if(0 == stats->corrected_[i]) {
+            continue;
+        }
+        CPPECC_STATS_PRINT("%s\"%u\": %llu", 0 < count ? ", " : "", i, CPPECC_STATIC_CAST(unsigned long long)(stats->corrected_[i]));
+        ++count;
+    }
+    CPPECC_STATS_PRINT("}}");
+#    undef CPPECC_STATS_PRINT
+    return CPPECC_STATIC_CAST(cppecc_s32)(length);
 }
 #endif
 
-cppecc_u8 gf_omega_value(cppecc_s32 numOmega, const cppecc_u8 omega[], cppecc_u8 l)
+//--- Profiles
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+static const CPPECC_STRUCT RSProfile rsprofiles[3] = {
+    {&gfccsds, 255, 223, 32, CPPECC_NULL, CPPECC_NULL},
+    {&gfccsds, 255, 223, 32, gfccsdstodual, gfccsdsfromdual},
+    {&gfdefault, 204, 188, 16, CPPECC_NULL, CPPECC_NULL},
+};
+
+CPPECC_NAMESPACE_EMPTY_END
+
+const CPPECC_STRUCT RSProfile* rs_profile_ccsds(cppecc_s32 dualBasis)
 {
-    cppecc_u8 w = l;
-    cppecc_u8 o = omega[0];
-    for(cppecc_s32 i = 1; i < numOmega; i++) {
-        o ^= gf_mulexp(omega[i], w);
-        w = (w + l) % CPPECC_GF_NW1;
+    return (0 != dualBasis) ? &rsprofiles[1] : &rsprofiles[0];
+}
+
+const CPPECC_STRUCT RSProfile* rs_profile_dvb(void)
+{
+    return &rsprofiles[2];
+}
+
+cppecc_s32 rs_profile_initialize(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSProfile* profile)
+{
+    CPPECC_ASSERT(CPPECC_NULL != profile);
+    return gf_initialize_field(context, profile->numSymbols_, profile->field_);
+}
+
+void rs_profile_encode(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSProfile* profile, cppecc_u8 codeword[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_NULL != profile);
+    CPPECC_ASSERT(context->field_ == profile->field_ && profile->numSymbols_ == context->numSymbols_);
+    if(CPPECC_NULL == profile->toDual_) {
+        rs_encode(context, profile->messageSize_, codeword, profile->numSymbols_);
+        return;
     }
-    return o;
+    cppecc_u8 conventional[CPPECC_GF_NW];
+    rs_convert_basis(profile->fromDual_, profile->messageSize_, codeword, conventional);
+    rs_parity(context, profile->messageSize_, conventional, conventional + profile->messageSize_, profile->numSymbols_);
+    rs_convert_basis(profile->toDual_, profile->numSymbols_, conventional + profile->messageSize_, codeword + profile->messageSize_);
 }
 
-cppecc_u8 gf_sigma_dash_value(cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_u8 l)
+cppecc_s32 rs_profile_decode(CPPECC_STRUCT RSContext* context, const CPPECC_STRUCT RSProfile* profile, cppecc_u8 codeword[])
 {
-    cppecc_s32 size = numSigma - 1;
-    cppecc_u8 l2 = (2 * l) % CPPECC_GF_NW1;
-    cppecc_u8 w = l2;
-    cppecc_u8 d = sigma[1];
-    for(cppecc_s32 i = 3; i <= size; i += 2) {
-        d ^= gf_mulexp(sigma[i], w);
-        w = (w + l2) % CPPECC_GF_NW1;
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_NULL != profile);
+    CPPECC_ASSERT(context->field_ == profile->field_ && profile->numSymbols_ == context->numSymbols_);
+    if(CPPECC_NULL == profile->toDual_) {
+        return rs_decode(context, profile->messageSize_, codeword, profile->numSymbols_);
+    }
+    cppecc_u8 conventional[CPPECC_GF_NW];
+    rs_convert_basis(profile->fromDual_, profile->codewordSize_, codeword, conventional);
+    cppecc_s32 corrected = rs_decode(context, profile->messageSize_, conventional, profile->numSymbols_);
+    if(0 < corrected) {
+        rs_convert_basis(profile->toDual_, profile->codewordSize_, conventional, codeword);
+    }
+    return corrected;
+}
+
+#if defined(CPPECC_KERNEL_SSSE3)
+CPPECC_NAMESPACE_EMPTY_BEGIN
+/**
+ @brief Convert blocks of 16 symbols, and return the number of converted symbols.
+ */
+CPPECC_STATIC CPPECC_TARGET_SSSE3 cppecc_s32 rs_convert_basis_ssse3(const cppecc_u8 table[32], cppecc_s32 size, const cppecc_u8 src[], cppecc_u8 dst[])
+{
+    cppecc_s32 i = 0;
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i lo = _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table));
+    const __m128i hi = _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(table + 16));
+    for(; (i + 16) <= size; i += 16) {
+        __m128i x = _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(src + i));
+        x = _mm_xor_si128(_mm_shuffle_epi8(lo, _mm_and_si128(x, mask)), _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(x, 4), mask)));
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(dst + i), x);
+    }
+    return i;
+}
+CPPECC_NAMESPACE_EMPTY_END
+#endif
+
+void rs_convert_basis(const cppecc_u8 table[32], cppecc_s32 size, const cppecc_u8 src[], cppecc_u8 dst[])
+{
+    cppecc_s32 i = 0;
+#if defined(CPPECC_KERNEL_SSSE3)
+    if(0 != (rs_kernels()->features_ & CPPECC_CPU_SSSE3)) {
+        i = rs_convert_basis_ssse3(table, size, src, dst);
+    }
+#endif
+    for(; i < size; ++i) {
+        dst[i] = table[src[i] & 0x0FU] ^ table[16 + (src[i] >> 4)];
+    }
+}
+
+//--- GF(2^16)
+cppecc_s32 gf16_field_build(CPPECC_STRUCT RS16Field* field, cppecc_u32 polynomial)
+{
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    if(polynomial < CPPECC_GF16_NW || (CPPECC_GF16_NW << 1) <= polynomial) {
+        return CPPECC_ERROR;
+    }
+    // Powers of alpha cycle with the period 65535 only if the polynomial is primitive
+    cppecc_u32 x = 1;
+    field->log_[0] = 0;
+    for(cppecc_u32 i = 0; i < CPPECC_GF16_NW1; ++i) {
+        if(0 < i && 1 == x) {
+            return CPPECC_ERROR;
+        }
+        field->exp_[i] = CPPECC_STATIC_CAST(cppecc_u16)(x);
+        field->log_[x] = CPPECC_STATIC_CAST(cppecc_u16)(i);
+        x <<= 1;
+        if(CPPECC_GF16_NW <= x) {
+            x ^= polynomial;
+        }
+    }
+    field->exp_[CPPECC_GF16_NW1] = 1;
+    field->polynomial_ = polynomial;
+    return 0;
+}
+
+cppecc_u16 gf16_field_mul(const CPPECC_STRUCT RS16Field* field, cppecc_u16 a, cppecc_u16 b)
+{
+    if(0 == a || 0 == b) {
+        return 0;
+    }
+    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_u32)(field->log_[a]) + field->log_[b];
+    if(CPPECC_GF16_NW1 <= sum) {
+        sum -= CPPECC_GF16_NW1;
+    }
+    return field->exp_[sum];
+}
+
+cppecc_u16 gf16_field_div(const CPPECC_STRUCT RS16Field* field, cppecc_u16 a, cppecc_u16 b)
+{
+    if(0 == a) {
+        return 0;
+    }
+    if(0 == b) {
+        return CPPECC_STATIC_CAST(cppecc_u16)(-1);
+    }
+    cppecc_s32 diff = CPPECC_STATIC_CAST(cppecc_s32)(field->log_[a]) - field->log_[b];
+    if(diff < 0) {
+        diff += CPPECC_GF16_NW1;
+    }
+    return field->exp_[diff];
+}
+
+cppecc_u16 gf16_field_pow(const CPPECC_STRUCT RS16Field* field, cppecc_u16 x, cppecc_s32 p)
+{
+    return field->exp_[(CPPECC_STATIC_CAST(cppecc_u64)(field->log_[x]) * p) % CPPECC_GF16_NW1];
+}
+
+cppecc_u16 gf16_field_inverse(const CPPECC_STRUCT RS16Field* field, cppecc_u16 x)
+{
+    return field->exp_[CPPECC_GF16_NW1 - field->log_[x]];
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+CPPECC_STATIC cppecc_u16 gf16_mulexp(const CPPECC_STRUCT RS16Field* field, cppecc_u16 a, cppecc_u32 b)
+{
+    if(0 == a) {
+        return 0;
+    }
+    cppecc_u32 sum = CPPECC_STATIC_CAST(cppecc_u32)(field->log_[a]) + b;
+    if(CPPECC_GF16_NW1 <= sum) {
+        sum -= CPPECC_GF16_NW1;
+    }
+    return field->exp_[sum];
+}
+
+CPPECC_STATIC cppecc_u16 gf16_divexp(const CPPECC_STRUCT RS16Field* field, cppecc_u16 a, cppecc_u32 b)
+{
+    if(0 == a) {
+        return 0;
+    }
+    cppecc_s32 diff = CPPECC_STATIC_CAST(cppecc_s32)(field->log_[a]) - CPPECC_STATIC_CAST(cppecc_s32)(b);
+    if(diff < 0) {
+        diff += CPPECC_GF16_NW1;
+    }
+    return field->exp_[diff];
+}
+
+#define CPPECC_ROW16(rows, stride, e, half, b) ((rows) + (((e) * 2 + (half)) * 256 + (b)) * (stride))
+
+#if defined(CPPECC_KERNEL_SSSE3)
+// The remainder is kept in registers, 8 symbols for each.
+// Products with the feedback are the sum of two rows, looked up by the low and high bytes of the feedback. Two symbols are consumed in a step.
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_SSSE3 void rs16_lfsr_ssse3(const cppecc_u16* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u16 message[], cppecc_u16 remainder[CPPECC_MAX_ECC16_SIZE], const cppecc_s32 numRegisters)
+{
+    __m128i s[8];
+    for(cppecc_s32 r = 0; r < 8; ++r) {
+        s[r] = _mm_setzero_si128();
+    }
+    cppecc_s32 i = 0;
+    for(; (i + 2) <= size; i += 2) {
+        cppecc_u32 f = CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(s[0]));
+        cppecc_u32 f0 = (message[i] ^ f) & 0xFFFFU;
+        cppecc_u32 f1 = (message[i + 1] ^ (f >> 16)) & 0xFFFFU;
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 4);
+        }
+        s[numRegisters - 1] = _mm_srli_si128(s[numRegisters - 1], 4);
+        const __m128i* lo0 = CPPECC_REINTERPRET_CAST(const __m128i*)(CPPECC_ROW16(rows, stride, 1, 0, f0 & 0xFFU));
+        const __m128i* hi0 = CPPECC_REINTERPRET_CAST(const __m128i*)(CPPECC_ROW16(rows, stride, 1, 1, f0 >> 8));
+        const __m128i* lo1 = CPPECC_REINTERPRET_CAST(const __m128i*)(CPPECC_ROW16(rows, stride, 0, 0, f1 & 0xFFU));
+        const __m128i* hi1 = CPPECC_REINTERPRET_CAST(const __m128i*)(CPPECC_ROW16(rows, stride, 0, 1, f1 >> 8));
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            __m128i x0 = _mm_xor_si128(_mm_loadu_si128(lo0 + r), _mm_loadu_si128(hi0 + r));
+            __m128i x1 = _mm_xor_si128(_mm_loadu_si128(lo1 + r), _mm_loadu_si128(hi1 + r));
+            s[r] = _mm_xor_si128(s[r], _mm_xor_si128(x0, x1));
+        }
+    }
+    for(; i < size; ++i) {
+        cppecc_u32 feedback = (message[i] ^ CPPECC_STATIC_CAST(cppecc_u32)(_mm_cvtsi128_si32(s[0]))) & 0xFFFFU;
+        for(cppecc_s32 r = 0; r < (numRegisters - 1); ++r) {
+            s[r] = _mm_alignr_epi8(s[r + 1], s[r], 2);
+        }
+        s[numRegisters - 1] = _mm_srli_si128(s[numRegisters - 1], 2);
+        const __m128i* lo = CPPECC_REINTERPRET_CAST(const __m128i*)(CPPECC_ROW16(rows, stride, 0, 0, feedback & 0xFFU));
+        const __m128i* hi = CPPECC_REINTERPRET_CAST(const __m128i*)(CPPECC_ROW16(rows, stride, 0, 1, feedback >> 8));
+        for(cppecc_s32 r = 0; r < numRegisters; ++r) {
+            s[r] = _mm_xor_si128(s[r], _mm_xor_si128(_mm_loadu_si128(lo + r), _mm_loadu_si128(hi + r)));
+        }
+    }
+    for(cppecc_s32 r = 0; r < 8; ++r) {
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(remainder + 8 * r), s[r]);
+    }
+}
+
+CPPECC_STATIC CPPECC_TARGET_SSSE3 void rs16_encode_ssse3(const cppecc_u16* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u16 message[], cppecc_u16 parity[], cppecc_s32 numSymbols)
+{
+    cppecc_u16 remainder[CPPECC_MAX_ECC16_SIZE];
+    switch((numSymbols + 7) >> 3) {
+    case 1:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 1);
+        break;
+    case 2:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 2);
+        break;
+    case 3:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 3);
+        break;
+    case 4:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 4);
+        break;
+    case 5:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 5);
+        break;
+    case 6:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 6);
+        break;
+    case 7:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 7);
+        break;
+    default:
+        rs16_lfsr_ssse3(rows, stride, size, message, remainder, 8);
+        break;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        parity[i] = remainder[i];
+    }
+}
+#endif // CPPECC_KERNEL_SSSE3
+
+CPPECC_STATIC void rs16_lfsr_rows(const cppecc_u16* rows, cppecc_s32 stride, cppecc_s32 size, const cppecc_u16 message[], cppecc_u16 parity[], cppecc_s32 numSymbols)
+{
+    cppecc_u16 remainder[CPPECC_MAX_ECC16_SIZE + 2] = {0};
+    cppecc_s32 i = 0;
+    for(; (i + 2) <= size; i += 2) {
+        cppecc_u32 f0 = message[i] ^ remainder[0];
+        cppecc_u32 f1 = message[i + 1] ^ remainder[1];
+        const cppecc_u16* lo0 = CPPECC_ROW16(rows, stride, 1, 0, f0 & 0xFFU);
+        const cppecc_u16* hi0 = CPPECC_ROW16(rows, stride, 1, 1, f0 >> 8);
+        const cppecc_u16* lo1 = CPPECC_ROW16(rows, stride, 0, 0, f1 & 0xFFU);
+        const cppecc_u16* hi1 = CPPECC_ROW16(rows, stride, 0, 1, f1 >> 8);
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            remainder[k] = remainder[k + 2] ^ lo0[k] ^ hi0[k] ^ lo1[k] ^ hi1[k];
+        }
+    }
+    for(; i < size; ++i) {
+        cppecc_u32 feedback = message[i] ^ remainder[0];
+        const cppecc_u16* lo = CPPECC_ROW16(rows, stride, 0, 0, feedback & 0xFFU);
+        const cppecc_u16* hi = CPPECC_ROW16(rows, stride, 0, 1, feedback >> 8);
+        for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+            remainder[k] = remainder[k + 1] ^ lo[k] ^ hi[k];
+        }
+    }
+    for(cppecc_s32 k = 0; k < numSymbols; ++k) {
+        parity[k] = remainder[k];
     }
-    return d;
 }
 
-void rs_generator_poly(cppecc_s32 size, cppecc_u8 result[], cppecc_u8 tmp[])
+/**
+ @brief Remainder of message(x)*x^numSymbols divided by the generation polynomial on GF(2^16).
+ */
+CPPECC_STATIC void rs16_parity(const CPPECC_STRUCT RS16Context* context, cppecc_s32 size, const cppecc_u16 message[], cppecc_u16 parity[], cppecc_s32 numSymbols)
 {
-    result[0] = 1;
-    cppecc_u8 poly[2] = {1, 0};
-    cppecc_s32 polySize = 1;
-    for(cppecc_s32 i = 0; i < size; ++i) {
-        poly[1] = gfexp[i];
-        polySize = gf_poly_mul(tmp, polySize, result, 2, poly);
-        for(cppecc_s32 j = 0; j < polySize; ++j) {
-            result[j] = tmp[j];
-        }
+#if defined(CPPECC_KERNEL_SSSE3)
+    if(0 != (rs_kernels()->features_ & CPPECC_CPU_SSSE3)) {
+        rs16_encode_ssse3(context->rows_, context->stride_, size, message, parity, numSymbols);
+        return;
     }
+#endif
+    rs16_lfsr_rows(context->rows_, context->stride_, size, message, parity, numSymbols);
 }
 
-void rs_encode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+CPPECC_NAMESPACE_EMPTY_END
+
+cppecc_s32 gf16_initialize(CPPECC_STRUCT RS16Context* context, cppecc_s32 numSymbols, const CPPECC_STRUCT RS16Field* field)
 {
     CPPECC_ASSERT(CPPECC_NULL != context);
-    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF_NW);
-    CPPECC_ASSERT(numSymbols <= CPPECC_MAX_ECC_SIZE);
-
-    cppecc_u8* result = context->temp0_;
-    for(cppecc_s32 i = 0; i < size; ++i) {
-        result[i] = message[i];
+    CPPECC_ASSERT(CPPECC_NULL != field);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols <= CPPECC_MAX_ECC16_SIZE);
+    // Rows are loaded by vector registers of 8 symbols, roots follow them in the same block
+    cppecc_s32 stride = (numSymbols + 7) & ~7;
+    cppecc_size_t rowsSize = rs_align_line(sizeof(cppecc_u16) * 2 * 2 * 256 * stride);
+    cppecc_size_t rootsSize = sizeof(cppecc_u16) * 2 * 256 * numSymbols;
+    cppecc_size_t chienSize = 2 * 4 * 16 * (numSymbols / 2);
+    context->allocation_ = CPPECC_MALLOC(64 + rowsSize + rootsSize + chienSize);
+    if(CPPECC_NULL == context->allocation_) {
+        return CPPECC_ERROR;
     }
-    cppecc_u8* generator = context->generator_;
-    cppecc_s32 total = size + numSymbols;
-    for(cppecc_s32 i = size; i < total; ++i) {
-        result[i] = 0;
+    cppecc_u8* storage = CPPECC_STATIC_CAST(cppecc_u8*)(context->allocation_);
+    cppecc_u8* base = storage + (rs_align_line(CPPECC_REINTERPRET_CAST(uintptr_t)(storage)) - CPPECC_REINTERPRET_CAST(uintptr_t)(storage));
+    context->field_ = field;
+    context->numSymbols_ = numSymbols;
+    context->stride_ = stride;
+    context->rows_ = CPPECC_REINTERPRET_CAST(cppecc_u16*)(base);
+    context->roots_ = CPPECC_REINTERPRET_CAST(cppecc_u16*)(base + rowsSize);
+    context->chien_ = base + rowsSize + rootsSize;
+
+    // The product of (x + alpha^i), coefficients are ordered from the highest degree
+    cppecc_u16* generator = context->generator_;
+    generator[0] = 1;
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        cppecc_u16 root = field->exp_[i];
+        generator[i + 1] = 0;
+        for(cppecc_s32 j = i + 1; 0 < j; --j) {
+            generator[j] ^= gf16_field_mul(field, generator[j - 1], root);
+        }
     }
 
-    for(cppecc_s32 i = 0; i < size; ++i) {
-        if(0 != result[i]) {
-            for(cppecc_s32 j = 1; j <= numSymbols; ++j) {
-                result[i + j] ^= gf_mul(generator[j], result[i]);
+    // b*x^numSymbols mod generator is the product with the generator's coefficients.
+    // b*x^(numSymbols+1) mod generator is that shifted once more, and the top coefficient is fed back.
+    for(cppecc_u32 h = 0; h < 2; ++h) {
+        for(cppecc_u32 b = 0; b < 256; ++b) {
+            cppecc_u16 x = CPPECC_STATIC_CAST(cppecc_u16)(b << (8 * h));
+            cppecc_u16* row0 = CPPECC_ROW16(context->rows_, stride, 0, h, b);
+            cppecc_u16* row1 = CPPECC_ROW16(context->rows_, stride, 1, h, b);
+            for(cppecc_s32 k = 0; k < stride; ++k) {
+                row0[k] = (k < numSymbols) ? gf16_field_mul(field, generator[k + 1], x) : 0;
+            }
+            for(cppecc_s32 k = 0; k < stride; ++k) {
+                cppecc_u16 next = ((k + 1) < numSymbols) ? row0[k + 1] : 0;
+                row1[k] = (k < numSymbols) ? (next ^ gf16_field_mul(field, generator[k + 1], row0[0])) : 0;
             }
         }
     }
-    for(cppecc_s32 i = size; i < total; ++i) {
-        message[i] = result[i];
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        for(cppecc_u32 b = 0; b < 256; ++b) {
+            context->roots_[(i * 2 + 0) * 256 + b] = gf16_mulexp(field, CPPECC_STATIC_CAST(cppecc_u16)(b), i);
+            context->roots_[(i * 2 + 1) * 256 + b] = gf16_mulexp(field, CPPECC_STATIC_CAST(cppecc_u16)(b << 8), i);
+        }
     }
-}
-
-#if 0
-bool rs_has_erros(cppecc_s32 size, const cppecc_u8 syndromes[])
-{
-    for(cppecc_s32 i = 1; i <= size; ++i) {
-        if(0 != syndromes[i]) {
-            return true;
+    // The Chien search steps 16 positions, that multiplies term m by alpha^(16*m) with shuffles of nibbles
+    for(cppecc_s32 m = 1; m <= (numSymbols / 2); ++m) {
+        for(cppecc_s32 n = 0; n < 4; ++n) {
+            for(cppecc_u32 v = 0; v < 16; ++v) {
+                cppecc_u16 x = gf16_mulexp(field, CPPECC_STATIC_CAST(cppecc_u16)(v << (4 * n)), CPPECC_STATIC_CAST(cppecc_u32)(16 * m));
+                context->chien_[((m - 1) * 8 + n) * 16 + v] = CPPECC_STATIC_CAST(cppecc_u8)(x & 0xFFU);
+                context->chien_[((m - 1) * 8 + 4 + n) * 16 + v] = CPPECC_STATIC_CAST(cppecc_u8)(x >> 8);
+            }
         }
     }
-    return false;
+    return 0;
 }
 
-void rs_forney_syndromes(cppecc_u8 forney_syndromes[], cppecc_s32 message_size, cppecc_s32 numSyndromes, const cppecc_u8 syndromes[], cppecc_s32 numErasePos, const cppecc_u8 erasePos[])
+void gf16_terminate(CPPECC_STRUCT RS16Context* context)
 {
-    for(cppecc_s32 i = 0; i < numSyndromes; ++i) {
-        forney_syndromes[i] = syndromes[i];
-    }
-    for(cppecc_s32 i = 0; i < numErasePos; ++i) {
-        cppecc_u8 x = gfexp[message_size - 1 - erasePos[i]];
-        for(cppecc_s32 j = 0; j < numSyndromes - 1; ++j) {
-            forney_syndromes[j] = gf_mul(forney_syndromes[j], x) ^ forney_syndromes[j + 1];
-        }
-    }
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_FREE(context->allocation_);
+    context->allocation_ = CPPECC_NULL;
 }
-#endif
 
-cppecc_s32 rs_modified_berlekamp_massey(CPPECC_STRUCT RSContext* context, cppecc_u8 result[], cppecc_s32 numSyndromes, const cppecc_u8 syndromes[])
+cppecc_s32 rs16_berlekamp_massey(CPPECC_STRUCT RS16Context* context, cppecc_u16 result[], cppecc_s32 numSyndromes, const cppecc_u16 syndromes[])
 {
-    cppecc_u8 b0[CPPECC_MAX_ECC_SIZE + 1] = {
+    cppecc_u16 b0[CPPECC_MAX_ECC16_SIZE + 2] = {
         0,
         1,
     };
-    cppecc_u8 b1[CPPECC_MAX_ECC_SIZE + 1] = {
+    cppecc_u16 b1[CPPECC_MAX_ECC16_SIZE + 2] = {
         1,
     };
 
-    cppecc_u8* sg0 = b0;
-    cppecc_u8* sg1 = b1;
-    cppecc_u8* work = context->temp0_;
+    const CPPECC_STRUCT RS16Field* field = context->field_;
+    cppecc_u16* sg0 = b0;
+    cppecc_u16* sg1 = b1;
+    cppecc_u16* work = context->temp0_;
     for(cppecc_s32 i = 0; i <= numSyndromes; ++i) {
         work[i] = 0;
     }
@@ -562,25 +6657,25 @@ cppecc_s32 rs_modified_berlekamp_massey(CPPECC_STRUCT RSContext* context, cppecc
     cppecc_s32 k = -1;
 
     for(cppecc_s32 i = 0; i < numSyndromes; ++i) {
-        cppecc_s32 s = syndromes[i];
+        cppecc_u16 s = syndromes[i];
         for(cppecc_s32 j = 1; j <= s1; ++j) {
-            s ^= gf_mul(sg1[j], syndromes[i - j]);
+            s ^= gf16_field_mul(field, sg1[j], syndromes[i - j]);
         }
         if(0 != s) {
-            cppecc_u8 l = gflog[s];
+            cppecc_u32 l = field->log_[s];
             for(cppecc_s32 j = 0; j <= i; ++j) {
-                work[j] = sg1[j] ^ gf_mulexp(sg0[j], l);
+                work[j] = sg1[j] ^ gf16_mulexp(field, sg0[j], l);
             }
             cppecc_s32 d = i - k;
             if(s1 < d) {
                 for(cppecc_s32 j = 0; j <= s0; ++j) {
-                    sg0[j] = gf_divexp(sg1[j], l);
+                    sg0[j] = gf16_divexp(field, sg1[j], l);
                 }
                 k = i - s1;
                 s0 = d;
                 s1 = d;
             }
-            cppecc_u8* tmp = sg1;
+            cppecc_u16* tmp = sg1;
             sg1 = work;
             work = tmp;
         } //if(0 != s)
@@ -601,113 +6696,607 @@ cppecc_s32 rs_modified_berlekamp_massey(CPPECC_STRUCT RSContext* context, cppecc
     return size;
 }
 
-cppecc_s32 rs_chien_search_two(cppecc_u8 result[2], cppecc_u8 start, cppecc_u8 end, cppecc_u8 a, cppecc_u8 b)
+cppecc_s32 rs16_chien_search(const CPPECC_STRUCT RS16Field* field, cppecc_u16 result[], cppecc_s32 size, cppecc_s32 numSigma, const cppecc_u16 sigma[])
 {
-    for(cppecc_u8 i = start; i < end; ++i) {
-        cppecc_u8 z0 = gfexp[i];
-        cppecc_u8 z1 = CPPECC_STATIC_CAST(cppecc_u8)(a) ^ z0;
-
-        if(b == gf_mulexp(z1, i)) {
-            cppecc_u8 index = gflog[z1];
-            if(index <= i || end <= index) {
-                return -1;
-            }
-            result[0] = z1;
-            result[1] = z0;
-            return 2;
+    // Find X = alpha^i for i < size, that satisfies sigma(X^-1) = 0.
+    // Terms sigma[j]*X^-j are kept as logarithms, and each step subtracts j from them.
+    cppecc_u32 terms[CPPECC_MAX_ECC16_SIZE + 1];
+    cppecc_s32 numTerms = 0;
+    cppecc_u32 steps[CPPECC_MAX_ECC16_SIZE + 1];
+    for(cppecc_s32 j = 1; j < numSigma; ++j) {
+        if(0 != sigma[j]) {
+            terms[numTerms] = field->log_[sigma[j]];
+            steps[numTerms] = CPPECC_GF16_NW1 - j;
+            ++numTerms;
+        }
+    }
+    cppecc_s32 numRoots = numSigma - 1;
+    cppecc_s32 count = 0;
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        cppecc_u16 sum = sigma[0];
+        for(cppecc_s32 j = 0; j < numTerms; ++j) {
+            sum ^= field->exp_[terms[j]];
+            cppecc_u32 t = terms[j] + steps[j];
+            terms[j] = (CPPECC_GF16_NW1 <= t) ? t - CPPECC_GF16_NW1 : t;
+        }
+        if(0 != sum) {
+            continue;
+        }
+        result[count++] = field->exp_[i];
+        if(numRoots <= count) {
+            return count;
         }
     }
     return -1;
 }
 
-cppecc_s32 rs_chien_search(cppecc_u8 result[], cppecc_u8 size, cppecc_u8 numSigma, const cppecc_u8 sigma[])
+void rs16_error_correct_forney(const CPPECC_STRUCT RS16Field* field, cppecc_u16 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u16 pos[], cppecc_s32 numSigma, const cppecc_u16 sigma[], cppecc_s32 numOmega, const cppecc_u16 omega[])
 {
-    cppecc_u8 s0 = numSigma - 1;
-    cppecc_u8 sum = sigma[1];
-    cppecc_u8 mul = sigma[s0];
-    if(1 == s0) {
-        if(size <= gflog[sum]) {
-            return -1;
+    // Y = X * omega(X^-1) / sigma'(X^-1)
+    for(cppecc_s32 i = 0; i < numErrors; ++i) {
+        cppecc_u32 x = field->log_[pos[i]];
+        cppecc_u32 l = (CPPECC_GF16_NW1 - x) % CPPECC_GF16_NW1;
+        cppecc_u32 w = l;
+        cppecc_u16 o = omega[0];
+        for(cppecc_s32 j = 1; j < numOmega; ++j) {
+            o ^= gf16_mulexp(field, omega[j], w);
+            w = (w + l) % CPPECC_GF16_NW1;
         }
-        result[0] = sum;
-        return 1;
+        cppecc_u32 l2 = (2 * l) % CPPECC_GF16_NW1;
+        w = l2;
+        cppecc_u16 d = sigma[1];
+        for(cppecc_s32 j = 3; j < numSigma; j += 2) {
+            d ^= gf16_mulexp(field, sigma[j], w);
+            w = (w + l2) % CPPECC_GF16_NW1;
+        }
+        cppecc_s32 p = length - 1 - CPPECC_STATIC_CAST(cppecc_s32)(x);
+        result[p] ^= gf16_mulexp(field, gf16_field_div(field, o, d), x);
     }
-    if(2 == s0) {
-        return rs_chien_search_two(result, 0, size, sum, mul);
+}
+
+CPPECC_NAMESPACE_EMPTY_BEGIN
+
+#if defined(CPPECC_KERNEL_SSSE3)
+/**
+ @brief Product of 16 symbols and a constant, the symbols are split into registers of low and high bytes.
+ @param [in] table ... chien_ of a term, the low bytes of the products of nibbles 0 to 3, then the high bytes
+ */
+CPPECC_STATIC CPPECC_FORCEINLINE CPPECC_TARGET_SSSE3 void rs16_mul_ssse3(__m128i* lo, __m128i* hi, const cppecc_u8* table)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i n0 = _mm_and_si128(*lo, mask);
+    __m128i n1 = _mm_and_si128(_mm_srli_epi64(*lo, 4), mask);
+    __m128i n2 = _mm_and_si128(*hi, mask);
+    __m128i n3 = _mm_and_si128(_mm_srli_epi64(*hi, 4), mask);
+    const __m128i* t = CPPECC_REINTERPRET_CAST(const __m128i*)(table);
+    *lo = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128(t + 0), n0), _mm_shuffle_epi8(_mm_load_si128(t + 1), n1)),
+                        _mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128(t + 2), n2), _mm_shuffle_epi8(_mm_load_si128(t + 3), n3)));
+    *hi = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128(t + 4), n0), _mm_shuffle_epi8(_mm_load_si128(t + 5), n1)),
+                        _mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128(t + 6), n2), _mm_shuffle_epi8(_mm_load_si128(t + 7), n3)));
+}
+
+/**
+ @brief Same as rs16_chien_scan_scalar, for 16 positions in a step.
+
+ Registers of term m keep the low and high bytes of sigma[L-m]*X^m at 16 positions, and a step multiplies them by alpha^(16*m) with chien_.
+ */
+CPPECC_STATIC CPPECC_TARGET_SSSE3 cppecc_s32 rs16_chien_scan_ssse3(const CPPECC_STRUCT RS16Context* context, cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u16 sigma[], cppecc_u16 positions[], cppecc_u16 odds[])
+{
+    const CPPECC_STRUCT RS16Field* field = context->field_;
+    cppecc_s32 numTerms = numSigma - 1;
+    __m128i lo[CPPECC_MAX_ECC16_SIZE / 2];
+    __m128i hi[CPPECC_MAX_ECC16_SIZE / 2];
+    for(cppecc_s32 m = 1; m <= numTerms; ++m) {
+        cppecc_u8 lanes[32];
+        for(cppecc_s32 l = 0; l < 16; ++l) {
+            cppecc_u16 x = gf16_mulexp(field, sigma[numTerms - m], CPPECC_STATIC_CAST(cppecc_u32)(m * l));
+            lanes[l] = CPPECC_STATIC_CAST(cppecc_u8)(x & 0xFFU);
+            lanes[16 + l] = CPPECC_STATIC_CAST(cppecc_u8)(x >> 8);
+        }
+        lo[m - 1] = _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(lanes));
+        hi[m - 1] = _mm_loadu_si128(CPPECC_REINTERPRET_CAST(const __m128i*)(lanes + 16));
     }
 
-    cppecc_u8 temp0[4];
-    cppecc_u8 index = s0 - 1;
-    for(cppecc_u8 i = 0, z = CPPECC_GF_NW1; i < size; ++i, --z) {
-        cppecc_u8 temp = 1;
-        for(cppecc_u8 j = 1, wz = z; j <= s0; ++j, wz = (wz + z) % CPPECC_GF_NW1) {
-            temp ^= gf_mulexp(sigma[j], wz);
+    // Terms of which L-m is odd are the odd terms of sigma
+    cppecc_s32 firstOdd = 1 + (numTerms & 1);
+    cppecc_s32 firstEven = 2 - (numTerms & 1);
+    cppecc_s32 numRoots = 0;
+    for(cppecc_s32 i = 0; i < length; i += 16) {
+        __m128i evenLo = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(sigma[numTerms] & 0xFFU));
+        __m128i evenHi = _mm_set1_epi8(CPPECC_STATIC_CAST(char)(sigma[numTerms] >> 8));
+        __m128i oddLo = _mm_setzero_si128();
+        __m128i oddHi = _mm_setzero_si128();
+        if(0 != (numTerms & 1)) {
+            oddLo = evenLo;
+            oddHi = evenHi;
+            evenLo = evenHi = _mm_setzero_si128();
         }
-        if(0 != temp) {
+        for(cppecc_s32 m = firstOdd; m <= numTerms; m += 2) {
+            oddLo = _mm_xor_si128(oddLo, lo[m - 1]);
+            oddHi = _mm_xor_si128(oddHi, hi[m - 1]);
+            rs16_mul_ssse3(lo + m - 1, hi + m - 1, context->chien_ + (m - 1) * 128);
+        }
+        for(cppecc_s32 m = firstEven; m <= numTerms; m += 2) {
+            evenLo = _mm_xor_si128(evenLo, lo[m - 1]);
+            evenHi = _mm_xor_si128(evenHi, hi[m - 1]);
+            rs16_mul_ssse3(lo + m - 1, hi + m - 1, context->chien_ + (m - 1) * 128);
+        }
+        __m128i sum = _mm_or_si128(_mm_xor_si128(evenLo, oddLo), _mm_xor_si128(evenHi, oddHi));
+        cppecc_u32 roots = CPPECC_STATIC_CAST(cppecc_u32)(_mm_movemask_epi8(_mm_cmpeq_epi8(sum, _mm_setzero_si128())));
+        if((length - i) < 16) {
+            roots &= (1U << (length - i)) - 1U;
+        }
+        if(0 == roots) {
             continue;
         }
-        cppecc_u8 p = gfexp[i];
-        sum ^= p;
-        mul = gf_div(mul, p);
-        result[index--] = p;
-        if(1 == index) {
-            cppecc_s32 t = rs_chien_search_two(temp0, i + 1, size, sum, mul);
-            if(t < 0) {
-                return -1;
+        cppecc_u8 oddLanes[32];
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(oddLanes), oddLo);
+        _mm_storeu_si128(CPPECC_REINTERPRET_CAST(__m128i*)(oddLanes + 16), oddHi);
+        for(cppecc_s32 l = 0; l < 16; ++l) {
+            if(0 == (roots & (1U << l))) {
+                continue;
+            }
+            positions[numRoots] = CPPECC_STATIC_CAST(cppecc_u16)(i + l);
+            odds[numRoots] = CPPECC_STATIC_CAST(cppecc_u16)(oddLanes[l] | (oddLanes[16 + l] << 8));
+            if(numTerms <= ++numRoots) {
+                return numRoots;
             }
-            result[0] = temp0[0];
-            result[1] = temp0[1];
-            return s0;
         }
     }
-    return -1;
+    return CPPECC_ERROR;
 }
+#endif // CPPECC_KERNEL_SSSE3
 
-void rs_error_correct_forney(cppecc_u8 result[], cppecc_s32 length, cppecc_s32 numErrors, const cppecc_u8 pos[], cppecc_s32 numSigma, const cppecc_u8 sigma[], cppecc_s32 numOmega, const cppecc_u8 omega[])
+/**
+ @brief Find the roots X = alpha^i of sigma(X^-1) for i < length, with the split tables of roots_ instead of log and exp tables.
+ @param [out] positions[] ... i of roots
+ @param [out] odds[] ... the odd terms of X^L*sigma(X^-1) at roots, that is X^(L-1)*sigma'(X^-1)
+ @return The number of roots, or CPPECC_ERROR if sigma doesn't have L = numSigma - 1 roots
+
+ X^L*sigma(X^-1) = sum sigma[L-m]*X^m, so a step multiplies term m by alpha^m with two rows of roots_, m <= L <= numSymbols_/2.
+ */
+CPPECC_STATIC cppecc_s32 rs16_chien_scan_scalar(const CPPECC_STRUCT RS16Context* context, cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u16 sigma[], cppecc_u16 positions[], cppecc_u16 odds[])
 {
-    for(cppecc_s32 i = 0; i < numErrors; ++i) {
-        cppecc_u8 l = CPPECC_GF_NW1 - gflog[pos[i]];
-        cppecc_u8 d = gf_sigma_dash_value(numSigma, sigma, l);
-        cppecc_u8 o = gf_omega_value(numOmega, omega, l);
-        cppecc_s32 p = length - 1 - gflog[pos[i]];
-        result[p] ^= gf_divexp(gf_div(o, d), l);
+    cppecc_s32 numTerms = numSigma - 1;
+    cppecc_u16 terms[CPPECC_MAX_ECC16_SIZE / 2 + 1];
+    for(cppecc_s32 m = 0; m <= numTerms; ++m) {
+        terms[m] = sigma[numTerms - m];
+    }
+    const cppecc_u16* roots = context->roots_;
+    cppecc_s32 firstOdd = 1 + (numTerms & 1);
+    cppecc_s32 firstEven = 2 - (numTerms & 1);
+    cppecc_s32 numRoots = 0;
+    for(cppecc_s32 i = 0; i < length; ++i) {
+        cppecc_u16 even = (0 != (numTerms & 1)) ? 0 : terms[0];
+        cppecc_u16 odd = (0 != (numTerms & 1)) ? terms[0] : 0;
+        for(cppecc_s32 m = firstOdd; m <= numTerms; m += 2) {
+            cppecc_u16 x = terms[m];
+            odd ^= x;
+            terms[m] = roots[(m * 2 + 0) * 256 + (x & 0xFFU)] ^ roots[(m * 2 + 1) * 256 + (x >> 8)];
+        }
+        for(cppecc_s32 m = firstEven; m <= numTerms; m += 2) {
+            cppecc_u16 x = terms[m];
+            even ^= x;
+            terms[m] = roots[(m * 2 + 0) * 256 + (x & 0xFFU)] ^ roots[(m * 2 + 1) * 256 + (x >> 8)];
+        }
+        if(even != odd) {
+            continue;
+        }
+        positions[numRoots] = CPPECC_STATIC_CAST(cppecc_u16)(i);
+        odds[numRoots] = odd;
+        if(numTerms <= ++numRoots) {
+            return numRoots;
+        }
     }
+    return CPPECC_ERROR;
 }
 
-cppecc_s32 rs_decode(CPPECC_STRUCT RSContext* context, cppecc_s32 size, cppecc_u8 message[], cppecc_s32 numSymbols)
+/**
+ @brief Same as rs16_chien_search and rs16_error_correct_forney in a pass, which scans with rs16_chien_scan_ssse3 or rs16_chien_scan_scalar.
+ @return The number of corrected symbols, or CPPECC_ERROR. The message is not changed on errors.
+
+ Y = X*omega(X^-1)/sigma'(X^-1) = X*W/D, with W = X^(L-1)*omega(X^-1) and the odd terms D from the scan.
+ Only W and the division look up the log and exp tables, that is O(L^2) against O(length*L) of the scan.
+ */
+CPPECC_STATIC cppecc_s32 rs16_chien_forney(const CPPECC_STRUCT RS16Context* context, cppecc_u16 message[], cppecc_s32 length, cppecc_s32 numSigma, const cppecc_u16 sigma[], const cppecc_u16 omega[], cppecc_u16 positions[])
 {
-    cppecc_s32 messageSize = size + numSymbols;
-    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(messageSize) < CPPECC_GF_NW);
-    CPPECC_ASSERT(numSymbols <= CPPECC_MAX_ECC_SIZE);
+    cppecc_u16 odds[CPPECC_MAX_ECC16_SIZE / 2];
+    cppecc_s32 numRoots = CPPECC_ERROR;
+#if defined(CPPECC_KERNEL_SSSE3)
+    if(0 != (rs_kernels()->features_ & CPPECC_CPU_SSSE3)) {
+        numRoots = rs16_chien_scan_ssse3(context, length, numSigma, sigma, positions, odds);
+    } else
+#endif
+    {
+        numRoots = rs16_chien_scan_scalar(context, length, numSigma, sigma, positions, odds);
+    }
+    if(numRoots < 0) {
+        return CPPECC_ERROR;
+    }
+    const CPPECC_STRUCT RS16Field* field = context->field_;
+    cppecc_u16 values[CPPECC_MAX_ECC16_SIZE / 2];
+    for(cppecc_s32 k = 0; k < numRoots; ++k) {
+        if(0 == odds[k]) {
+            return CPPECC_ERROR;
+        }
+        // Horner's rule of W at X = alpha^i, coefficients from omega[0] at X^(L-1)
+        cppecc_u32 i = positions[k];
+        cppecc_u16 w = 0;
+        for(cppecc_s32 j = 0; j < numRoots; ++j) {
+            w = gf16_mulexp(field, w, i) ^ omega[j];
+        }
+        values[k] = gf16_mulexp(field, gf16_field_div(field, w, odds[k]), i);
+    }
+    for(cppecc_s32 k = 0; k < numRoots; ++k) {
+        message[length - 1 - positions[k]] ^= values[k];
+    }
+    return numRoots;
+}
+
+CPPECC_NAMESPACE_EMPTY_END
+
+void rs16_encode(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, cppecc_u16 message[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF16_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+    rs16_parity(context, size, message, message + size, numSymbols);
+}
 
-    cppecc_u8* syndromes = context->syndromes_;
-    cppecc_s32 hasError = 0;
+void rs16_encode_scalar(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, cppecc_u16 message[], cppecc_s32 numSymbols)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF16_NW);
+    CPPECC_ASSERT(numSymbols <= CPPECC_MAX_ECC16_SIZE);
+    const CPPECC_STRUCT RS16Field* field = context->field_;
+    const cppecc_u16* generator = context->generator_;
+    cppecc_u16* parity = message + size;
     for(cppecc_s32 i = 0; i < numSymbols; ++i) {
-        syndromes[i] = gf_poly_eval(messageSize, message, gfexp[i]);
-        hasError |= syndromes[i];
+        parity[i] = 0;
+    }
+    for(cppecc_s32 i = 0; i < size; ++i) {
+        cppecc_u16 feedback = message[i] ^ parity[0];
+        for(cppecc_s32 k = 0; k < (numSymbols - 1); ++k) {
+            parity[k] = parity[k + 1] ^ gf16_field_mul(field, generator[k + 1], feedback);
+        }
+        parity[numSymbols - 1] = gf16_field_mul(field, generator[numSymbols], feedback);
     }
+}
+
+cppecc_s32 rs16_syndromes(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, const cppecc_u16 message[], cppecc_s32 numSymbols, cppecc_u16 syndromes[])
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(size + numSymbols) < CPPECC_GF16_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
 
+    // message(alpha^i) = r(alpha^i), the remainder is evaluated with the split tables of alpha^i.
+    cppecc_u16 remainder[CPPECC_MAX_ECC16_SIZE];
+    rs16_parity(context, size, message, remainder, numSymbols);
+    const cppecc_u16* parity = message + size;
+    cppecc_u16 hasError = 0;
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        remainder[i] ^= parity[i];
+        hasError |= remainder[i];
+    }
     if(0 == hasError) {
+        for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+            syndromes[i] = 0;
+        }
+        return 0;
+    }
+    for(cppecc_s32 i = 0; i < numSymbols; ++i) {
+        const cppecc_u16* lo = context->roots_ + (i * 2 + 0) * 256;
+        const cppecc_u16* hi = context->roots_ + (i * 2 + 1) * 256;
+        cppecc_u16 y = remainder[0];
+        for(cppecc_s32 k = 1; k < numSymbols; ++k) {
+            y = lo[y & 0xFFU] ^ hi[y >> 8] ^ remainder[k];
+        }
+        syndromes[i] = y;
+    }
+    return 1;
+}
+
+cppecc_s32 rs16_decode(CPPECC_STRUCT RS16Context* context, cppecc_s32 size, cppecc_u16 message[], cppecc_s32 numSymbols)
+{
+    cppecc_s32 messageSize = size + numSymbols;
+    CPPECC_ASSERT(CPPECC_STATIC_CAST(cppecc_u32)(messageSize) < CPPECC_GF16_NW);
+    CPPECC_ASSERT(numSymbols == context->numSymbols_);
+
+    const CPPECC_STRUCT RS16Field* field = context->field_;
+    cppecc_u16* syndromes = context->syndromes_;
+    if(0 == rs16_syndromes(context, size, message, numSymbols, syndromes)) {
         return 0;
     }
 
-    cppecc_u8* sigma = context->sigma_;
-    cppecc_s32 numSigma = rs_modified_berlekamp_massey(context, sigma, numSymbols, syndromes);
-    if(numSigma < 0) {
+    cppecc_u16* sigma = context->sigma_;
+    cppecc_s32 numSigma = rs16_berlekamp_massey(context, sigma, numSymbols, syndromes);
+    if(numSigma < 0 || numSymbols < 2 * (numSigma - 1)) {
         return CPPECC_ERROR;
     }
 
-    cppecc_u8* errorPositions = context->errorPositions_;
-    cppecc_s32 numErrorPositions = rs_chien_search(errorPositions, CPPECC_STATIC_CAST(cppecc_u8)(messageSize), CPPECC_STATIC_CAST(cppecc_u8)(numSigma), sigma);
-    if(numErrorPositions < 0) {
-        return CPPECC_ERROR;
+    // omega = syndromes * sigma mod x^(numSigma - 1)
+    cppecc_u16* omega = context->omega_;
+    cppecc_s32 numOmega = numSigma - 1;
+    for(cppecc_s32 i = 0; i < numOmega; ++i) {
+        cppecc_u16 o = 0;
+        for(cppecc_s32 j = 0; j <= i; ++j) {
+            o ^= gf16_field_mul(field, syndromes[i - j], sigma[j]);
+        }
+        omega[i] = o;
+    }
+
+    return rs16_chien_forney(context, message, messageSize, numSigma, sigma, omega, context->errorPositions_);
+}
+
+
+#if defined(__cplusplus) && (201103L <= __cplusplus || 1900 <= _MSC_VER) && defined(CPPECC_ENABLE_THREADS)
+RSEngine::RSEngine(const RSContext* context, cppecc_s32 numThreads, cppecc_s32 chunkBlocks)
+    : context_(context)
+    , chunkBlocks_(0 < chunkBlocks ? chunkBlocks : 1)
+    , task_(CPPECC_NULL)
+    , generation_(0)
+    , numBusy_(0)
+    , quit_(false)
+{
+    CPPECC_ASSERT(CPPECC_NULL != context);
+    if(numThreads <= 0) {
+        numThreads = static_cast<cppecc_s32>(std::thread::hardware_concurrency());
+        numThreads = (numThreads <= 0) ? 1 : numThreads;
+    }
+    for(cppecc_s32 i = 0; i < numThreads; ++i) {
+        workers_.push_back(std::unique_ptr<Worker>(new Worker));
+#    if defined(CPPECC_ENABLE_STATS)
+        rs_stats_reset(&workers_[i]->scratch_);
+#    endif
+    }
+    try {
+        for(cppecc_s32 i = 1; i < numThreads; ++i) {
+            workers_[i]->thread_ = std::thread(&RSEngine::loop, this, i);
+        }
+    } catch(...) {
+        // The destructor doesn't run for a throwing constructor, stop the threads which started
+        stop();
+        throw;
+    }
+}
+
+RSEngine::~RSEngine()
+{
+    stop();
+}
+
+void RSEngine::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for(size_t i = 1; i < workers_.size(); ++i) {
+        if(workers_[i]->thread_.joinable()) {
+            workers_[i]->thread_.join();
+        }
+    }
+}
+
+#    if defined(CPPECC_ENABLE_STATS)
+void RSEngine::stats(RSStats* result) const
+{
+    CPPECC_ASSERT(CPPECC_NULL != result);
+    RSStats zero = {};
+    *result = zero;
+    for(size_t i = 0; i < workers_.size(); ++i) {
+        rs_stats_merge(result, &workers_[i]->scratch_.stats_);
+    }
+}
+
+void RSEngine::reset_stats()
+{
+    for(size_t i = 0; i < workers_.size(); ++i) {
+        RSScratch* scratch = &workers_[i]->scratch_;
+        cppecc_error_callback callback = scratch->callback_;
+        void* user = scratch->user_;
+        rs_stats_reset(scratch);
+        rs_stats_set_callback(scratch, callback, user);
+    }
+}
+
+void RSEngine::set_callback(cppecc_error_callback callback, void* user)
+{
+    for(size_t i = 0; i < workers_.size(); ++i) {
+        rs_stats_set_callback(&workers_[i]->scratch_, callback, user);
+    }
+}
+#    endif
+
+cppecc_s32 RSEngine::num_threads() const
+{
+    return static_cast<cppecc_s32>(workers_.size());
+}
+
+void RSEngine::encode(cppecc_size_t size, const cppecc_u8 data[], cppecc_u8 output[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout)
+{
+    CPPECC_ASSERT(0 < blockSize && (blockSize + numSymbols) <= CPPECC_MAX_BODY_SIZE);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context_->numSymbols_);
+    CPPECC_ASSERT(CPPECC_LAYOUT_CODEWORDS == layout || CPPECC_LAYOUT_SEPARATE == layout);
+    const RSContext* context = context_;
+    run(rs_buffer_blocks(size, blockSize), [=](RSScratch*, cppecc_size_t begin, cppecc_size_t end) {
+        rs_encode_blocks(context, size, data, output, blockSize, numSymbols, layout, begin, end);
+    });
+}
+
+cppecc_s32 RSEngine::check(cppecc_size_t size, const cppecc_u8 data[], const cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[])
+{
+    CPPECC_ASSERT(0 < blockSize && (blockSize + numSymbols) <= CPPECC_MAX_BODY_SIZE);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context_->numSymbols_);
+    CPPECC_ASSERT(CPPECC_LAYOUT_CODEWORDS == layout || (CPPECC_LAYOUT_SEPARATE == layout && CPPECC_NULL != parity));
+    const RSContext* context = context_;
+    std::atomic<cppecc_s32> numDirty(0);
+    run(rs_buffer_blocks(size, blockSize), [=, &numDirty](RSScratch*, cppecc_size_t begin, cppecc_size_t end) {
+        numDirty += rs_check_blocks(context, size, data, parity, blockSize, numSymbols, layout, begin, end, status);
+    });
+    return numDirty.load();
+}
+
+cppecc_s32 RSEngine::decode(cppecc_size_t size, cppecc_u8 data[], cppecc_u8 parity[], cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 status[])
+{
+    CPPECC_ASSERT(0 < blockSize && (blockSize + numSymbols) <= CPPECC_MAX_BODY_SIZE);
+    CPPECC_ASSERT(0 < numSymbols && numSymbols == context_->numSymbols_);
+    CPPECC_ASSERT(CPPECC_LAYOUT_CODEWORDS == layout || (CPPECC_LAYOUT_SEPARATE == layout && CPPECC_NULL != parity));
+    const RSContext* context = context_;
+    std::atomic<cppecc_s32> total(0);
+    std::atomic<cppecc_s32> numFailed(0);
+    run(rs_buffer_blocks(size, blockSize), [=, &total, &numFailed](RSScratch* scratch, cppecc_size_t begin, cppecc_size_t end) {
+        cppecc_s32 failed = 0;
+        total += rs_decode_blocks(context, scratch, size, data, parity, blockSize, numSymbols, layout, begin, end, status, &failed);
+        numFailed += failed;
+    });
+    return (0 < numFailed.load()) ? CPPECC_ERROR : total.load();
+}
+
+RSEngineBenchmark RSEngine::benchmark(cppecc_size_t size, cppecc_s32 blockSize, cppecc_s32 numSymbols, cppecc_s32 layout, cppecc_s32 iterations)
+{
+    RSEngineBenchmark result = {num_threads(), 0.0, 0.0, 0.0};
+    if(0 == size || iterations <= 0) {
+        return result;
+    }
+    const bool separate = CPPECC_LAYOUT_SEPARATE == layout;
+    const cppecc_size_t numBlocks = rs_buffer_blocks(size, blockSize);
+    std::vector<cppecc_u8> data(size);
+    std::vector<cppecc_u8> encoded(rs_buffer_encoded_size(size, blockSize, numSymbols, layout));
+    std::vector<cppecc_u8> received;
+    std::vector<cppecc_u8> parity;
+    std::vector<cppecc_s32> status(numBlocks);
+    cppecc_u32 x = 0x9E3779B9U;
+    for(cppecc_size_t i = 0; i < size; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = static_cast<cppecc_u8>(x);
+    }
+
+    const cppecc_size_t stride = separate ? blockSize : blockSize + numSymbols;
+    cppecc_f64 encodeTime = 0.0;
+    cppecc_f64 checkTime = 0.0;
+    cppecc_f64 decodeTime = 0.0;
+    for(cppecc_s32 i = 0; i < iterations; ++i) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        encode(size, &data[0], &encoded[0], blockSize, numSymbols, layout);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        encodeTime += std::chrono::duration<cppecc_f64>(end - start).count();
+
+        received = separate ? data : encoded;
+        parity = separate ? encoded : std::vector<cppecc_u8>(1);
+        start = std::chrono::steady_clock::now();
+        check(size, &received[0], &parity[0], blockSize, numSymbols, layout, &status[0]);
+        end = std::chrono::steady_clock::now();
+        checkTime += std::chrono::duration<cppecc_f64>(end - start).count();
+
+        for(cppecc_size_t b = 0; b < numBlocks; b += 64) {
+            for(cppecc_s32 e = 0; e < (numSymbols >> 1); ++e) {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                received[b * stride + (x % rs_buffer_block_size(size, blockSize, b))] ^= static_cast<cppecc_u8>(x >> 24) | 1U;
+            }
+        }
+        start = std::chrono::steady_clock::now();
+        decode(size, &received[0], &parity[0], blockSize, numSymbols, layout, &status[0]);
+        end = std::chrono::steady_clock::now();
+        decodeTime += std::chrono::duration<cppecc_f64>(end - start).count();
+    }
+    cppecc_f64 megaBytes = static_cast<cppecc_f64>(size) * iterations / (1024.0 * 1024.0);
+    result.encode_ = megaBytes / encodeTime;
+    result.check_ = megaBytes / checkTime;
+    result.decode_ = megaBytes / decodeTime;
+    return result;
+}
+
+void RSEngine::run(cppecc_size_t numBlocks, const Task& task)
+{
+    std::lock_guard<std::mutex> serial(runMutex_);
+    cppecc_size_t numChunks = (numBlocks + chunkBlocks_ - 1) / chunkBlocks_;
+    cppecc_size_t numWorkers = workers_.size();
+    for(cppecc_size_t w = 0; w < numWorkers; ++w) {
+        Worker& worker = *workers_[w];
+        std::lock_guard<std::mutex> lock(worker.mutex_);
+        for(cppecc_size_t c = numChunks * w / numWorkers; c < numChunks * (w + 1) / numWorkers; ++c) {
+            cppecc_size_t begin = c * chunkBlocks_;
+            cppecc_size_t end = begin + chunkBlocks_;
+            Chunk chunk = {begin, end < numBlocks ? end : numBlocks};
+            worker.chunks_.push_back(chunk);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        ++generation_;
+        numBusy_ = static_cast<cppecc_s32>(numWorkers) - 1;
+    }
+    wake_.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return 0 == numBusy_; });
+    task_ = CPPECC_NULL;
+}
+
+void RSEngine::loop(cppecc_s32 index)
+{
+    cppecc_u64 generation = 0;
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, generation] { return quit_ || generation != generation_; });
+            if(quit_) {
+                return;
+            }
+            generation = generation_;
+        }
+        work(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --numBusy_;
+            if(0 == numBusy_) {
+                done_.notify_one();
+            }
+        }
+    }
+}
+
+void RSEngine::work(cppecc_s32 index)
+{
+    RSScratch* scratch = &workers_[index]->scratch_;
+    Chunk chunk;
+    while(take(index, chunk)) {
+        (*task_)(scratch, chunk.begin_, chunk.end_);
     }
-    cppecc_u8* omega = context->omega_;
-    cppecc_s32 numOmega = gf_poly_mul_len(omega, numSymbols, syndromes, numSigma, sigma, numSigma - 1);
+}
 
-    rs_error_correct_forney(message, messageSize, numErrorPositions, errorPositions, numSigma, sigma, numOmega, omega);
-    return numSigma - 1;
+bool RSEngine::take(cppecc_s32 index, Chunk& chunk)
+{
+    {
+        Worker& worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex_);
+        if(!worker.chunks_.empty()) {
+            chunk = worker.chunks_.front();
+            worker.chunks_.pop_front();
+            return true;
+        }
+    }
+    // Chunks are never added while running, so all queues are empty if nothing is stolen.
+    cppecc_s32 numWorkers = static_cast<cppecc_s32>(workers_.size());
+    for(cppecc_s32 i = 1; i < numWorkers; ++i) {
+        Worker& victim = *workers_[(index + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim.mutex_);
+        if(!victim.chunks_.empty()) {
+            chunk = victim.chunks_.back();
+            victim.chunks_.pop_back();
+            return true;
+        }
+    }
+    return false;
 }
+#endif
 
 CPPECC_NAMESPACE_EMPTY_BEGIN
 CPPECC_NAMESPACE_EMPTY_END
@@ -144,6 +144,7 @@ struct Result reed_solomon(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s3
     free(decoded);
     free(encoded);
     free(message);
+    gf_terminate(&context);
     return result;
 }
 
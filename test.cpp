@@ -1,19 +1,20 @@
 #define CPPECC_IMPLEMENTATION
+#define CPPECC_ENABLE_THREADS
 #include "cppecc.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <random>
-#include <chrono>
+#include <algorithm>
+#include <type_traits>
 
 using namespace cppecc;
 
 struct Result
 {
-    long long encodeTime_;
-    long long decodeTime_;
     cppecc_s32 numErrors_;
     cppecc_s64 avgErrors_;
 };
@@ -50,9 +51,1590 @@ void error_check()
             assert(false);
         }
     }
+    gf_terminate(&context);
 }
 #endif
 
+template<class Params>
+void field_check(cppecc_u32 polynomial, cppecc_s32 fcr, cppecc_s32 prim, cppecc_s32 count)
+{
+    const RSField& field = Params::field;
+    RSField runtime;
+    if(0 != gf_field_build(&runtime, polynomial, fcr, prim)
+       || !std::equal(runtime.log_, runtime.log_ + CPPECC_GF_NW, field.log_)
+       || !std::equal(runtime.exp_, runtime.exp_ + CPPECC_GF_NW, field.exp_)
+       || runtime.fcr_ != field.fcr_ || runtime.prim_ != field.prim_) {
+        std::cout << "field table mismatch polynomial: " << polynomial << std::endl;
+        assert(false);
+    }
+
+    std::mt19937 engine(polynomial);
+    RSContext context;
+    for(cppecc_s32 eccSize = 2; eccSize <= CPPECC_MAX_ECC_SIZE; eccSize += 5) {
+        gf_initialize_field(&context, eccSize, &field);
+        const cppecc_s32 messageSize = CPPECC_GF_NW1 - eccSize;
+        // Functions without a field work on the default field
+        if(0x11DU == polynomial && 0 == fcr && 1 == prim) {
+            cppecc_u8 generator[CPPECC_GF_NW];
+            cppecc_u8 temp[CPPECC_GF_NW];
+            rs_generator_poly(eccSize, generator, temp);
+            if(!std::equal(generator, generator + eccSize + 1, context.generator_)
+               || gf_poly_eval(eccSize + 1, generator, 2) != gf_field_poly_eval(&field, eccSize + 1, generator, 2)) {
+                std::cout << "default field functions mismatch ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+        }
+        std::vector<cppecc_u8> message(CPPECC_GF_NW1);
+        std::vector<cppecc_u8> decoded;
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            for(cppecc_s32 j = 0; j < messageSize; ++j) {
+                message[j] = static_cast<cppecc_u8>(engine() & 0xFFU);
+            }
+            rs_encode(&context, messageSize, &message[0], eccSize);
+            // The codeword has roots beta^(fcr+j)
+            for(cppecc_s32 j = 0; j < eccSize; ++j) {
+                if(0 != gf_field_poly_eval(&field, CPPECC_GF_NW1, &message[0], field.exp_[(field.fcr_ + j) % CPPECC_GF_NW1])) {
+                    std::cout << "not a codeword polynomial: " << polynomial << ", ecc size: " << eccSize << std::endl;
+                    assert(false);
+                }
+            }
+            decoded = message;
+            cppecc_s32 numErrors = static_cast<cppecc_s32>(engine() % (eccSize / 2 + 1));
+            for(cppecc_s32 j = 0; j < numErrors; ++j) {
+                decoded[engine() % CPPECC_GF_NW1] ^= static_cast<cppecc_u8>(engine() | 1U);
+            }
+            if(rs_decode(&context, messageSize, &decoded[0], eccSize) < 0 || decoded != message) {
+                std::cout << "field decode error polynomial: " << polynomial << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+        }
+        gf_terminate(&context);
+    }
+    std::cout << "field: polynomial: 0x" << std::hex << polynomial << std::dec << " fcr: " << fcr << " prim: " << prim << " ok" << std::endl;
+}
+
+void encode_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    std::vector<cppecc_u8> message;
+    message.resize((messageSize+eccSize)*count);
+    std::vector<cppecc_u8> reference;
+    reference.resize((messageSize+eccSize)*count);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(size_t i=0; i<message.size(); ++i){
+        message[i] = static_cast<cppecc_u8>(engine()&0xFFU);
+    }
+    std::copy(message.begin(), message.end(), reference.begin());
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode_scalar(&context, messageSize, &reference[(messageSize+eccSize)*i], eccSize);
+    }
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode(&context, messageSize, &message[(messageSize+eccSize)*i], eccSize);
+    }
+
+    for(size_t i=0; i<message.size(); ++i){
+        if(message[i] != reference[i]){
+            std::cout << "encode mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    }
+    std::cout << "encode: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+void syndrome_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u8> message;
+    message.resize(total*count);
+    std::vector<cppecc_u8> syndromes;
+    syndromes.resize(eccSize*count);
+    std::vector<cppecc_u8> reference;
+    reference.resize(eccSize*count);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* m = &message[total*i];
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            m[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(&context, messageSize, m, eccSize);
+        // Corrupt every other codeword
+        if(i&1){
+            m[engine()%total] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+    }
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j = 0; j < eccSize; ++j) {
+            reference[eccSize*i+j] = gf_field_poly_eval(context.field_, total, &message[total*i], gf_pow(2, j));
+        }
+    }
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_s32 hasError = rs_syndromes(&context, messageSize, &message[total*i], eccSize, &syndromes[eccSize*i]);
+        if(hasError != (i&1)){
+            std::cout << "syndrome error flag mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    }
+
+    for(size_t i=0; i<syndromes.size(); ++i){
+        if(syndromes[i] != reference[i]){
+            std::cout << "syndrome mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    }
+    std::cout << "syndromes: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+void slicing_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    static const cppecc_s32 Slices[] = {1, 4, 8};
+    std::vector<cppecc_u8> reference;
+    reference.resize(total*count);
+    std::vector<cppecc_u8> message;
+    message.resize(total*count);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(size_t i=0; i<reference.size(); ++i){
+        reference[i] = static_cast<cppecc_u8>(engine()&0xFFU);
+    }
+    std::copy(reference.begin(), reference.end(), message.begin());
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode_scalar(&context, messageSize, &reference[total*i], eccSize);
+    }
+
+    for(cppecc_s32 s = 0; s < 3 && Slices[s] <= context.numSlices_; ++s) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            rs_encode_slicing(&context, messageSize, &message[total*i], eccSize, Slices[s]);
+        }
+        if(message != reference){
+            std::cout << "slicing mismatch message size: " << messageSize << ", ecc size: " << eccSize << ", slices: " << Slices[s] << std::endl;
+            assert(false);
+        }
+    }
+    std::cout << "slicing: message size: " << messageSize << " ecc size: " << eccSize << " slices: " << context.numSlices_ << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+//! Kernel sets from the portable kernels to the widest ones
+static const cppecc_u32 KernelSets[] = {
+    0,
+    CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3,
+    CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3 | CPPECC_CPU_AVX2,
+    CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3 | CPPECC_CPU_AVX2 | CPPECC_CPU_GFNI,
+    CPPECC_CPU_SSE2 | CPPECC_CPU_SSSE3 | CPPECC_CPU_AVX2 | CPPECC_CPU_AVX512BW | CPPECC_CPU_GFNI,
+};
+static const cppecc_s32 NumKernelSets = sizeof(KernelSets) / sizeof(KernelSets[0]);
+
+/**
+ @brief Run a check with each of KernelSets bound, and bind the best kernels again at the end
+ @param check ... called with the selected kernels
+ */
+template<class T>
+void for_each_kernels(T check)
+{
+    for(cppecc_s32 f = 0; f < NumKernelSets; ++f) {
+        cppecc_u32 features = KernelSets[f] & rs_cpu_features();
+        cppecc_u32 selected = rs_select_kernels(features);
+        if(0 != (selected & ~features)){
+            std::cout << "kernels selected: " << selected << " out of features: " << features << std::endl;
+            assert(false);
+        }
+        check(selected);
+    }
+    rs_select_kernels(~0U);
+}
+
+void remainder_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u8> message;
+    message.resize(total*count);
+    std::vector<cppecc_u8> remainder;
+    remainder.resize(total);
+    std::vector<cppecc_u8> syndromes;
+    syndromes.resize(eccSize);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* m = &message[total*i];
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            m[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(&context, messageSize, m, eccSize);
+        // Corrupt one of every 16 codewords
+        if(0 == (i&15)){
+            m[engine()%total] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+    }
+
+    cppecc_s32 numDirty = 0;
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        numDirty += rs_syndromes(&context, messageSize, &message[total*i], eccSize, &syndromes[0]);
+    }
+    cppecc_s32 numChecked = 0;
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        numChecked += rs_check(&context, messageSize, &message[total*i], eccSize);
+    }
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_s32 size = gf_field_poly_div(context.field_, &remainder[0], total, &message[total*i], eccSize+1, context.generator_);
+        cppecc_s32 dirty = 0;
+        for(cppecc_s32 j = 0; j < size; ++j) {
+            dirty |= (0 != remainder[j]) ? 1 : 0;
+        }
+        if(dirty != rs_check(&context, messageSize, &message[total*i], eccSize)){
+            std::cout << "check mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    }
+    if(numDirty != numChecked){
+        std::cout << "check count mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    std::cout << "check: message size: " << messageSize << " ecc size: " << eccSize << " corrupted: " << numChecked << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+void batch_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u8> reference;
+    reference.resize(total*count);
+    std::vector<cppecc_u8> batch;
+    batch.resize(total*count);
+    std::vector<cppecc_u8> interleaved;
+    interleaved.resize(total*count);
+    std::vector<cppecc_u8*> messages;
+    messages.resize(count);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            reference[total*i+j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        messages[i] = &batch[total*i];
+    }
+    std::copy(reference.begin(), reference.end(), batch.begin());
+    rs_interleave(count, messageSize, &messages[0], &interleaved[0]);
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode(&context, messageSize, &reference[total*i], eccSize);
+    }
+    rs_encode_batch(&context, count, messageSize, &messages[0], eccSize);
+    rs_encode_interleaved(&context, count, messageSize, &interleaved[0], eccSize);
+
+    if(batch != reference){
+        std::cout << "batch mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    std::fill(batch.begin(), batch.end(), 0);
+    rs_deinterleave(count, total, &interleaved[0], &messages[0]);
+    if(batch != reference){
+        std::cout << "interleaved mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    std::cout << "batch: message size: " << messageSize << " ecc size: " << eccSize << " count: " << count << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+void erasure_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u8> message;
+    message.resize(total);
+    std::vector<cppecc_u8> decoded;
+    decoded.resize(total);
+    std::vector<cppecc_u8> positions;
+    positions.resize(total);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(&context, messageSize, &message[0], eccSize);
+        for(cppecc_s32 j=0; j<total; ++j){
+            positions[j] = static_cast<cppecc_u8>(j);
+        }
+        std::shuffle(positions.begin(), positions.end(), engine);
+
+        // Even: erasures only up to the number of redundant symbols, Odd: erasures and errors with e + 2v <= eccSize
+        cppecc_s32 numErasures = (i&1)? static_cast<cppecc_s32>(engine()%(eccSize+1)) : eccSize;
+        cppecc_s32 numErrors = (eccSize-numErasures)>>1;
+        decoded = message;
+        for(cppecc_s32 j=0; j<(numErasures+numErrors); ++j){
+            decoded[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+
+        cppecc_s32 corrected = rs_decode_erasures(&context, messageSize, &decoded[0], eccSize, &positions[0], numErasures);
+        if(corrected<0 || decoded != message){
+            std::cout << "erasure decode error message size: " << messageSize << ", ecc size: " << eccSize << ", erasures: " << numErasures << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+    }
+
+    // Positions out of the codeword are rejected before anything is read or written
+    if(total < CPPECC_MAX_BODY_SIZE){
+        decoded = message;
+        decoded[0] ^= 1U;
+        std::vector<cppecc_u8> corrupted(decoded);
+        positions[0] = static_cast<cppecc_u8>(total+static_cast<cppecc_s32>(engine()%(CPPECC_MAX_BODY_SIZE-total)));
+        positions[1] = 0;
+        if(CPPECC_ERROR != rs_decode_erasures(&context, messageSize, &decoded[0], eccSize, &positions[0], std::min(eccSize, 2)) || decoded != corrupted){
+            std::cout << "erasure out of range accepted message size: " << messageSize << ", ecc size: " << eccSize << ", position: " << int(positions[0]) << std::endl;
+            assert(false);
+        }
+    }
+
+    // Repeated positions are rejected, and the message is untouched
+    if(2 <= eccSize){
+        decoded = message;
+        decoded[positions[2]] ^= 1U;
+        std::vector<cppecc_u8> corrupted(decoded);
+        cppecc_u8 repeated[3] = {positions[2], positions[2], positions[1]};
+        if(CPPECC_ERROR != rs_decode_erasures(&context, messageSize, &decoded[0], eccSize, repeated, std::min(eccSize, 3)) || decoded != corrupted){
+            std::cout << "erasure repeated position accepted message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    }
+
+    // Beyond the capability 'e + 2v <= eccSize', the result is CPPECC_ERROR with the message untouched, or a codeword
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(&context, messageSize, &message[0], eccSize);
+        for(cppecc_s32 j=0; j<total; ++j){
+            positions[j] = static_cast<cppecc_u8>(j);
+        }
+        std::shuffle(positions.begin(), positions.end(), engine);
+        cppecc_s32 numErasures = static_cast<cppecc_s32>(engine()%(eccSize+1));
+        cppecc_s32 numErrors = std::min(((eccSize-numErasures)>>1) + 1 + static_cast<cppecc_s32>(engine()%2), total-numErasures);
+        decoded = message;
+        for(cppecc_s32 j=0; j<(numErasures+numErrors); ++j){
+            decoded[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        std::vector<cppecc_u8> corrupted(decoded);
+        cppecc_s32 corrected = rs_decode_erasures(&context, messageSize, &decoded[0], eccSize, &positions[0], numErasures);
+        if((corrected<0 && decoded != corrupted) || (0<=corrected && 0 != rs_check(&context, messageSize, &decoded[0], eccSize))){
+            std::cout << "erasure over capability error message size: " << messageSize << ", ecc size: " << eccSize << ", erasures: " << numErasures << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+    }
+    std::cout << "erasures: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+void chien_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    const cppecc_s32 maxErrors = eccSize>>1;
+    std::vector<cppecc_u8> message(total);
+    std::vector<cppecc_u8> decoded(total);
+    std::vector<cppecc_u8> expected(total);
+    std::vector<cppecc_u8> positions(total);
+    cppecc_u8 syndromes[CPPECC_GF_NW];
+    cppecc_u8 sigma[CPPECC_GF_NW];
+    cppecc_u8 omega[CPPECC_GF_NW+CPPECC_GF_NW];
+    cppecc_u8 roots[CPPECC_GF_NW];
+
+    RSContext* context = rs_context_alloc(eccSize, gf_default_field());
+    const RSField* field = context->field_;
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(context, messageSize, &message[0], eccSize);
+        for(cppecc_s32 j=0; j<total; ++j){
+            positions[j] = static_cast<cppecc_u8>(j);
+        }
+        std::shuffle(positions.begin(), positions.end(), engine);
+
+        // Even: the maximum number of errors, Odd: one more than that, the message should be untouched if it fails
+        cppecc_s32 numErrors = maxErrors + (i&1);
+        decoded = message;
+        for(cppecc_s32 j=0; j<numErrors; ++j){
+            decoded[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        rs_syndromes(context, messageSize, &decoded[0], eccSize, syndromes);
+        cppecc_s32 numSigma = rs_modified_berlekamp_massey(context, sigma, eccSize, syndromes);
+        if(numSigma < 2){
+            continue;
+        }
+        cppecc_s32 numOmega = gf_field_poly_mul_len(field, omega, eccSize, syndromes, numSigma, sigma, numSigma-1);
+
+        expected = decoded;
+        cppecc_s32 numRoots = rs_field_chien_search(field, roots, static_cast<cppecc_u8>(total), static_cast<cppecc_u8>(numSigma), sigma);
+        if(0 <= numRoots){
+            rs_field_error_correct_forney(field, &expected[0], total, numRoots, roots, numSigma, sigma, numOmega, omega);
+        }
+
+        std::vector<cppecc_u8> original = decoded;
+        cppecc_s32 corrected = rs_chien_forney(context, &decoded[0], total, numSigma, sigma, numOmega, omega);
+
+        bool valid = (numSigma-1) <= maxErrors;
+        if(numErrors <= maxErrors && (corrected != numErrors || decoded != message)){
+            std::cout << "chien decode error message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+        if(corrected < 0 ? (decoded != original) : (!valid || numRoots != corrected || decoded != expected)){
+            std::cout << "chien mismatch message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+    }
+    rs_context_free(context);
+    std::cout << "chien: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+}
+
+void constant_check(cppecc_s32 messageSize, cppecc_s32 eccSize, const RSField* field, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    const cppecc_s32 maxErrors = eccSize>>1;
+    std::vector<cppecc_u8> message(total);
+    std::vector<cppecc_u8> decoded(total);
+    std::vector<cppecc_u8> expected(total);
+    std::vector<cppecc_u8> positions(total);
+
+    RSContext* context = rs_context_alloc(eccSize, field);
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(context, messageSize, &message[0], eccSize);
+        for(cppecc_s32 j=0; j<total; ++j){
+            positions[j] = static_cast<cppecc_u8>(j);
+        }
+        std::shuffle(positions.begin(), positions.end(), engine);
+
+        // From no errors to one more than the capability
+        cppecc_s32 numErrors = std::min(i%(maxErrors+2), total);
+        decoded = message;
+        for(cppecc_s32 j=0; j<numErrors; ++j){
+            decoded[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        expected = decoded;
+        cppecc_s32 result = rs_decode(context, messageSize, &expected[0], eccSize);
+        cppecc_s32 corrected = rs_decode_constant(context, messageSize, &decoded[0], eccSize);
+
+        if(numErrors <= maxErrors && (corrected != numErrors || decoded != message)){
+            std::cout << "constant decode error message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+        if(corrected != result || decoded != expected){
+            std::cout << "constant mismatch message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+    }
+    rs_context_free(context);
+    std::cout << "constant: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+}
+
+void dispatch_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    assert(0 < messageSize && 0 < eccSize);
+    const cppecc_s32 total = messageSize+eccSize;
+    const cppecc_s32 maxErrors = eccSize>>1;
+    std::vector<cppecc_u8> encoded(static_cast<size_t>(count)*total);
+    std::vector<cppecc_u8> corrupted(static_cast<size_t>(count)*total);
+    std::vector<cppecc_u8> expected(static_cast<size_t>(count)*total);
+    std::vector<cppecc_s32> results(count);
+    std::vector<cppecc_u8> syndromes(static_cast<size_t>(count)*eccSize);
+    std::vector<cppecc_u8> buffer(total);
+    std::vector<cppecc_u8> positions(total);
+
+    RSContext* context = rs_context_alloc(eccSize, gf_default_field());
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* message = &encoded[static_cast<size_t>(i)*total];
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode_scalar(context, messageSize, message, eccSize);
+        for(cppecc_s32 j=0; j<total; ++j){
+            positions[j] = static_cast<cppecc_u8>(j);
+        }
+        std::shuffle(positions.begin(), positions.end(), engine);
+        cppecc_u8* decoded = &corrupted[static_cast<size_t>(i)*total];
+        std::copy(message, message+total, decoded);
+        // From no errors to one more than the capability
+        cppecc_s32 numErrors = std::min(i%(maxErrors+2), total);
+        for(cppecc_s32 j=0; j<numErrors; ++j){
+            decoded[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+    }
+
+    // The portable kernels are the reference of others
+    for_each_kernels([&](cppecc_u32 selected) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            const cppecc_u8* message = &encoded[static_cast<size_t>(i)*total];
+            const cppecc_u8* decoded = &corrupted[static_cast<size_t>(i)*total];
+            std::copy(message, message+messageSize, buffer.begin());
+            rs_encode(context, messageSize, &buffer[0], eccSize);
+            if(!std::equal(buffer.begin(), buffer.end(), message)){
+                std::cout << "dispatch encode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+            cppecc_s32 dirty = std::equal(message, message+total, decoded)? 0 : 1;
+            if(dirty != rs_check(context, messageSize, decoded, eccSize)){
+                std::cout << "dispatch check error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+
+            cppecc_u8* syndrome = &syndromes[static_cast<size_t>(i)*eccSize];
+            rs_syndromes(context, messageSize, decoded, eccSize, &buffer[0]);
+            if(0 == selected){
+                std::copy(buffer.begin(), buffer.begin()+eccSize, syndrome);
+            } else if(!std::equal(syndrome, syndrome+eccSize, buffer.begin())){
+                std::cout << "dispatch syndromes mismatch kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+
+            cppecc_u8* reference = &expected[static_cast<size_t>(i)*total];
+            std::copy(decoded, decoded+total, buffer.begin());
+            cppecc_s32 corrected = rs_decode(context, messageSize, &buffer[0], eccSize);
+            if(0 == selected){
+                results[i] = corrected;
+                std::copy(buffer.begin(), buffer.end(), reference);
+            } else if(corrected != results[i] || !std::equal(buffer.begin(), buffer.end(), reference)){
+                std::cout << "dispatch decode mismatch kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+            std::copy(decoded, decoded+total, buffer.begin());
+            corrected = rs_decode_constant(context, messageSize, &buffer[0], eccSize);
+            if(corrected != results[i] || !std::equal(buffer.begin(), buffer.end(), reference)){
+                std::cout << "dispatch constant mismatch kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+        }
+
+        // The batch encoder has as many lanes as the bound kernels
+        std::vector<cppecc_u8> batch(encoded.size());
+        std::vector<cppecc_u8*> messages(count);
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            messages[i] = &batch[static_cast<size_t>(i)*total];
+            std::copy(&encoded[static_cast<size_t>(i)*total], &encoded[static_cast<size_t>(i)*total]+messageSize, messages[i]);
+        }
+        rs_encode_batch(context, count, messageSize, &messages[0], eccSize);
+        if(batch != encoded){
+            std::cout << "dispatch batch error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    });
+    rs_context_free(context);
+    std::cout << "dispatch: message size: " << messageSize << " ecc size: " << eccSize << " features: " << std::hex << rs_cpu_features()
+              << " kernels: " << rs_select_kernels(~0U) << std::dec << std::endl;
+}
+
+void region_check(size_t size, const RSField* field, cppecc_s32 count)
+{
+    std::vector<cppecc_u8> source(size);
+    std::vector<cppecc_u8> destination(size);
+    std::vector<cppecc_u8> expected(size);
+
+    std::mt19937 engine(static_cast<cppecc_u32>(size)+field->polynomial_);
+    for_each_kernels([&](cppecc_u32 selected) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            // Unaligned offsets and lengths, so that tails of all kernels run
+            size_t offset = engine()%64;
+            size_t length = size - offset - engine()%64;
+            cppecc_u8 coefficient = static_cast<cppecc_u8>(engine()&0xFFU);
+            for(size_t j = 0; j < size; ++j){
+                source[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+                destination[j] = expected[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+            }
+            for(size_t j = offset; j < (offset+length); ++j){
+                expected[j] ^= gf_field_mul(field, coefficient, source[j]);
+            }
+            gf_mul_add_region(field, coefficient, length, &source[offset], &destination[offset]);
+            if(destination != expected){
+                std::cout << "region mismatch kernels: " << selected << ", size: " << size << std::endl;
+                assert(false);
+            }
+        }
+    });
+    std::cout << "region: size: " << size << " polynomial: " << std::hex << field->polynomial_ << std::dec << " ok" << std::endl;
+}
+
+void segment_check(cppecc_s32 messageSize, cppecc_s32 eccSize, const RSField* field, cppecc_s32 count)
+{
+    static const cppecc_s32 MaxSegments = 6;
+    const cppecc_s32 total = messageSize+eccSize;
+    const cppecc_s32 maxErrors = eccSize>>1;
+    std::vector<cppecc_u8> message(total);
+    std::vector<cppecc_u8> expected(total);
+    std::vector<cppecc_u8> scattered(total);
+    std::vector<cppecc_u8> parity(eccSize);
+    std::vector<cppecc_u8> positions(total);
+    RSSegment segments[MaxSegments];
+
+    RSContext* context = rs_context_alloc(eccSize, field);
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for_each_kernels([&](cppecc_u32 selected) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            for(cppecc_s32 j=0; j<messageSize; ++j){
+                message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+            }
+            rs_encode_scalar(context, messageSize, &message[0], eccSize);
+
+            // Segments of random lengths in separate buffers, some of them are empty
+            cppecc_s32 numSegments = 1 + static_cast<cppecc_s32>(engine()%MaxSegments);
+            cppecc_s32 offset = 0;
+            for(cppecc_s32 j = 0; j < numSegments; ++j) {
+                cppecc_s32 length = (j == (numSegments-1))? messageSize-offset : static_cast<cppecc_s32>(engine()%(messageSize-offset+1));
+                std::copy(message.begin()+offset, message.begin()+offset+length, scattered.begin()+offset);
+                segments[j].base_ = &scattered[offset];
+                segments[j].length_ = static_cast<cppecc_size_t>(length);
+                offset += length;
+            }
+            rs_encode_parity(context, segments, numSegments, &parity[0], eccSize);
+            if(!std::equal(parity.begin(), parity.end(), message.begin()+messageSize)){
+                std::cout << "segment encode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << ", segments: " << numSegments << std::endl;
+                assert(false);
+            }
+
+            // The streaming encoder takes the same message in pieces of a few bytes
+            RSEncoder encoder;
+            rs_encoder_init(&encoder, context, eccSize);
+            for(cppecc_s32 j = 0; j < messageSize;) {
+                cppecc_s32 length = std::min(static_cast<cppecc_s32>(engine()%24), messageSize-j);
+                rs_encoder_update(&encoder, &message[j], static_cast<cppecc_size_t>(length));
+                j += length;
+            }
+            rs_encoder_final(&encoder, &parity[0]);
+            if(!std::equal(parity.begin(), parity.end(), message.begin()+messageSize)){
+                std::cout << "stream encode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+
+            // From no errors to one more than the capability, in the segments and the redundant symbols
+            std::copy(parity.begin(), parity.end(), scattered.begin()+messageSize);
+            for(cppecc_s32 j=0; j<total; ++j){
+                positions[j] = static_cast<cppecc_u8>(j);
+            }
+            std::shuffle(positions.begin(), positions.end(), engine);
+            cppecc_s32 numErrors = std::min(i%(maxErrors+2), total);
+            for(cppecc_s32 j=0; j<numErrors; ++j){
+                scattered[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+            }
+            std::copy(scattered.begin()+messageSize, scattered.end(), parity.begin());
+            expected = scattered;
+            cppecc_s32 reference = rs_decode(context, messageSize, &expected[0], eccSize);
+
+            // The streaming decoder takes the received codeword in pieces, which can cross the end of the message
+            RSDecoder decoder;
+            rs_decoder_init(&decoder, context, messageSize, eccSize);
+            for(cppecc_s32 j = 0; j < total;) {
+                cppecc_s32 length = std::min(static_cast<cppecc_s32>(engine()%24), total-j);
+                rs_decoder_update(&decoder, &scattered[j], static_cast<cppecc_size_t>(length));
+                j += length;
+            }
+            cppecc_u8 errorPositions[CPPECC_GF_NW/2];
+            cppecc_u8 errorValues[CPPECC_GF_NW/2];
+            cppecc_s32 found = rs_decoder_final(&decoder, errorPositions, errorValues);
+            if(found != reference){
+                std::cout << "stream decode mismatch kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                assert(false);
+            }
+            if(0 <= found){
+                std::vector<cppecc_u8> streamed(scattered);
+                for(cppecc_s32 j = 0; j < found; ++j){
+                    streamed[errorPositions[j]] ^= errorValues[j];
+                }
+                if(streamed != expected){
+                    std::cout << "stream decode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                    assert(false);
+                }
+            }
+
+            cppecc_s32 corrected = rs_decode_parity(context, segments, numSegments, &parity[0], eccSize);
+            std::copy(parity.begin(), parity.end(), scattered.begin()+messageSize);
+            if(corrected != reference || (0 <= corrected && scattered != expected)){
+                std::cout << "segment decode mismatch kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << ", segments: " << numSegments << std::endl;
+                assert(false);
+            }
+            if(numErrors <= maxErrors && !std::equal(message.begin(), message.end(), scattered.begin())){
+                std::cout << "segment decode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numErrors << std::endl;
+                assert(false);
+            }
+        }
+    });
+    rs_context_free(context);
+    std::cout << "segments: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+}
+
+void delta_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u8> message(total);
+    std::vector<cppecc_u8> updated(total);
+    std::vector<cppecc_u8> parity(eccSize);
+    std::vector<cppecc_u8> chunkParity(eccSize);
+    std::vector<cppecc_s32> offsets;
+
+    RSContext* context = rs_context_alloc(eccSize, gf_default_field());
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for_each_kernels([&](cppecc_u32 selected) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            for(cppecc_s32 j=0; j<messageSize; ++j){
+                message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+            }
+            rs_encode(context, messageSize, &message[0], eccSize);
+
+            // Short ranges are updated by rows, long ones are encoded and shifted
+            cppecc_s32 length = (i&1)? static_cast<cppecc_s32>(engine()%4)+1 : static_cast<cppecc_s32>(engine()%(messageSize+1));
+            length = std::min(length, messageSize);
+            cppecc_s32 offset = static_cast<cppecc_s32>(engine()%(messageSize-length+1));
+            updated = message;
+            for(cppecc_s32 j=0; j<length; ++j){
+                updated[offset+j] = static_cast<cppecc_u8>(engine()&0xFFU);
+            }
+            std::copy(message.begin()+messageSize, message.end(), parity.begin());
+            rs_update_parity(context, messageSize, offset, &message[offset], &updated[offset], length, &parity[0], eccSize);
+            rs_encode(context, messageSize, &updated[0], eccSize);
+            if(!std::equal(parity.begin(), parity.end(), updated.begin()+messageSize)){
+                std::cout << "delta update error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << ", offset: " << offset << ", length: " << length << std::endl;
+                assert(false);
+            }
+
+            // Chunks are encoded in a shuffled order and combined
+            offsets.clear();
+            offsets.push_back(0);
+            while(offsets.back() < messageSize){
+                offsets.push_back(std::min(offsets.back()+1+static_cast<cppecc_s32>(engine()%64), messageSize));
+            }
+            std::vector<cppecc_s32> order(offsets.size()-1);
+            for(size_t j = 0; j < order.size(); ++j){
+                order[j] = static_cast<cppecc_s32>(j);
+            }
+            std::shuffle(order.begin(), order.end(), engine);
+            std::fill(parity.begin(), parity.end(), 0);
+            for(size_t j = 0; j < order.size(); ++j){
+                cppecc_s32 begin = offsets[order[j]];
+                cppecc_s32 end = offsets[order[j]+1];
+                rs_encode_chunk(context, messageSize, begin, &updated[begin], end-begin, &chunkParity[0], eccSize);
+                rs_combine_parity(eccSize, &parity[0], &chunkParity[0]);
+            }
+            if(!std::equal(parity.begin(), parity.end(), updated.begin()+messageSize)){
+                std::cout << "chunk encode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << ", chunks: " << order.size() << std::endl;
+                assert(false);
+            }
+        }
+    });
+    rs_context_free(context);
+    std::cout << "delta: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+}
+
+void stripe_check(cppecc_s32 numData, cppecc_s32 numParity, cppecc_size_t chunkSize, cppecc_s32 count)
+{
+    const cppecc_s32 numChunks = numData+numParity;
+    std::vector<std::vector<cppecc_u8> > chunks(numChunks, std::vector<cppecc_u8>(chunkSize));
+    std::vector<std::vector<cppecc_u8> > reference(numChunks);
+    std::vector<cppecc_u8*> pointers(numChunks);
+    for(cppecc_s32 i = 0; i < numChunks; ++i) {
+        pointers[i] = chunks[i].empty()? CPPECC_NULL : &chunks[i][0];
+    }
+    std::vector<cppecc_u8> lost(numChunks);
+    std::vector<cppecc_u8> order(numChunks);
+    for(cppecc_s32 i = 0; i < numChunks; ++i) {
+        order[i] = static_cast<cppecc_u8>(i);
+    }
+
+    RSStripe* stripe = rs_stripe_alloc(numData, numParity, gf_default_field());
+    assert(CPPECC_NULL != stripe);
+    std::mt19937 engine(numData*CPPECC_GF_NW+numParity);
+    for(cppecc_s32 i = 0; i < numData; ++i) {
+        for(cppecc_size_t j = 0; j < chunkSize; ++j) {
+            chunks[i][j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+    }
+
+    // Parity of the Cauchy matrix by products of bytes
+    for(cppecc_s32 i = 0; i < numParity; ++i) {
+        std::vector<cppecc_u8>& parity = reference[numData+i];
+        parity.assign(chunkSize, 0);
+        for(cppecc_s32 j = 0; j < numData; ++j) {
+            cppecc_u8 coefficient = gf_div(1, static_cast<cppecc_u8>((numData+i)^j));
+            for(cppecc_size_t b = 0; b < chunkSize; ++b) {
+                parity[b] ^= gf_mul(coefficient, chunks[j][b]);
+            }
+        }
+    }
+    for(cppecc_s32 i = 0; i < numData; ++i) {
+        reference[i] = chunks[i];
+    }
+
+    for_each_kernels([&](cppecc_u32 selected) {
+        for(cppecc_s32 i = 0; i < count; ++i) {
+            rs_stripe_encode(stripe, chunkSize, &pointers[0], &pointers[numData]);
+            if(chunks != reference){
+                std::cout << "stripe encode error kernels: " << selected << ", data: " << numData << ", parity: " << numParity << std::endl;
+                assert(false);
+            }
+
+            // A few loss patterns repeat, so decode matrices are found in the cache
+            std::mt19937 patterns(i%(CPPECC_STRIPE_CACHE_SIZE+3));
+            std::shuffle(order.begin(), order.end(), patterns);
+            cppecc_s32 numLost = (0 == numParity)? 0 : static_cast<cppecc_s32>(patterns()%numParity)+1;
+            for(cppecc_s32 j = 0; j < numLost; ++j) {
+                lost[j] = order[j];
+                std::fill(chunks[lost[j]].begin(), chunks[lost[j]].end(), static_cast<cppecc_u8>(engine()));
+            }
+            cppecc_s32 result = rs_stripe_rebuild(stripe, chunkSize, &pointers[0], &lost[0], numLost);
+            if(0 != result || chunks != reference){
+                std::cout << "stripe rebuild error kernels: " << selected << ", data: " << numData << ", parity: " << numParity << ", lost: " << numLost << std::endl;
+                assert(false);
+            }
+        }
+        if(numParity < numChunks && CPPECC_ERROR != rs_stripe_rebuild(stripe, chunkSize, &pointers[0], &order[0], numParity+1)){
+            std::cout << "stripe rebuilt too many losses, data: " << numData << ", parity: " << numParity << std::endl;
+            assert(false);
+        }
+    });
+    rs_stripe_free(stripe);
+    std::cout << "stripe: data: " << numData << " parity: " << numParity << " chunk size: " << chunkSize << " ok" << std::endl;
+}
+
+#if defined(CPPECC_ENABLE_STATS)
+struct StatsErrors
+{
+    std::vector<cppecc_s32> positions_;
+    std::vector<cppecc_u8> magnitudes_;
+};
+
+void stats_callback(void* user, cppecc_s32 position, cppecc_u8 magnitude)
+{
+    StatsErrors* errors = static_cast<StatsErrors*>(user);
+    errors->positions_.push_back(position);
+    errors->magnitudes_.push_back(magnitude);
+}
+
+void stats_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    const cppecc_s32 maxErrors = eccSize>>1;
+    std::vector<cppecc_u8> message(total);
+    std::vector<cppecc_u8> decoded(total);
+    std::vector<cppecc_u8> positions(total);
+    std::vector<cppecc_u64> histogram(CPPECC_GF_NW/2+1);
+    cppecc_u64 uncorrectable = 0;
+    cppecc_u64 dirty = 0;
+
+    RSContext* context = rs_context_alloc(eccSize, gf_default_field());
+    StatsErrors errors;
+    rs_stats_set_callback(context->scratch_, stats_callback, &errors);
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_encode(context, messageSize, &message[0], eccSize);
+        for(cppecc_s32 j=0; j<total; ++j){
+            positions[j] = static_cast<cppecc_u8>(j);
+        }
+        std::shuffle(positions.begin(), positions.end(), engine);
+        cppecc_s32 numErrors = i%(maxErrors+2);
+        decoded = message;
+        for(cppecc_s32 j=0; j<numErrors; ++j){
+            decoded[positions[j]] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        std::vector<cppecc_u8> original = decoded;
+        errors.positions_.clear();
+        errors.magnitudes_.clear();
+        cppecc_s32 corrected = rs_decode(context, messageSize, &decoded[0], eccSize);
+        dirty += 0 < numErrors ? 1 : 0;
+        if(corrected < 0){
+            ++uncorrectable;
+        }else{
+            ++histogram[corrected];
+        }
+        // Callbacks tell every corrected symbol, and nothing else
+        bool valid = (corrected < 0) ? errors.positions_.empty() : (static_cast<cppecc_s32>(errors.positions_.size()) == corrected);
+        for(size_t j = 0; valid && j < errors.positions_.size(); ++j){
+            cppecc_s32 p = errors.positions_[j];
+            valid = (0 <= p && p < total && (original[p] ^ decoded[p]) == errors.magnitudes_[j]);
+        }
+        if(!valid || (numErrors <= maxErrors && decoded != message)){
+            std::cout << "stats callback error message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numErrors << std::endl;
+            assert(false);
+        }
+    }
+
+    RSStats stats;
+    rs_stats_snapshot(context->scratch_, &stats);
+    bool valid = stats.words_ == static_cast<cppecc_u64>(count) && stats.uncorrectable_ == uncorrectable
+        && stats.calls_[CPPECC_STAGE_SYNDROMES] == static_cast<cppecc_u64>(count) && stats.calls_[CPPECC_STAGE_LOCATOR] == dirty;
+    for(size_t i = 0; i < histogram.size(); ++i){
+        valid = valid && stats.corrected_[i] == histogram[i];
+    }
+    RSStats sum = {};
+    rs_stats_merge(&sum, &stats);
+    rs_stats_merge(&sum, &stats);
+    valid = valid && sum.words_ == 2*stats.words_ && sum.cycles_[CPPECC_STAGE_CHIEN] == 2*stats.cycles_[CPPECC_STAGE_CHIEN];
+    if(!valid){
+        std::cout << "stats counter error message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    char json[1024];
+    cppecc_s32 length = rs_stats_json(&stats, json, sizeof(json));
+    char small[16];
+    if(length <= 0 || static_cast<size_t>(length) != strlen(json) || rs_stats_json(&stats, small, sizeof(small)) != length || strlen(small) != sizeof(small)-1){
+        std::cout << "stats json error" << std::endl;
+        assert(false);
+    }
+    std::cout << "stats: message size: " << messageSize << " ecc size: " << eccSize << " " << json << std::endl;
+    rs_stats_reset(context->scratch_);
+    rs_context_free(context);
+}
+#endif
+
+void gf16_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    static RS16Field field;
+    if(0 == field.polynomial_ && 0 != gf16_field_build(&field, CPPECC_GF16_PRIMITIVE)) {
+        std::cout << "gf16 field error" << std::endl;
+        assert(false);
+    }
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u16> message;
+    message.resize(total);
+    std::vector<cppecc_u16> encoded;
+    encoded.resize(total);
+    std::vector<cppecc_u16> decoded;
+    decoded.resize(total);
+
+    RS16Context context;
+    gf16_initialize(&context, eccSize, &field);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        for(cppecc_s32 j=0; j<messageSize; ++j){
+            message[j] = static_cast<cppecc_u16>(engine()&0xFFFFU);
+        }
+        encoded = message;
+        rs16_encode_scalar(&context, messageSize, &encoded[0], eccSize);
+        rs16_encode(&context, messageSize, &message[0], eccSize);
+        if(encoded != message){
+            std::cout << "gf16 encode error message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+        if(0 == (i&15)){
+            // The rows follow the same kernels as rs_select_kernels binds
+            for_each_kernels([&](cppecc_u32 selected) {
+                decoded = encoded;
+                rs16_encode(&context, messageSize, &decoded[0], eccSize);
+                if(encoded != decoded){
+                    std::cout << "gf16 kernels encode error kernels: " << selected << ", message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+                    assert(false);
+                }
+            });
+        }
+
+        // Up to the capability, and one of every 8 exceeds it
+        cppecc_s32 numErrors = static_cast<cppecc_s32>(engine()%((eccSize>>1)+1));
+        if(7 == (i&7)){
+            numErrors = (eccSize>>1)+1;
+        }
+        decoded = message;
+        for(cppecc_s32 j=0; j<numErrors; ++j){
+            decoded[engine()%total] ^= static_cast<cppecc_u16>(engine()|1U);
+        }
+        cppecc_s32 numCorrupted = 0;
+        for(cppecc_s32 j=0; j<total; ++j){
+            numCorrupted += (decoded[j] != message[j])? 1 : 0;
+        }
+        cppecc_s32 corrected = rs16_decode(&context, messageSize, &decoded[0], eccSize);
+        if(numCorrupted <= (eccSize>>1) && (corrected != numCorrupted || decoded != message)){
+            std::cout << "gf16 decode error message size: " << messageSize << ", ecc size: " << eccSize << ", errors: " << numCorrupted << std::endl;
+            assert(false);
+        }
+    }
+    std::cout << "gf16: message size: " << messageSize << " ecc size: " << eccSize << " ok" << std::endl;
+    gf16_terminate(&context);
+}
+
+void buffer_check(cppecc_size_t size, cppecc_s32 blockSize, cppecc_s32 eccSize, cppecc_s32 layout)
+{
+    std::vector<cppecc_u8> data;
+    data.resize(size);
+    std::vector<cppecc_u8> encoded;
+    encoded.resize(rs_buffer_encoded_size(size, blockSize, eccSize, layout));
+    const cppecc_size_t numBlocks = rs_buffer_blocks(size, blockSize);
+    std::vector<cppecc_s32> status;
+    status.resize(numBlocks);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+
+    std::mt19937 engine(static_cast<cppecc_u32>(size)*CPPECC_GF_NW+eccSize);
+    for(cppecc_size_t i=0; i<size; ++i){
+        data[i] = static_cast<cppecc_u8>(engine()&0xFFU);
+    }
+    rs_encode_buffer(&context, size, &data[0], &encoded[0], blockSize, eccSize, layout);
+
+    // Corrupt every 64th block up to the capability, and the last block beyond it
+    const bool separate = CPPECC_LAYOUT_SEPARATE == layout;
+    std::vector<cppecc_u8> received = separate? data : encoded;
+    std::vector<cppecc_u8> parity = separate? encoded : std::vector<cppecc_u8>();
+    const cppecc_s32 stride = separate? blockSize : blockSize+eccSize;
+    for(cppecc_size_t i = 0; i < numBlocks; i += 64) {
+        cppecc_s32 length = static_cast<cppecc_s32>(std::min<cppecc_size_t>(blockSize, size - i*blockSize));
+        cppecc_s32 numErrors = (numBlocks-1 == i)? eccSize : (eccSize>>1);
+        for(cppecc_s32 j=0; j<numErrors; ++j){
+            cppecc_u32 p = engine()%(length+eccSize);
+            if(separate && length<=static_cast<cppecc_s32>(p)){
+                parity[i*eccSize + p-length] ^= static_cast<cppecc_u8>(engine()|1U);
+            }else{
+                received[i*stride + p] ^= static_cast<cppecc_u8>(engine()|1U);
+            }
+        }
+    }
+
+    cppecc_s32 result = rs_decode_buffer(&context, size, &received[0], separate? &parity[0] : CPPECC_NULL, blockSize, eccSize, layout, &status[0]);
+
+    cppecc_s32 numFailed = 0;
+    for(cppecc_size_t i = 0; i < numBlocks; ++i) {
+        cppecc_s32 length = static_cast<cppecc_s32>(std::min<cppecc_size_t>(blockSize, size - i*blockSize));
+        bool dirty = (0 == (i&63));
+        bool beyond = dirty && (numBlocks-1 == i) && 1<eccSize;
+        if(status[i]<0){
+            ++numFailed;
+        }
+        if(beyond){
+            continue;
+        }
+        if((dirty? status[i]<0 : 0 != status[i]) || 0 != memcmp(&received[i*stride], &data[i*blockSize], length)){
+            std::cout << "buffer decode error size: " << size << ", block size: " << blockSize << ", ecc size: " << eccSize << ", block: " << i << std::endl;
+            assert(false);
+        }
+    }
+    if((0 < numFailed) != (result < 0)){
+        std::cout << "buffer status error size: " << size << ", block size: " << blockSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    std::cout << "buffer: size: " << size << " block size: " << blockSize << " ecc size: " << eccSize << " layout: " << layout << " blocks: " << numBlocks << " failed: " << numFailed << std::endl;
+    gf_terminate(&context);
+}
+
+void engine_check(cppecc_size_t size, cppecc_s32 blockSize, cppecc_s32 eccSize, cppecc_s32 layout, cppecc_s32 numThreads, cppecc_s32 chunkBlocks)
+{
+    std::vector<cppecc_u8> data;
+    data.resize(size);
+    std::vector<cppecc_u8> expected;
+    expected.resize(rs_buffer_encoded_size(size, blockSize, eccSize, layout));
+    std::vector<cppecc_u8> encoded;
+    encoded.resize(expected.size());
+    const cppecc_size_t numBlocks = rs_buffer_blocks(size, blockSize);
+    std::vector<cppecc_s32> expectedStatus;
+    expectedStatus.resize(numBlocks);
+    std::vector<cppecc_s32> status;
+    status.resize(numBlocks);
+
+    RSContext context;
+    gf_initialize(&context, eccSize);
+    RSEngine engine(&context, numThreads, chunkBlocks);
+
+    std::mt19937 engine32(static_cast<cppecc_u32>(size)*CPPECC_GF_NW+eccSize);
+    for(cppecc_size_t i=0; i<size; ++i){
+        data[i] = static_cast<cppecc_u8>(engine32()&0xFFU);
+    }
+    rs_encode_buffer(&context, size, &data[0], &expected[0], blockSize, eccSize, layout);
+    engine.encode(size, &data[0], &encoded[0], blockSize, eccSize, layout);
+    if(encoded != expected){
+        std::cout << "engine encode error size: " << size << ", threads: " << numThreads << std::endl;
+        assert(false);
+    }
+
+    // Corrupt some blocks, the engine should agree with the serial functions
+    const bool separate = CPPECC_LAYOUT_SEPARATE == layout;
+    std::vector<cppecc_u8> received = separate? data : encoded;
+    std::vector<cppecc_u8> parity = separate? encoded : std::vector<cppecc_u8>(1);
+    for(cppecc_s32 i=0; i<static_cast<cppecc_s32>(numBlocks); ++i){
+        if(0 == engine32()%8){
+            received[engine32()%received.size()] ^= static_cast<cppecc_u8>(engine32()|1U);
+        }
+    }
+    std::vector<cppecc_u8> serial = received;
+    std::vector<cppecc_u8> serialParity = parity;
+    cppecc_s32 numDirty = rs_check_buffer(&context, size, &serial[0], &serialParity[0], blockSize, eccSize, layout, &expectedStatus[0]);
+    if(numDirty != engine.check(size, &received[0], &parity[0], blockSize, eccSize, layout, &status[0]) || status != expectedStatus){
+        std::cout << "engine check error size: " << size << ", threads: " << numThreads << std::endl;
+        assert(false);
+    }
+    cppecc_s32 corrected = rs_decode_buffer(&context, size, &serial[0], &serialParity[0], blockSize, eccSize, layout, &expectedStatus[0]);
+    if(corrected != engine.decode(size, &received[0], &parity[0], blockSize, eccSize, layout, &status[0]) || status != expectedStatus || received != serial || parity != serialParity){
+        std::cout << "engine decode error size: " << size << ", threads: " << numThreads << std::endl;
+        assert(false);
+    }
+
+    // Calls from other threads take turns on the same workers
+    std::vector<cppecc_u8> concurrent[2];
+    std::thread callers[2];
+    for(cppecc_s32 i=0; i<2; ++i){
+        concurrent[i].resize(expected.size());
+        callers[i] = std::thread([&, i]() { engine.encode(size, &data[0], &concurrent[i][0], blockSize, eccSize, layout); });
+    }
+    for(cppecc_s32 i=0; i<2; ++i){
+        callers[i].join();
+        if(concurrent[i] != expected){
+            std::cout << "engine concurrent encode error size: " << size << ", threads: " << numThreads << std::endl;
+            assert(false);
+        }
+    }
+
+    std::cout << "engine: size: " << size << " block size: " << blockSize << " ecc size: " << eccSize << " layout: " << layout << " threads: " << engine.num_threads() << " chunk: " << chunkBlocks << " ok" << std::endl;
+    gf_terminate(&context);
+}
+
+void context_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+    std::vector<cppecc_u8> message;
+    message.resize(total*count);
+    std::vector<cppecc_u8> reference;
+    reference.resize(total*count);
+
+    static_assert(!std::is_copy_constructible<RSContext>::value && !std::is_copy_assignable<RSContext>::value, "copies of contexts would share tables");
+
+    // One context in an arena of the exact size, another one from the heap
+    std::vector<cppecc_u64> arena;
+    arena.resize((rs_context_size(eccSize)+sizeof(cppecc_u64)-1)/sizeof(cppecc_u64));
+    if(CPPECC_NULL != rs_context_create(&arena[0], rs_context_size(eccSize)-1, eccSize, gf_default_field())
+       || CPPECC_NULL != rs_context_create(&arena[0], sizeof(RSContext)-1, eccSize, gf_default_field())){
+        std::cout << "context accepted a short arena, ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    RSContext* context = rs_context_create(&arena[0], arena.size()*sizeof(cppecc_u64), eccSize, gf_default_field());
+    RSContext* heap = rs_context_alloc(eccSize, gf_default_field());
+    assert(CPPECC_NULL != context && CPPECC_NULL != heap);
+
+    std::mt19937 engine(messageSize*CPPECC_GF_NW+eccSize);
+    for(size_t i=0; i<message.size(); ++i){
+        message[i] = static_cast<cppecc_u8>(engine()&0xFFU);
+    }
+    std::copy(message.begin(), message.end(), reference.begin());
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode_scalar(heap, messageSize, &reference[total*i], eccSize);
+    }
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode(context, messageSize, &message[total*i], eccSize);
+    }
+    if(message != reference){
+        std::cout << "context encode mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+
+    // A context made while the portable kernels are bound has no tables of GFNI, the kernels bound later fall back
+    cppecc_u32 features = rs_selected_kernels();
+    rs_select_kernels(0);
+    RSContext* portable = rs_context_alloc(eccSize, gf_default_field());
+    assert(CPPECC_NULL != portable);
+    rs_select_kernels(features);
+    std::vector<cppecc_u8> codeword(reference.begin(), reference.begin()+total);
+    std::fill(codeword.begin()+messageSize, codeword.end(), 0);
+    rs_encode(portable, messageSize, &codeword[0], eccSize);
+    if(!std::equal(codeword.begin(), codeword.end(), reference.begin()) || 0 != rs_check(portable, messageSize, &codeword[0], eccSize)){
+        std::cout << "context of portable kernels mismatch message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    rs_context_free(portable);
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* codeword = &message[total*i];
+        cppecc_s32 numErrors = static_cast<cppecc_s32>(engine()%(eccSize/2+1));
+        for(cppecc_s32 j = 0; j < numErrors; ++j) {
+            codeword[(i+j*7)%total] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        if((0 != rs_check(context, messageSize, codeword, eccSize)) != (0 < numErrors)){
+            std::cout << "context check error message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+        cppecc_s32 corrected = rs_decode(0 == (i&1)? context : heap, messageSize, codeword, eccSize);
+        if(corrected != numErrors || !std::equal(codeword, codeword+total, &reference[total*i])){
+            std::cout << "context decode error message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+            assert(false);
+        }
+    }
+    rs_context_free(heap);
+    std::cout << "context: message size: " << messageSize << " ecc size: " << eccSize << " bytes: " << rs_context_size(eccSize) << " ok" << std::endl;
+}
+
+void code_check(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 numThreads, cppecc_s32 count)
+{
+    const cppecc_s32 total = messageSize+eccSize;
+
+    // The first acquisition builds the tables, the others find them in the registry
+    const RSCode* code = rs_code_acquire(eccSize, gf_default_field());
+    const RSCode* again = rs_code_acquire(eccSize, gf_default_field());
+    const RSCode* other = rs_code_acquire(eccSize, &RSFieldParams<0x187U, 112, 11>::field);
+    if(CPPECC_NULL == code || code != again || CPPECC_NULL == other || code == other){
+        std::cout << "code registry error ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    rs_code_release(again);
+    rs_code_release(other);
+
+    std::atomic<cppecc_s32> numFailed(0);
+    std::atomic<cppecc_s32> numDone(0);
+    std::vector<std::thread> threads;
+    for(cppecc_s32 t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            const RSCode* shared = rs_code_acquire(eccSize, gf_default_field());
+            RSWorkspace workspace;
+            rs_workspace_init(&workspace, shared);
+            // rs_encode_scalar writes the scratch of its context, so each thread has its own reference
+            RSContext* reference = rs_context_alloc(eccSize, gf_default_field());
+            std::mt19937 random(t*CPPECC_GF_NW+eccSize);
+            std::vector<cppecc_u8> codeword(total);
+            std::vector<cppecc_u8> expected(total);
+            for(cppecc_s32 i = 0; i < count; ++i) {
+                for(cppecc_s32 j = 0; j < messageSize; ++j) {
+                    codeword[j] = expected[j] = static_cast<cppecc_u8>(random()&0xFFU);
+                }
+                rs_workspace_encode(&workspace, messageSize, &codeword[0]);
+                rs_encode_scalar(reference, messageSize, &expected[0], eccSize);
+                cppecc_s32 numErrors = static_cast<cppecc_s32>(random()%(eccSize/2+1));
+                for(cppecc_s32 j = 0; j < numErrors; ++j) {
+                    codeword[(i+j*7)%total] ^= static_cast<cppecc_u8>(random()|1U);
+                }
+                if(numErrors != rs_workspace_decode(&workspace, messageSize, &codeword[0]) || codeword != expected){
+                    numFailed.fetch_add(1);
+                }
+            }
+            rs_context_free(reference);
+            rs_code_release(shared);
+            numDone.fetch_add(1);
+        }));
+    }
+    // Kernels are bound again while the workers encode and decode
+    for(cppecc_s32 f = 0; numDone.load() < numThreads; f = (f + 1) % NumKernelSets) {
+        rs_select_kernels(KernelSets[f]);
+        std::this_thread::yield();
+    }
+    rs_select_kernels(~0U);
+    for(size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    if(0 != numFailed.load()){
+        std::cout << "code decode error message size: " << messageSize << ", ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+
+    // Acquired codes are kept, released ones are freed
+    rs_code_release(code);
+    if(rs_code_purge() < 2 || 0 != rs_code_purge()){
+        std::cout << "code purge error ecc size: " << eccSize << std::endl;
+        assert(false);
+    }
+    std::cout << "code: message size: " << messageSize << " ecc size: " << eccSize << " threads: " << numThreads << " ok" << std::endl;
+}
+
+template<cppecc_s32 N, cppecc_s32 K, class Params>
+void codec_check(cppecc_s32 count)
+{
+    typedef RSCodec<N, K, Params> Codec;
+    const cppecc_s32 eccSize = N-K;
+    std::unique_ptr<Codec> codec(new Codec);
+    RSContext* context = rs_context_alloc(eccSize, &Params::field);
+    for(cppecc_s32 i = 0; i <= eccSize; ++i) {
+        if(Codec::generator.coefficients_[i] != context->generator_[i]){
+            std::cout << "codec generator mismatch n: " << N << ", k: " << K << std::endl;
+            assert(false);
+        }
+    }
+
+    std::vector<cppecc_u8> message;
+    message.resize(N*count);
+    std::mt19937 engine(N*CPPECC_GF_NW+K);
+    for(size_t i=0; i<message.size(); ++i){
+        message[i] = static_cast<cppecc_u8>(engine()&0xFFU);
+    }
+    std::vector<cppecc_u8> reference = message;
+    std::vector<cppecc_u8> received;
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_encode(context, K, &reference[N*i], eccSize);
+    }
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        codec->encode(&message[N*i]);
+    }
+    if(message != reference){
+        std::cout << "codec encode mismatch n: " << N << ", k: " << K << std::endl;
+        assert(false);
+    }
+    // Long parity runs the nibble kernels, which follow the kernels bound when a codec is constructed
+    for_each_kernels([&](cppecc_u32 selected) {
+        std::unique_ptr<Codec> bound(new Codec);
+        cppecc_u8 parity[N - K];
+        bound->encode(&reference[0], parity);
+        if(!std::equal(parity, parity + eccSize, &reference[K])){
+            std::cout << "codec kernels mismatch n: " << N << ", k: " << K << ", kernels: " << selected << std::endl;
+            assert(false);
+        }
+    });
+
+    // Up to the capability, every codeword should be corrected the same as rs_decode
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* codeword = &message[N*i];
+        cppecc_s32 numErrors = static_cast<cppecc_s32>(engine()%(eccSize/2+1));
+        for(cppecc_s32 j = 0; j < numErrors; ++j) {
+            codeword[(i+j*7)%N] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        if((0 != codec->check(codeword)) != (0 < numErrors)){
+            std::cout << "codec check error n: " << N << ", k: " << K << std::endl;
+            assert(false);
+        }
+    }
+    received = message;
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        rs_decode(context, K, &received[N*i], eccSize);
+    }
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        if(codec->decode(&message[N*i]) < 0){
+            std::cout << "codec decode error n: " << N << ", k: " << K << std::endl;
+            assert(false);
+        }
+    }
+    if(message != reference || received != reference){
+        std::cout << "codec decode mismatch n: " << N << ", k: " << K << std::endl;
+        assert(false);
+    }
+
+    // Beyond the capability, the codec should fail or miscorrect the same as rs_decode
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_u8* codeword = &message[N*i];
+        for(cppecc_s32 j = 0; j <= eccSize/2; ++j) {
+            codeword[(i+j*7)%N] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+    }
+    received = message;
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        cppecc_s32 expected = rs_decode(context, K, &received[N*i], eccSize);
+        cppecc_s32 corrected = codec->decode(&message[N*i]);
+        if((expected < 0) != (corrected < 0) || (0 <= expected && !std::equal(&message[N*i], &message[N*(i+1)], &received[N*i]))){
+            std::cout << "codec uncorrectable mismatch n: " << N << ", k: " << K << std::endl;
+            assert(false);
+        }
+    }
+    rs_context_free(context);
+    std::cout << "codec: n: " << N << " k: " << K << " ok" << std::endl;
+}
+
+void profile_check(cppecc_s32 count)
+{
+    // Generators published by CCSDS 131.0-B (logs of alpha) and DVB EN 300 421, from the highest degree
+    static const cppecc_s32 CCSDSGenerator[33] = {0, 249, 59, 66, 4, 43, 126, 251, 97, 30, 3, 213, 50, 66, 170, 5, 24, 5, 170, 66, 50, 213, 3, 30, 97, 251, 126, 43, 4, 66, 59, 249, 0};
+    static const cppecc_u8 DVBGenerator[17] = {1, 59, 13, 104, 189, 68, 209, 30, 8, 163, 65, 41, 229, 98, 50, 36, 59};
+    // Columns of the transformation matrix T to the dual basis, T*(1<<k)
+    static const cppecc_u8 CCSDSDual[8] = {0x7BU, 0xAFU, 0x99U, 0xFAU, 0x86U, 0xECU, 0xEFU, 0x8DU};
+
+    const RSProfile* ccsds = rs_profile_ccsds(1);
+    const RSProfile* dvb = rs_profile_dvb();
+    RSContext ccsdsContext;
+    RSContext dvbContext;
+    rs_profile_initialize(&ccsdsContext, ccsds);
+    rs_profile_initialize(&dvbContext, dvb);
+    RSField alpha;
+    gf_field_build(&alpha, 0x187U, 0, 1);
+    for(cppecc_s32 i = 0; i <= 32; ++i) {
+        if(CCSDSGenerator[i] != alpha.log_[ccsdsContext.generator_[i]]){
+            std::cout << "ccsds generator mismatch" << std::endl;
+            assert(false);
+        }
+    }
+    for(cppecc_s32 i = 0; i <= 16; ++i) {
+        if(DVBGenerator[i] != dvbContext.generator_[i]){
+            std::cout << "dvb generator mismatch" << std::endl;
+            assert(false);
+        }
+    }
+    for(cppecc_u32 i = 0; i < CPPECC_GF_NW; ++i) {
+        cppecc_u8 x = static_cast<cppecc_u8>(i);
+        cppecc_u8 dual = 0;
+        for(cppecc_s32 k = 0; k < 8; ++k) {
+            dual ^= ((x >> k) & 1U) ? CCSDSDual[k] : 0;
+        }
+        cppecc_u8 converted;
+        cppecc_u8 back;
+        rs_convert_basis(ccsds->toDual_, 1, &x, &converted);
+        rs_convert_basis(ccsds->fromDual_, 1, &converted, &back);
+        if(dual != converted || x != back){
+            std::cout << "ccsds dual basis mismatch" << std::endl;
+            assert(false);
+        }
+    }
+    {
+        // Whole blocks go through the bound kernels, compare them with the bytes above
+        cppecc_u8 values[CPPECC_GF_NW];
+        cppecc_u8 converted[CPPECC_GF_NW];
+        for(cppecc_u32 i = 0; i < CPPECC_GF_NW; ++i) {
+            values[i] = static_cast<cppecc_u8>(i);
+        }
+        for_each_kernels([&](cppecc_u32 selected) {
+            rs_convert_basis(ccsds->toDual_, CPPECC_GF_NW - 3, values + 3, converted + 3);
+            for(cppecc_u32 i = 3; i < CPPECC_GF_NW; ++i) {
+                cppecc_u8 single;
+                rs_convert_basis(ccsds->toDual_, 1, &values[i], &single);
+                if(single != converted[i]){
+                    std::cout << "ccsds dual basis kernels mismatch kernels: " << selected << std::endl;
+                    assert(false);
+                }
+            }
+        });
+    }
+
+    std::unique_ptr<RSCodecCCSDS> ccsdsCodec(new RSCodecCCSDS);
+    std::unique_ptr<RSCodecDVB> dvbCodec(new RSCodecDVB);
+    std::mt19937 engine(count);
+    std::vector<cppecc_u8> codeword(255);
+    std::vector<cppecc_u8> reference(255);
+    std::vector<cppecc_u8> received(255);
+
+    // Codewords of the message which is zero except the last symbol is 1, their parity is the generator below the highest degree.
+    // CCSDS is alpha^CCSDSGenerator[1..32] in the dual basis, that is T*1 = 0x7B for the last message symbol, DVB is DVBGenerator[1..16].
+    static const cppecc_u8 CCSDSUnitParity[32] = {
+        0x47U, 0x32U, 0x5FU, 0x86U, 0x4AU, 0x18U, 0xA0U, 0x78U, 0x83U, 0xFAU, 0xB9U, 0x5CU, 0x5FU, 0x4FU, 0xECU, 0xFEU,
+        0xECU, 0x4FU, 0x5FU, 0x5CU, 0xB9U, 0xFAU, 0x83U, 0x78U, 0xA0U, 0x18U, 0x4AU, 0x86U, 0x5FU, 0x32U, 0x47U, 0x7BU};
+    static const cppecc_u8 DVBUnitParity[16] = {
+        0x3BU, 0x0DU, 0x68U, 0xBDU, 0x44U, 0xD1U, 0x1EU, 0x08U, 0xA3U, 0x41U, 0x29U, 0xE5U, 0x62U, 0x32U, 0x24U, 0x3BU};
+    {
+        std::vector<cppecc_u8> expected(255, 0);
+        expected[222] = 0x7BU;
+        std::copy(CCSDSUnitParity, CCSDSUnitParity+32, expected.begin()+223);
+        codeword.assign(expected.begin(), expected.begin()+223);
+        codeword.resize(255);
+        rs_profile_encode(&ccsdsContext, ccsds, &codeword[0]);
+        rs_convert_basis(ccsds->fromDual_, 255, &expected[0], &reference[0]);
+        received = reference;
+        std::fill(received.begin()+223, received.end(), static_cast<cppecc_u8>(0));
+        ccsdsCodec->encode(&received[0]);
+        if(codeword != expected || received != reference || 1 != reference[222]){
+            std::cout << "ccsds vector encode mismatch" << std::endl;
+            assert(false);
+        }
+        received = expected;
+        for(cppecc_s32 j = 0; j < 16; ++j) {
+            received[j*16] ^= static_cast<cppecc_u8>(0xA5U+j);
+        }
+        if(16 != rs_profile_decode(&ccsdsContext, ccsds, &received[0]) || received != expected){
+            std::cout << "ccsds vector decode mismatch" << std::endl;
+            assert(false);
+        }
+
+        expected.assign(204, 0);
+        expected[187] = 1;
+        std::copy(DVBUnitParity, DVBUnitParity+16, expected.begin()+188);
+        codeword.assign(expected.begin(), expected.begin()+188);
+        codeword.resize(204);
+        rs_profile_encode(&dvbContext, dvb, &codeword[0]);
+        received = expected;
+        std::fill(received.begin()+188, received.end(), static_cast<cppecc_u8>(0));
+        dvbCodec->encode(&received[0]);
+        if(codeword != expected || received != expected){
+            std::cout << "dvb vector encode mismatch" << std::endl;
+            assert(false);
+        }
+        for(cppecc_s32 j = 0; j < 8; ++j) {
+            received[j*25] ^= static_cast<cppecc_u8>(0x5AU+j);
+        }
+        if(8 != rs_profile_decode(&dvbContext, dvb, &received[0]) || received != expected){
+            std::cout << "dvb vector decode mismatch" << std::endl;
+            assert(false);
+        }
+        codeword.resize(255);
+        received.resize(255);
+    }
+
+    for(cppecc_s32 i = 0; i < count; ++i) {
+        // CCSDS in the dual basis, the conventional codeword should have zeros at beta^112, ..., beta^143
+        for(cppecc_s32 j = 0; j < 223; ++j) {
+            codeword[j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_profile_encode(&ccsdsContext, ccsds, &codeword[0]);
+        rs_convert_basis(ccsds->fromDual_, 255, &codeword[0], &reference[0]);
+        for(cppecc_s32 r = 112; r < 144; ++r) {
+            cppecc_u8 root = alpha.exp_[(11*r)%CPPECC_GF_NW1];
+            cppecc_u8 value = 0;
+            for(cppecc_s32 j = 0; j < 255; ++j) {
+                value = gf_field_mul(&alpha, value, root) ^ reference[j];
+            }
+            if(0 != value){
+                std::cout << "ccsds codeword error" << std::endl;
+                assert(false);
+            }
+        }
+        received = reference;
+        received[254] ^= 1U;
+        ccsdsCodec->encode(&received[0]);
+        if(received != reference){
+            std::cout << "ccsds codec mismatch" << std::endl;
+            assert(false);
+        }
+        received = codeword;
+        cppecc_s32 numErrors = static_cast<cppecc_s32>(engine()%17);
+        for(cppecc_s32 j = 0; j < numErrors; ++j) {
+            received[(i+j*13)%255] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        cppecc_s32 corrected = rs_profile_decode(&ccsdsContext, ccsds, &received[0]);
+        if(corrected != numErrors || received != codeword){
+            std::cout << "ccsds decode error, errors: " << numErrors << std::endl;
+            assert(false);
+        }
+
+        // DVB, the same redundant symbols as the mother code with 51 leading zeros
+        std::fill(reference.begin(), reference.begin()+51, static_cast<cppecc_u8>(0));
+        for(cppecc_s32 j = 0; j < 188; ++j) {
+            codeword[j] = reference[51+j] = static_cast<cppecc_u8>(engine()&0xFFU);
+        }
+        rs_profile_encode(&dvbContext, dvb, &codeword[0]);
+        rs_encode(&dvbContext, 239, &reference[0], 16);
+        received.assign(codeword.begin(), codeword.begin()+204);
+        dvbCodec->encode(&received[0]);
+        if(!std::equal(codeword.begin(), codeword.begin()+204, reference.begin()+51) || !std::equal(received.begin(), received.end(), codeword.begin())){
+            std::cout << "dvb encode mismatch" << std::endl;
+            assert(false);
+        }
+        numErrors = static_cast<cppecc_s32>(engine()%9);
+        for(cppecc_s32 j = 0; j < numErrors; ++j) {
+            received[(i+j*13)%204] ^= static_cast<cppecc_u8>(engine()|1U);
+        }
+        corrected = rs_profile_decode(&dvbContext, dvb, &received[0]);
+        if(corrected != numErrors || !std::equal(received.begin(), received.end(), codeword.begin())){
+            std::cout << "dvb decode error, errors: " << numErrors << std::endl;
+            assert(false);
+        }
+    }
+    std::cout << "profile: ccsds and dvb ok" << std::endl;
+    gf_terminate(&ccsdsContext);
+    gf_terminate(&dvbContext);
+}
+
 Result reed_solomon(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 maxErrors, cppecc_s32 count)
 {
     const cppecc_s32 MaxECC = eccSize>>1;
@@ -73,20 +1655,12 @@ Result reed_solomon(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 maxEr
     std::uniform_int_distribution<> randErrors(0, maxErrors);
     std::uniform_int_distribution<> randPositions(0, messageSize+eccSize-1);
 
-    long long encodeTime = 0;
-    long long decodeTime = 0;
-    std::chrono::high_resolution_clock::time_point start;
-    std::chrono::high_resolution_clock::time_point end;
     for(cppecc_s32 i = 0; i < count; ++i) {
         for(cppecc_s32 j=0; j<messageSize; ++j){
             message[j] = static_cast<cppecc_u8>(engine()&0xFFU);
         }
         std::copy(message.begin(), message.end(), encoded.begin());
-
-        start = std::chrono::high_resolution_clock::now();
         rs_encode(&context, messageSize, &encoded[0], eccSize);
-        end = std::chrono::high_resolution_clock::now();
-        encodeTime += std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
 
         std::copy(encoded.begin(), encoded.end(), decoded.begin());
 
@@ -103,11 +1677,7 @@ Result reed_solomon(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 maxEr
             encoded[j] ^= decoded[j];
         }
 
-        start = std::chrono::high_resolution_clock::now();
         cppecc_s32 corrected = rs_decode(&context, messageSize, &decoded[0], eccSize);
-        end = std::chrono::high_resolution_clock::now();
-        decodeTime += std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
-
         if(numErrors<=MaxECC){
             if(corrected<0){
                 result.numErrors_ += 1;
@@ -132,9 +1702,8 @@ Result reed_solomon(cppecc_s32 messageSize, cppecc_s32 eccSize, cppecc_s32 maxEr
         }
     }
 
-    result.encodeTime_ = encodeTime / count;
-    result.decodeTime_ = decodeTime / count;
     result.avgErrors_ /= count;
+    gf_terminate(&context);
     return result;
 }
 
@@ -148,6 +1717,154 @@ int main(void)
     std::mt19937 engine(seed());
     std::uniform_int_distribution<> messageSizeRange(MinMessageSize, CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE);
 
+    field_check<RSFieldParams<> >(0x11DU, 0, 1, Count/16);
+    field_check<RSFieldParams<0x187U, 112, 11> >(0x187U, 112, 11, Count/16);
+    field_check<RSFieldParams<0x11DU, 1, 1> >(0x11DU, 1, 1, Count/16);
+    field_check<RSFieldParams<0x12BU, 120, 7> >(0x12BU, 120, 7, Count/16);
+
+    encode_check(223, 32, Count);
+    encode_check(188, 16, Count);
+    encode_check(239, 16, Count);
+    encode_check(128, 8, Count);
+    encode_check(203, CPPECC_MAX_ECC_SIZE, Count);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; ++i) {
+        encode_check(CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE, i, Count/16);
+    }
+
+    syndrome_check(223, 32, Count);
+    syndrome_check(188, 16, Count);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; ++i) {
+        syndrome_check(CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE, i, Count/16);
+    }
+
+    slicing_check(223, 32, Count);
+    slicing_check(188, 16, Count);
+    slicing_check(203, CPPECC_MAX_ECC_SIZE, Count);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; ++i) {
+        slicing_check(CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE-(i&7), i, Count/16);
+    }
+
+    remainder_check(223, 32, Count);
+    remainder_check(188, 16, Count);
+    remainder_check(254, 1, Count);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; ++i) {
+        remainder_check(CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE-(i&7), i, Count/16);
+    }
+
+    batch_check(223, 32, Count);
+    batch_check(188, 16, Count);
+    batch_check(203, CPPECC_MAX_ECC_SIZE, Count);
+    batch_check(128, 8, Count+7);
+    batch_check(16, 1, 5);
+
+    erasure_check(223, 32, Count);
+    erasure_check(188, 16, Count);
+    erasure_check(6, 4, Count);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; ++i) {
+        erasure_check(CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE-(i&7), i, Count/16);
+    }
+
+    dispatch_check(223, 32, Count);
+    dispatch_check(188, 16, Count);
+    dispatch_check(239, 16, Count);
+    dispatch_check(127, 128, Count/16);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; i += 5) {
+        dispatch_check(CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE-(i&7), i, Count/64);
+    }
+
+    region_check(1024*1024, gf_default_field(), 16);
+    region_check(4096, &RSFieldParams<0x187U, 112, 11>::field, Count/16);
+    region_check(200, gf_default_field(), Count);
+
+    segment_check(223, 32, gf_default_field(), Count);
+    segment_check(188, 16, gf_default_field(), Count);
+    segment_check(223, 32, &RSFieldParams<0x187U, 112, 11>::field, Count/4);
+    segment_check(127, 128, gf_default_field(), Count/16);
+    for(cppecc_s32 i = 1; i < CPPECC_MAX_BODY_SIZE; i += 11) {
+        segment_check(CPPECC_MAX_BODY_SIZE-i, i, gf_default_field(), Count/64);
+    }
+
+    delta_check(223, 32, Count);
+    delta_check(188, 16, Count);
+    delta_check(127, 128, Count/16);
+    for(cppecc_s32 i = 1; i < CPPECC_MAX_BODY_SIZE; i += 11) {
+        delta_check(CPPECC_MAX_BODY_SIZE-i, i, Count/64);
+    }
+
+    stripe_check(10, 4, 4096, Count/16);
+    stripe_check(4, 2, 1000, Count/16);
+    stripe_check(1, 1, 64, Count/16);
+    stripe_check(17, 0, 333, 4);
+    stripe_check(128, 128, 100, 4);
+    stripe_check(200, 56, 4100, 4);
+
+    chien_check(223, 32, Count);
+    chien_check(188, 16, Count);
+    chien_check(127, 128, Count/16);
+    for(cppecc_s32 i = 1; i < CPPECC_MAX_BODY_SIZE; i += 11) {
+        chien_check(CPPECC_MAX_BODY_SIZE-i, i, Count/64);
+    }
+
+#if defined(CPPECC_ENABLE_STATS)
+    stats_check(223, 32, Count);
+    stats_check(188, 16, Count);
+    stats_check(251, 4, Count);
+#endif
+
+    constant_check(223, 32, gf_default_field(), Count);
+    constant_check(188, 16, gf_default_field(), Count);
+    constant_check(223, 32, &RSFieldParams<0x187U, 112, 11>::field, Count/4);
+    constant_check(127, 128, gf_default_field(), Count/16);
+    for(cppecc_s32 i = 1; i < CPPECC_MAX_BODY_SIZE; i += 11) {
+        constant_check(CPPECC_MAX_BODY_SIZE-i, i, gf_default_field(), Count/64);
+    }
+
+    gf16_check(2048, 32, Count/16);
+    gf16_check(8192, 64, Count/64);
+    gf16_check(65535-CPPECC_MAX_ECC16_SIZE, CPPECC_MAX_ECC16_SIZE, Count/256);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC16_SIZE; ++i) {
+        gf16_check(1024-(i&7), i, Count/256);
+    }
+
+    buffer_check(64*1024*1024, 223, 32, CPPECC_LAYOUT_CODEWORDS);
+    buffer_check(64*1024*1024, 223, 32, CPPECC_LAYOUT_SEPARATE);
+    for(cppecc_s32 i = 1; i <= CPPECC_MAX_ECC_SIZE; ++i) {
+        buffer_check(100000+i, CPPECC_GF_NW1-CPPECC_MAX_ECC_SIZE-(i&7), i, i&1);
+    }
+    buffer_check(1, 16, 8, CPPECC_LAYOUT_CODEWORDS);
+
+    for(cppecc_s32 i = 1; i <= 8; i <<= 1) {
+        engine_check(64*1024*1024, 223, 32, CPPECC_LAYOUT_CODEWORDS, i, 256);
+    }
+    engine_check(64*1024*1024, 223, 32, CPPECC_LAYOUT_SEPARATE, 0, 256);
+    engine_check(1000003, 239, 16, CPPECC_LAYOUT_CODEWORDS, 3, 7);
+    engine_check(1000003, 239, 16, CPPECC_LAYOUT_SEPARATE, 5, 1);
+    engine_check(10, 16, 8, CPPECC_LAYOUT_CODEWORDS, 4, 256);
+
+    context_check(223, 32, Count);
+    context_check(191, 64, Count/4);
+    context_check(127, 128, Count/16);
+    context_check(55, 200, Count/16);
+    context_check(1, 254, Count/16);
+    for(cppecc_s32 i = 1; i < CPPECC_MAX_BODY_SIZE; i += 7) {
+        context_check(CPPECC_MAX_BODY_SIZE-i, i, Count/64);
+    }
+
+    code_check(223, 32, 8, Count);
+    code_check(188, 16, 64, Count/16);
+    code_check(127, 128, 4, Count/16);
+    code_check(1, 254, 2, Count/16);
+
+    codec_check<255, 223, RSFieldParams<> >(Count);
+    codec_check<204, 188, RSFieldParams<> >(Count);
+    codec_check<255, 239, RSFieldParams<> >(Count);
+    codec_check<255, 223, RSFieldParams<0x187U, 112, 11> >(Count);
+    codec_check<64, 63, RSFieldParams<> >(Count);
+    codec_check<255, 127, RSFieldParams<> >(Count/16);
+    codec_check<255, 55, RSFieldParams<0x12BU, 120, 7> >(Count/16);
+
+    profile_check(Count);
+
     Result result;
     for(cppecc_s32 i = 0; i < Patterns; ++i) {
         cppecc_s32 messageSize = messageSizeRange(engine);
@@ -155,7 +1872,7 @@ int main(void)
         std::uniform_int_distribution<> eccSizeRange(1, eccMaxSize);
         cppecc_s32 eccSize = eccSizeRange(engine);
         result = reed_solomon(messageSize, eccSize, eccSize, Count);
-        std::cout << "result: " << "message size: " << messageSize << " ecc size: " << eccSize << " encode time (micro): " << result.encodeTime_ << " decode time (micro): " << result.decodeTime_ << " errors: " << result.numErrors_ << '/' << result.avgErrors_ << std::endl;
+        std::cout << "result: " << "message size: " << messageSize << " ecc size: " << eccSize << " errors: " << result.numErrors_ << '/' << result.avgErrors_ << std::endl;
     }
     return 0;
 }